@@ -54,7 +54,7 @@ namespace CloudAE.Core
 				using (var process = progressManager.StartProcess("ProcessSet"))
 				{
 					m_binarySource = m_inputHandler.GenerateBinarySource(progressManager);
-					m_tiledHandler = LASFile.Create(m_tiledHandler.FilePath, m_binarySource);
+					m_tiledHandler = LASFile.Create(m_tiledHandler.FilePath, m_binarySource, PointCloudTileSource.IsCompressedPath(m_tiledHandler.FilePath));
 
 					using (var segmentBuffer = BufferManager.AcquireBuffer(m_id, (int)PROPERTY_SEGMENT_SIZE.Value, true))
 					{
@@ -89,6 +89,9 @@ namespace CloudAE.Core
 			Context.WriteLine("IO Read Speed: {0}", averageReadSpeed);
 			Context.WriteLine("IO Write Speed: {0}", averageWriteSpeed);
 
+			foreach (string item in PerformanceManager.GetDecodeItems())
+				Context.WriteLine("Decode {0}: {1}", item, PerformanceManager.GetDecodeCost(item));
+
 			//{
 			//    // test
 			//    Stopwatch stopwatch = new Stopwatch();
@@ -15,6 +15,7 @@ namespace CloudAE.Core
 	public class PointCloudTileManager : IPropertyContainer
 	{
 		public static readonly IPropertyState<int> PROPERTY_DESIRED_TILE_COUNT;
+		public static readonly IPropertyState<bool> PROPERTY_COMPRESS_TILES;
 		private static readonly IPropertyState<int> PROPERTY_MAX_TILES_FOR_ESTIMATION;
 		private static readonly IPropertyState<int> PROPERTY_MAX_LOWRES_POINTS;
 
@@ -26,6 +27,7 @@ namespace CloudAE.Core
 			PROPERTY_DESIRED_TILE_COUNT = Context.RegisterOption(Context.OptionCategory.Tiling, "DesiredTilePoints", 40000);
 			PROPERTY_MAX_TILES_FOR_ESTIMATION = Context.RegisterOption(Context.OptionCategory.Tiling, "EstimationTilesMax", 10000000);
 			PROPERTY_MAX_LOWRES_POINTS = Context.RegisterOption(Context.OptionCategory.Tiling, "LowResPointsMax", 1000000);
+			PROPERTY_COMPRESS_TILES = Context.RegisterOption(Context.OptionCategory.Tiling, "CompressTiles", false);
 		}
 
 		public PointCloudTileManager(IPointCloudBinarySource source)
@@ -47,7 +49,12 @@ namespace CloudAE.Core
 
 			var fileSize = tiledFile.PointDataOffset + (m_source.PointSizeBytes * m_source.Count);
 
-			AttemptFastAllocate(tiledFile.FilePath, fileSize);
+			// compressed tiles are each a LASzip chunk, so a tile is a single chunk decode
+			var compressed = PointCloudTileSource.IsCompressedPath(tiledFile.FilePath);
+			LAZStreamWriter compressedStream = null;
+
+			if (!compressed)
+				AttemptFastAllocate(tiledFile.FilePath, fileSize);
 
 			var lowResPointCountMax = PROPERTY_MAX_LOWRES_POINTS.Value;
 			var lowResBuffer = BufferManager.AcquireBuffer(m_id, lowResPointCountMax * m_source.PointSizeBytes);
@@ -60,7 +67,10 @@ namespace CloudAE.Core
 			var lowResGrid = Grid<int>.Create(lowResTileSize, lowResTileSize, true, -1);
 			var lowResCounts = tileCounts.Copy<int>();
 
-			using (var outputStream = StreamManager.OpenWriteStream(tiledFile.FilePath, fileSize, tiledFile.PointDataOffset))
+			if (compressed)
+				compressedStream = new LAZStreamWriter(tiledFile.FilePath, tiledFile.Header, Environment.ProcessorCount);
+
+			using (var outputStream = compressed ? compressedStream : (IStreamWriter)StreamManager.OpenWriteStream(tiledFile.FilePath, fileSize, tiledFile.PointDataOffset))
 			{
 				var i = 0;
 				foreach (var segment in analysis.GridIndex)
@@ -90,6 +100,9 @@ namespace CloudAE.Core
 								outputStream.Write(sparseSegmentWrapper.Data, segmentBufferIndex, tileSize);
 								segmentBufferIndex += tileSize;
 
+								if (compressed && tileSize > 0)
+									compressedStream.Chunk();
+
 								if (!process.Update((float)segmentBufferIndex / segmentFilteredBytes))
 									break;
 							}
@@ -100,11 +113,14 @@ namespace CloudAE.Core
 						break;
 				}
 
-				// write low-res
+				// write low-res (as the final chunk)
 				var lowResActualPointCount = lowResCounts.Data.Cast<int>().Sum();
 				outputStream.Write(lowResWrapper.Data, 0, lowResActualPointCount * lowResWrapper.PointSizeBytes);
 			}
 
+			if (compressed)
+				tiledFile.Header.SetCompressedPointData((ulong)compressedStream.CompressedLength);
+
 			var actualDensity = new PointCloudTileDensity(tileCounts, m_source.Quantization);
 			var tileSet = new PointCloudTileSet(m_source, actualDensity, tileCounts, lowResCounts);
 			var tileSource = new PointCloudTileSource(tiledFile, tileSet, analysis.Statistics);
@@ -19,6 +19,9 @@ namespace CloudAE.Core
 	{
 		private const int MAX_PREVIEW_DIMENSION = 1000;
 
+		private const string UNCOMPRESSED_EXTENSION = "las";
+		private const string COMPRESSED_EXTENSION = "laz";
+
 		/*private const string FILE_IDENTIFIER = "TPBF";
 		private const string FILE_IDENTIFIER_DIRTY = "TPBD";
 		private const int FILE_VERSION_MAJOR = 1;
@@ -135,6 +138,11 @@ namespace CloudAE.Core
 			get { return TileSet.Density.MaxTileCount * PointSizeBytes; }
 		}
 
+		public bool IsCompressed
+		{
+			get { return IsCompressedPath(FilePath); }
+		}
+
 		#endregion
 
 		public PointCloudTileSource(LASFile file, PointCloudTileSet tileSet, Statistics zStats)
@@ -160,11 +168,20 @@ namespace CloudAE.Core
 		{
 			// mark with some low-order bytes of the file size
 			var fileInfo = new FileInfo(path);
-			string fileName = String.Format("{0}.{1}.las", fileInfo.Name, BitConverter.GetBytes(fileInfo.Length).ToBase64SafeString(0, 3));
+			var extension = PointCloudTileManager.PROPERTY_COMPRESS_TILES.Value ? COMPRESSED_EXTENSION : UNCOMPRESSED_EXTENSION;
+			string fileName = String.Format("{0}.{1}.{2}", fileInfo.Name, BitConverter.GetBytes(fileInfo.Length).ToBase64SafeString(0, 3), extension);
 			string tilePath = Path.Combine(Cache.APP_CACHE_DIR, fileName);
 			return tilePath;
 		}
 
+		/// <summary>
+		/// Determines whether the tiles at the path are compressed, with one LASzip chunk per tile.
+		/// </summary>
+		public static bool IsCompressedPath(string path)
+		{
+			return Path.GetExtension(path).Equals("." + COMPRESSED_EXTENSION, StringComparison.OrdinalIgnoreCase);
+		}
+
 		public static PointCloudTileSource Open(LASFile file)
 		{
 			var tileSet = file.EVLRs.First(r => r.RecordIdentifier.Equals(new LASRecordIdentifier("Jacere", 0))).Deserialize<PointCloudTileSet>();
@@ -195,10 +212,19 @@ namespace CloudAE.Core
 		{
 			if (m_inputStream == null)
 			{
-				m_inputStream = StreamManager.OpenReadStream(FilePath, PointDataOffset);
+				m_inputStream = GetStreamReader();
 			}
 		}
 
+		public override IStreamReader GetStreamReader()
+		{
+			// tiles are read one chunk at a time
+			if (IsCompressed)
+				return new LAZStreamReader(FilePath, m_file.Header, m_file.EncodedVLR, 1);
+
+			return StreamManager.OpenReadStream(FilePath, PointDataOffset);
+		}
+
 		public void Close()
 		{
 			if (m_inputStream != null)
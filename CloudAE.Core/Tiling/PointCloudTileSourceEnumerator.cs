@@ -24,7 +24,7 @@ namespace CloudAE.Core
 			m_buffer = process.AcquireBuffer(source.MaxTileBufferSize, true);
 			m_process = process;
 
-			m_stream = StreamManager.OpenReadStream(source.FilePath, source.PointDataOffset);
+			m_stream = source.GetStreamReader();
 			
 			Reset();
 		}
@@ -15,6 +15,10 @@ namespace Jacere.Core
 		public const string COUNTER_WRITE_TIME = "WriteTime";
 		public const string COUNTER_WRITE_BYTES = "WriteBytes";
 
+		public const string COUNTER_DECODE_CYCLES = "DecodeCycles";
+		public const string COUNTER_DECODE_POINTS = "DecodePoints";
+		public const string COUNTER_DECODE_BYTES = "DecodeBytes";
+
 		private static List<PerformanceManagementInstance> c_instances;
 		private static PerformanceManagementInstance c_current;
 
@@ -67,6 +71,21 @@ namespace Jacere.Core
 			}
 		}
 
+		/// <summary>
+		/// Adds what decoding one item of compressed points has cost.  The
+		/// counters come from a LASzip built with LASZIP_INSTRUMENT and are
+		/// kept for each item under the decode counter names.
+		/// </summary>
+		public static void UpdateDecodeItem(string item, long cycles, long points, long bytes)
+		{
+			if (c_current != null)
+			{
+				c_current.AppendValue(GetDecodeCounter(COUNTER_DECODE_CYCLES, item), cycles);
+				c_current.AppendValue(GetDecodeCounter(COUNTER_DECODE_POINTS, item), points);
+				c_current.AppendValue(GetDecodeCounter(COUNTER_DECODE_BYTES, item), bytes);
+			}
+		}
+
 		public static TimeSpan GetTimeSpan(string name)
 		{
 			if (c_current != null)
@@ -100,6 +119,36 @@ namespace Jacere.Core
 			return TransferRate.Zero;
 		}
 
+		/// <summary>
+		/// Gets the items that decoding costs were counted for.
+		/// </summary>
+		public static string[] GetDecodeItems()
+		{
+			if (c_current != null)
+			{
+				string prefix = GetDecodeCounter(COUNTER_DECODE_CYCLES, string.Empty);
+				return c_current.GetNames(prefix).Select(n => n.Substring(prefix.Length)).ToArray();
+			}
+			return new string[0];
+		}
+
+		public static DecodeCost GetDecodeCost(string item)
+		{
+			if (c_current != null)
+			{
+				long cycles = c_current.GetValue(GetDecodeCounter(COUNTER_DECODE_CYCLES, item));
+				long points = c_current.GetValue(GetDecodeCounter(COUNTER_DECODE_POINTS, item));
+				long bytes = c_current.GetValue(GetDecodeCounter(COUNTER_DECODE_BYTES, item));
+				return new DecodeCost(cycles, points, bytes);
+			}
+			return DecodeCost.Zero;
+		}
+
+		private static string GetDecodeCounter(string counter, string item)
+		{
+			return string.Format("{0}:{1}", counter, item);
+		}
+
 		//public static string GetString()
 		//{
 		//    return string.Join<string>(", ", c_counters.Select(kvp => String.Format("{0} = {1}", kvp.Key, kvp.Value)));
@@ -131,6 +180,11 @@ namespace Jacere.Core
 			m_counters.TryGetValue(name, out value);
 			return value;
 		}
+
+		public IEnumerable<string> GetNames(string prefix)
+		{
+			return m_counters.Keys.Where(k => k.StartsWith(prefix, StringComparison.Ordinal));
+		}
 	}
 
 	public struct TransferRate
@@ -158,4 +212,51 @@ namespace Jacere.Core
 			return string.Format("{0} in {1:f}s @ {2}ps", m_bytes.ToSize(), seconds, bytesPerSecond.ToSize());
 		}
 	}
+
+	/// <summary>
+	/// What decoding one item of compressed points has cost.  The cycles are
+	/// processor cycles (or nanoseconds where there is no time stamp counter).
+	/// </summary>
+	public struct DecodeCost
+	{
+		public static readonly DecodeCost Zero;
+
+		private readonly long m_cycles;
+		private readonly long m_points;
+		private readonly long m_bytes;
+
+		static DecodeCost()
+		{
+			Zero = new DecodeCost(0, 0, 0);
+		}
+
+		public DecodeCost(long cycles, long points, long bytes)
+		{
+			m_cycles = cycles;
+			m_points = points;
+			m_bytes = bytes;
+		}
+
+		public long Cycles
+		{
+			get { return m_cycles; }
+		}
+
+		public long Points
+		{
+			get { return m_points; }
+		}
+
+		public long Bytes
+		{
+			get { return m_bytes; }
+		}
+
+		public override string ToString()
+		{
+			double cyclesPerPoint = m_points > 0 ? (double)m_cycles / m_points : 0;
+			double bitsPerPoint = m_points > 0 ? 8.0 * m_bytes / m_points : 0;
+			return string.Format("{0} points, {1} in {2:f1} cycles/pt @ {3:f2} bits/pt", m_points, m_bytes.ToSize(), cyclesPerPoint, bitsPerPoint);
+		}
+	}
 }
@@ -33,6 +33,14 @@ namespace Jacere.Data.PointCloud
 			get { return m_header; }
 		}
 
+		/// <summary>
+		/// Gets the LASzip record, if the points are compressed.
+		/// </summary>
+		public LASVLR EncodedVLR
+		{
+			get { return m_vlrs.FirstOrDefault(vlr => vlr.RecordIdentifier.Equals(LAZFile.EncodedRecord)); }
+		}
+
 		public Extent3D Extent
 		{
 			get { return m_extent; }
@@ -59,6 +67,15 @@ namespace Jacere.Data.PointCloud
 		}
 
 		public static LASFile Create(string path, IPointCloudBinarySource source)
+		{
+			return Create(path, source, false);
+		}
+
+		/// <summary>
+		/// Creates a file for the points of the source, which will be written
+		/// with a <see cref="LAZStreamWriter"/> if they are to be compressed.
+		/// </summary>
+		public static LASFile Create(string path, IPointCloudBinarySource source, bool compressed)
 		{
 			var pcbs = source as PointCloudSource;
 			if (pcbs != null)
@@ -72,8 +89,13 @@ namespace Jacere.Data.PointCloud
 						new LASEVLR(new LASRecordIdentifier("Jacere", 1), null)
 					}).ToArray();
 
-					var header = new LASHeader(new [] {lasFile.Header}, lasFile.m_vlrs, evlrs);
-					return new LASFile(path, header, lasFile.m_vlrs, evlrs);
+					// the LASzip record of a compressed source does not describe the new points
+					var vlrs = lasFile.m_vlrs.Where(vlr => !vlr.RecordIdentifier.Equals(LAZFile.EncodedRecord)).ToList();
+					if (compressed)
+						vlrs.Add(LAZStreamWriter.CreateEncodedVLR(lasFile.Header));
+
+					var header = new LASHeader(new [] {lasFile.Header}, vlrs.ToArray(), evlrs);
+					return new LASFile(path, header, vlrs.ToArray(), evlrs);
 				}
 			}
 
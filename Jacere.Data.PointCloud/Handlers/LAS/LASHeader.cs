@@ -150,7 +150,7 @@ namespace Jacere.Data.PointCloud
 		private readonly uint m_offsetToPointData;
 
 		private readonly uint m_numberOfVariableLengthRecords;
-		private readonly byte m_pointDataRecordFormat;
+		private byte m_pointDataRecordFormat;
 		private readonly ushort m_pointDataRecordLength;
 		private readonly uint m_legacyNumberOfPointRecords;
 		private readonly uint[] m_legacyNumberOfPointsByReturn;
@@ -162,7 +162,7 @@ namespace Jacere.Data.PointCloud
 		private readonly ulong m_startOfWaveformDataPacketRecord;
 
 		// LAS 1.4
-		private readonly ulong m_startOfFirstExtendedVariableLengthRecord;
+		private ulong m_startOfFirstExtendedVariableLengthRecord;
 		private readonly uint m_numberOfExtendedVariableLengthRecords;
 		private readonly ulong m_numberOfPointRecords;
 		private readonly ulong[] m_numberOfPointsByReturn;
@@ -432,6 +432,17 @@ namespace Jacere.Data.PointCloud
 			}
 		}
 
+		/// <summary>
+		/// Marks the points as compressed (as LASzip does) and moves the EVLRs
+		/// to follow the compressed point data.
+		/// </summary>
+		/// <param name="pointDataLength">The length of the compressed point data.</param>
+		public void SetCompressedPointData(ulong pointDataLength)
+		{
+			m_pointDataRecordFormat |= 0x80;
+			m_startOfFirstExtendedVariableLengthRecord = m_offsetToPointData + pointDataLength;
+		}
+
 		public bool IsCompatible(LASHeader other)
 		{
 			return (
@@ -105,6 +105,16 @@ namespace Jacere.Data.PointCloud
 			m_data = reader.ReadBytes(m_recordLengthAfterHeader);
 		}
 
+		public LASVLR(LASRecordIdentifier recordIdentifier, string description, byte[] data)
+		{
+			m_reserved = 0;
+			m_userID = recordIdentifier.UserID;
+			m_recordID = recordIdentifier.RecordID;
+			m_recordLengthAfterHeader = (ushort)data.Length;
+			m_description = description;
+			m_data = data;
+		}
+
 		public void Serialize(BinaryWriter writer)
 		{
 			writer.Write(m_reserved);
@@ -4,6 +4,7 @@ using System.Linq;
 
 using Jacere.Core;
 using Jacere.Core.Geometry;
+using Jacere.Interop.LASzip;
 
 namespace Jacere.Data.PointCloud
 {
@@ -28,5 +29,87 @@ namespace Jacere.Data.PointCloud
 			var segment = new LAZBinarySource(m_handler, pointCount, Extent, Quantization, offset, PointSizeBytes);
 			return segment;
 		}
+
+		/// <summary>
+		/// Creates a segment of only the chunks whose bounds may intersect the region,
+		/// or returns this source if the file does not summarize its chunks.
+		/// </summary>
+		/// <param name="region">The region.</param>
+		/// <param name="useZ">Whether to compare the z range as well.</param>
+		public IPointCloudBinarySource CreateRegionSegment(Extent3D region, bool useZ)
+		{
+			// grow by one so that rounding cannot drop a chunk
+			var q = Quantization.Convert(region);
+
+			long[] ranges;
+			using (var laz = CreateInterop())
+			{
+				ranges = laz.GetPointRangesInBox(q.MinX - 1, q.MinY - 1, q.MinZ - 1, q.MaxX + 1, q.MaxY + 1, q.MaxZ + 1, useZ);
+			}
+
+			return CreateRangeSegment(ranges);
+		}
+
+		/// <summary>
+		/// Creates a segment of only the chunks that have points of the classification,
+		/// or returns this source if the file does not summarize its chunks.
+		/// </summary>
+		/// <param name="classification">The classification.</param>
+		public IPointCloudBinarySource CreateClassificationSegment(byte classification)
+		{
+			long[] ranges;
+			using (var laz = CreateInterop())
+			{
+				ranges = laz.GetPointRangesWithClassification(classification);
+			}
+
+			return CreateRangeSegment(ranges);
+		}
+
+		/// <summary>
+		/// Creates a segment of only the chunks whose GPS times overlap the window,
+		/// or returns this source if the file does not summarize its chunks.
+		/// </summary>
+		/// <param name="minGpsTime">The start of the window.</param>
+		/// <param name="maxGpsTime">The end of the window.</param>
+		public IPointCloudBinarySource CreateGpsTimeSegment(double minGpsTime, double maxGpsTime)
+		{
+			long[] ranges;
+			using (var laz = CreateInterop())
+			{
+				ranges = laz.GetPointRangesInGpsTime(minGpsTime, maxGpsTime);
+			}
+
+			return CreateRangeSegment(ranges);
+		}
+
+		private LAZInterop CreateInterop()
+		{
+			return new LAZInterop(FilePath, m_handler.Header.OffsetToPointData, m_handler.EncodedVLR.Data);
+		}
+
+		private IPointCloudBinarySource CreateRangeSegment(long[] ranges)
+		{
+			if (ranges == null)
+				return this;
+
+			// chunks are numbered from the start of the file, not of this segment
+			long firstIndex = (PointDataOffset - m_handler.Header.OffsetToPointData) / PointSizeBytes;
+			long lastIndex = firstIndex + Count;
+
+			var rangeSegments = new List<IPointCloudBinarySource>();
+			for (int i = 0; i < ranges.Length; i += 2)
+			{
+				long start = Math.Max(ranges[i], firstIndex);
+				long end = Math.Min(ranges[i] + ranges[i + 1], lastIndex);
+				if (start < end)
+					rangeSegments.Add(CreateSegment(start - firstIndex, end - start));
+			}
+
+			if (rangeSegments.Count == 0)
+				return CreateSegment(0, 0);
+
+			return new PointCloudBinarySourceComposite(m_handler, Extent, rangeSegments.ToArray());
+		}
 	}
 }
@@ -17,9 +17,9 @@ namespace Jacere.Data.PointCloud
 			LASVLR.AddInterestingRecord(c_record);
 		}
 
-		public LASVLR EncodedVLR
+		internal static LASRecordIdentifier EncodedRecord
 		{
-			get { return m_lazEncodedVLR; }
+			get { return c_record; }
 		}
 
 		public LAZFile(string path)
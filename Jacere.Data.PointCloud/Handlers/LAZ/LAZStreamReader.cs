@@ -34,11 +34,21 @@ namespace Jacere.Data.PointCloud
 		}
 
 		public LAZStreamReader(string path, LASHeader header, LASVLR lazEncodedVLR)
+			: this(path, header, lazEncodedVLR, 1)
+		{
+		}
+
+		/// <summary>
+		/// Initializes a new instance of the <see cref="LAZStreamReader"/> class.
+		/// More than one thread decodes the chunks ahead of a sequential read,
+		/// which only pays off when most of the file is read after each seek.
+		/// </summary>
+		public LAZStreamReader(string path, LASHeader header, LASVLR lazEncodedVLR, int threadCount)
 		{
 			m_path = path;
 			m_header = header;
 			m_lazEncodedVLR = lazEncodedVLR;
-			m_laz = new LAZInterop(m_path, m_header.OffsetToPointData, m_lazEncodedVLR.Data);
+			m_laz = new LAZInterop(m_path, m_header.OffsetToPointData, m_lazEncodedVLR.Data, (long)m_header.PointCount, threadCount);
 		}
 
 		public int Read(byte[] array, int offset, int count)
@@ -61,6 +71,15 @@ namespace Jacere.Data.PointCloud
 
 		public void Dispose()
 		{
+			// what decoding each item has cost (only with an instrumented LASzip)
+			long[] counters = m_laz.GetItemCounters();
+			if (counters != null)
+			{
+				string[] items = m_laz.GetItemNames();
+				for (int i = 0; i < items.Length; i++)
+					PerformanceManager.UpdateDecodeItem(items[i], counters[3 * i], counters[3 * i + 1], counters[3 * i + 2]);
+			}
+
 			m_laz.Dispose();
 		}
 	}
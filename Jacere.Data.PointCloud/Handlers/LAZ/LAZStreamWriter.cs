@@ -0,0 +1,74 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+
+using Jacere.Core;
+using Jacere.Interop.LASzip;
+
+namespace Jacere.Data.PointCloud
+{
+	/// <summary>
+	/// Compresses the points of a file whose header was created with a
+	/// LASzip record (see <see cref="LASFile.Create(string, IPointCloudBinarySource, bool)"/>).
+	/// Every call to Chunk() ends a chunk that can be decoded on its own.
+	/// </summary>
+	public class LAZStreamWriter : IStreamWriter
+	{
+		private readonly LASHeader m_header;
+		private LAZWriterInterop m_laz;
+
+		private long m_position;
+		private long m_compressedLength;
+
+		public long Position
+		{
+			get { return m_position; }
+		}
+
+		/// <summary>
+		/// Gets the length of the compressed point data (once the writer is disposed).
+		/// </summary>
+		public long CompressedLength
+		{
+			get { return m_compressedLength; }
+		}
+
+		public LAZStreamWriter(string path, LASHeader header, int threadCount)
+		{
+			m_header = header;
+			m_position = m_header.OffsetToPointData;
+			m_compressedLength = 0;
+			m_laz = new LAZWriterInterop(path, m_header.OffsetToPointData, m_header.PointDataRecordFormat, m_header.PointDataRecordLength, threadCount);
+		}
+
+		public static LASVLR CreateEncodedVLR(LASHeader header)
+		{
+			var data = LAZWriterInterop.CreateVLR(header.PointDataRecordFormat, header.PointDataRecordLength);
+			if (data == null)
+				throw new Exception("Unsupported point format for compression");
+
+			return new LASVLR(LAZFile.EncodedRecord, "laszip", data);
+		}
+
+		public void Write(byte[] array, int offset, int count)
+		{
+			m_laz.Write(array, offset, count);
+			m_position += count;
+		}
+
+		public void Chunk()
+		{
+			m_laz.Chunk();
+		}
+
+		public void Dispose()
+		{
+			if (m_laz != null)
+			{
+				m_compressedLength = m_laz.Close();
+				m_laz.Dispose();
+				m_laz = null;
+			}
+		}
+	}
+}
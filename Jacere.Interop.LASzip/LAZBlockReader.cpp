@@ -1,55 +1,75 @@
 #include "LAZBlockReader.h"
+#include "LAZChunkPool.h"
+#include "LAZMappedFile.h"
 
 #include <errno.h>
 
-LAZBlockReader::LAZBlockReader(const char* path, unsigned long dataOffset, unsigned char* vlr, unsigned int vlrLength) {
+// random reads seek within a chunk from the nearest of these (a tenth of the default chunk)
+#define LAZ_CHECKPOINT_INTERVAL 5000
+
+// files that cannot be mapped are read ahead on an I/O thread into these buffers
+#define LAZ_READ_AHEAD_BUFFERS 4
+#define LAZ_READ_AHEAD_BUFFER_SIZE (4 * 1024 * 1024)
+
+LAZBlockReader::LAZBlockReader(const char* path, unsigned long dataOffset, unsigned char* vlr, unsigned int vlrLength, long long pointCount, int threadCount, unsigned int decompressSelective) {
 	
-	m_streamBuffer = NULL;
 	m_file = NULL;
+	m_mappedFile = NULL;
 	m_zip = NULL;
 	m_unzipper = NULL;
-	m_lz_point = NULL;
-	m_lz_point_data = NULL;
+	m_chunkPool = NULL;
 	m_lz_point_size = NULL;
 
 	m_pointDataOffset = dataOffset;
 
-	int bufferSize = 1024 * 1024;
-	
-	m_file = fopen(path, "rb");
-	if (!m_file) {
-		printf ("Error opening file: %s\n", strerror(errno));
-		return;
-	}
-
-	m_streamBuffer = new char[bufferSize];
-	setvbuf(m_file, m_streamBuffer, _IOFBF, bufferSize);
-
-	if (fseek(m_file, dataOffset, SEEK_SET))
-		return;
-
 	m_zip = new LASzip();
 	if (!m_zip->unpack(vlr, vlrLength))
 		return;
-	
-	m_unzipper = new LASunzipper();
-	if (!m_unzipper->open(m_file, m_zip))
-		return;
+
+	// decode in place from a mapping of the file, if it can be mapped
+	m_mappedFile = new LAZMappedFile(path);
+	if (m_mappedFile->IsValid()) {
+		m_unzipper = new LASunzipper();
+		m_unzipper->set_decompress_selective(decompressSelective);
+		m_unzipper->set_checkpoint_interval(LAZ_CHECKPOINT_INTERVAL);
+		m_unzipper->set_chunk_index(path);
+		if (!m_unzipper->open(m_mappedFile->GetData(), m_mappedFile->GetSize(), dataOffset, m_zip))
+			return;
+	}
+	else {
+		delete m_mappedFile;
+		m_mappedFile = NULL;
+
+		m_file = fopen(path, "rb");
+		if (!m_file) {
+			printf ("Error opening file: %s\n", strerror(errno));
+			return;
+		}
+
+		if (fseek(m_file, dataOffset, SEEK_SET))
+			return;
+
+		// the unzipper reads the file itself, so it needs no stream buffer
+		m_unzipper = new LASunzipper();
+		m_unzipper->set_decompress_selective(decompressSelective);
+		m_unzipper->set_checkpoint_interval(LAZ_CHECKPOINT_INTERVAL);
+		m_unzipper->set_chunk_index(path);
+		m_unzipper->set_read_ahead(LAZ_READ_AHEAD_BUFFERS, LAZ_READ_AHEAD_BUFFER_SIZE);
+		if (!m_unzipper->open(m_file, m_zip))
+			return;
+	}
 
 	// compute the point size
 	m_lz_point_size = 0;
 	for (unsigned int i = 0; i < m_zip->num_items; i++)
 		m_lz_point_size += m_zip->items[i].size;
 
-	// create the point data
-	unsigned int point_offset = 0;
-	m_lz_point = new unsigned char*[m_zip->num_items];
-    
-	m_lz_point_data = new unsigned char[m_lz_point_size];
-	for (unsigned i = 0; i < m_zip->num_items; i++)
-	{
-		m_lz_point[i] = &(m_lz_point_data[point_offset]);
-		point_offset += m_zip->items[i].size;
+	if (threadCount > 1 && pointCount > 0) {
+		m_chunkPool = new LAZChunkPool(path, dataOffset, m_mappedFile, m_zip, m_unzipper, pointCount, m_lz_point_size, threadCount, decompressSelective);
+		if (!m_chunkPool->IsValid()) {
+			delete m_chunkPool;
+			m_chunkPool = NULL;
+		}
 	}
 
 	m_pointIndex = 0;
@@ -61,7 +81,10 @@ void LAZBlockReader::Seek(long long byteOffset) {
 	long long pointOffset = (byteOffsetIntoPointData / m_lz_point_size);
 
 	if (pointOffset != m_pointIndex) {
-		m_unzipper->seek(pointOffset);
+		if (m_chunkPool)
+			m_chunkPool->Seek(pointOffset);
+		else
+			m_unzipper->seek(pointOffset);
 		m_pointIndex = pointOffset;
 	}
 }
@@ -72,15 +95,16 @@ int LAZBlockReader::Read(unsigned char* buffer, int byteOffset, int byteCount) {
 	unsigned char* bufferEnd = bufferStart + byteCount;
 	unsigned char* bufferCurrent = bufferStart;
 
-	while (bufferCurrent < bufferEnd)
-	{
-		if (!m_unzipper->read(m_lz_point))
-			break;
-
-		memcpy(bufferCurrent, m_lz_point_data, m_lz_point_size);
-		bufferCurrent += m_lz_point_size;
+	if (m_chunkPool) {
+		int bytesRead = m_chunkPool->Read(bufferStart, byteCount);
+		m_pointIndex += (bytesRead / m_lz_point_size);
+		return bytesRead;
 	}
 
+	// decode straight into the caller's buffer
+	unsigned int pointCount = (unsigned int)((bufferEnd - bufferCurrent) / m_lz_point_size);
+	bufferCurrent += (size_t)m_unzipper->read_batch(bufferCurrent, pointCount, m_lz_point_size) * m_lz_point_size;
+
 	int bytesRead = (int)(bufferCurrent - bufferStart);
 	m_pointIndex += (bytesRead / m_lz_point_size);
 
@@ -92,8 +116,108 @@ long long LAZBlockReader::GetPosition() {
 	return (m_pointIndex * m_lz_point_size + m_pointDataOffset);
 }
 
+unsigned int LAZBlockReader::GetChunkCount() {
+	
+	return (m_unzipper ? m_unzipper->get_number_chunks() : 0);
+}
+
+int LAZBlockReader::GetPointRangesInBox(const int* minXYZ, const int* maxXYZ, bool useZ, long long* ranges) {
+	
+	unsigned int chunkCount = GetChunkCount();
+	if (chunkCount == 0)
+		return 0;
+
+	unsigned int* chunks = new unsigned int[chunkCount];
+	unsigned int count = m_unzipper->get_chunks_in_box(minXYZ, maxXYZ, useZ, chunks);
+	int rangeCount = GetPointRanges(chunks, count, ranges);
+
+	delete[] chunks;
+	return rangeCount;
+}
+
+int LAZBlockReader::GetPointRangesWithClassification(unsigned char classification, long long* ranges) {
+	
+	unsigned int chunkCount = GetChunkCount();
+	if (chunkCount == 0)
+		return 0;
+
+	unsigned int* chunks = new unsigned int[chunkCount];
+	unsigned int count = m_unzipper->get_chunks_with_classification(classification, chunks);
+	int rangeCount = GetPointRanges(chunks, count, ranges);
+
+	delete[] chunks;
+	return rangeCount;
+}
+
+int LAZBlockReader::GetPointRangesInGpsTime(double minGpsTime, double maxGpsTime, long long* ranges) {
+	
+	unsigned int chunkCount = GetChunkCount();
+	if (chunkCount == 0)
+		return 0;
+
+	unsigned int* chunks = new unsigned int[chunkCount];
+	unsigned int count = m_unzipper->get_chunks_in_gps_time(minGpsTime, maxGpsTime, chunks);
+	int rangeCount = GetPointRanges(chunks, count, ranges);
+
+	delete[] chunks;
+	return rangeCount;
+}
+
+unsigned int LAZBlockReader::GetItemCount() {
+	
+	return (m_unzipper ? m_zip->num_items : 0);
+}
+
+const char* LAZBlockReader::GetItemName(unsigned int item) {
+	
+	if (item >= GetItemCount())
+		return NULL;
+
+	const char* name = m_zip->items[item].get_name();
+	return (name ? name : "UNKNOWN");
+}
+
+bool LAZBlockReader::GetItemCounters(unsigned int item, long long* cycles, long long* points, long long* bytes) {
+	
+	if (!m_unzipper || !m_unzipper->get_item_counters(item, cycles, points, bytes))
+		return false;
+
+	// the chunks that the pool decodes are counted by its workers
+	if (m_chunkPool)
+		m_chunkPool->AddItemCounters(item, cycles, points, bytes);
+
+	return true;
+}
+
+int LAZBlockReader::GetPointRanges(const unsigned int* chunks, unsigned int count, long long* ranges) {
+	
+	// merge neighbouring chunks into one run
+	int rangeCount = 0;
+	for (unsigned int i = 0; i < count; i++) {
+		unsigned int firstPoint;
+		unsigned int numPoints;
+		if (!m_unzipper->get_chunk(chunks[i], &firstPoint, &numPoints))
+			continue;
+		if (rangeCount && (ranges[2 * rangeCount - 2] + ranges[2 * rangeCount - 1] == firstPoint)) {
+			ranges[2 * rangeCount - 1] += numPoints;
+		}
+		else {
+			ranges[2 * rangeCount] = firstPoint;
+			ranges[2 * rangeCount + 1] = numPoints;
+			rangeCount++;
+		}
+	}
+
+	return rangeCount;
+}
+
 LAZBlockReader::~LAZBlockReader() {
 	
+	if (m_chunkPool) {
+		delete m_chunkPool;
+		m_chunkPool = NULL;
+	}
+
 	if (m_unzipper) {
 		m_unzipper->close();
 		delete m_unzipper;
@@ -104,19 +228,9 @@ LAZBlockReader::~LAZBlockReader() {
 		fclose(m_file);
 		m_file = NULL;
 	}
-	
-	if (m_streamBuffer) {
-		delete m_streamBuffer;
-		m_streamBuffer = NULL;
-	}
-
-	if (m_lz_point) {
-		delete[] m_lz_point;
-		m_lz_point = NULL;
-	}
 
-	if (m_lz_point_data) {
-		delete[] m_lz_point_data;
-		m_lz_point_data = NULL;
+	if (m_mappedFile) {
+		delete m_mappedFile;
+		m_mappedFile = NULL;
 	}
 }
@@ -2,32 +2,53 @@
 
 #include "lasunzipper.hpp"
 
+class LAZChunkPool;
+class LAZMappedFile;
+
 class LAZBlockReader
 {
 public:
 
-	LAZBlockReader(const char* path, unsigned long dataOffset, unsigned char* vlr, unsigned int vlrLength);
+	// a threadCount above one decodes chunks in parallel (requires the point count)
+	// and layered files decode only the LASZIP_DECOMPRESS_SELECTIVE_* layers asked for
+	LAZBlockReader(const char* path, unsigned long dataOffset, unsigned char* vlr, unsigned int vlrLength, long long pointCount = 0, int threadCount = 1, unsigned int decompressSelective = LASZIP_DECOMPRESS_SELECTIVE_ALL);
     ~LAZBlockReader();
 
 	int Read(unsigned char* buffer, int byteOffset, int byteCount);
 	void Seek(long long byteOffset);
 	long long GetPosition();
 
+	// stores (first point, point count) pairs of the runs of chunks that may have
+	// points inside the quantized box into ranges (room for two per chunk) and
+	// returns how many runs there are (zero without a chunk table)
+	int GetPointRangesInBox(const int* minXYZ, const int* maxXYZ, bool useZ, long long* ranges);
+	// the same for the chunks with points of a classification or in a gps time window
+	int GetPointRangesWithClassification(unsigned char classification, long long* ranges);
+	int GetPointRangesInGpsTime(double minGpsTime, double maxGpsTime, long long* ranges);
+	unsigned int GetChunkCount();
+
+	// the items of the point and the processor cycles, points and compressed bytes that
+	// decoding them has cost so far (false unless LASzip was built with LASZIP_INSTRUMENT)
+	unsigned int GetItemCount();
+	const char* GetItemName(unsigned int item);
+	bool GetItemCounters(unsigned int item, long long* cycles, long long* points, long long* bytes);
+
 private:
 
 	unsigned long m_pointDataOffset;
 	long long m_pointIndex;
 
-	char* m_streamBuffer;
 	FILE* m_file;
+	LAZMappedFile* m_mappedFile;
 
 	LASzip* m_zip;
 	LASunzipper* m_unzipper;
+	LAZChunkPool* m_chunkPool;
 
-	unsigned char** m_lz_point;
-	unsigned char* m_lz_point_data;
 	unsigned int m_lz_point_size;
 
+	int GetPointRanges(const unsigned int* chunks, unsigned int count, long long* ranges);
+
 };
 
 
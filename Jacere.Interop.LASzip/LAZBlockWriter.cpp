@@ -0,0 +1,151 @@
+#include "LAZBlockWriter.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <string.h>
+
+LAZBlockWriter::LAZBlockWriter(const char* path, unsigned long dataOffset, unsigned char pointFormat, unsigned short pointSize, int threadCount) {
+	
+	m_streamBuffer = NULL;
+	m_file = NULL;
+	m_zip = NULL;
+	m_zipper = NULL;
+	m_items = NULL;
+	m_itemOffsets = NULL;
+	m_lz_point_size = 0;
+
+	m_pointDataOffset = dataOffset;
+
+	m_zip = new LASzip();
+	if (!Setup(m_zip, pointFormat, pointSize))
+		return;
+
+	int bufferSize = 1024 * 1024;
+
+	// the header has already been written
+	m_file = fopen(path, "r+b");
+	if (!m_file) {
+		printf ("Error opening file: %s\n", strerror(errno));
+		return;
+	}
+
+	m_streamBuffer = new char[bufferSize];
+	setvbuf(m_file, m_streamBuffer, _IOFBF, bufferSize);
+
+	if (fseek(m_file, dataOffset, SEEK_SET))
+		return;
+
+	LASzipper* zipper = new LASzipper();
+	if (threadCount > 1)
+		zipper->set_threads(threadCount);
+	if (!zipper->open(m_file, m_zip)) {
+		delete zipper;
+		return;
+	}
+	m_zipper = zipper;
+
+	// the points arrive packed, so the items follow each other
+	m_items = new unsigned char*[m_zip->num_items];
+	m_itemOffsets = new unsigned int[m_zip->num_items];
+	for (unsigned int i = 0; i < m_zip->num_items; i++) {
+		m_itemOffsets[i] = m_lz_point_size;
+		m_lz_point_size += m_zip->items[i].size;
+	}
+}
+
+bool LAZBlockWriter::Setup(LASzip* zip, unsigned char pointFormat, unsigned short pointSize) {
+	
+	// the upper bits of the format only mark the file as compressed
+	if (!zip->setup(pointFormat & 0x3F, pointSize, LASZIP_COMPRESSOR_CHUNKED))
+		return false;
+
+	// the largest chunk size marks variable chunks that end at every Chunk()
+	return zip->set_chunk_size(UINT_MAX);
+}
+
+int LAZBlockWriter::CreateVLR(unsigned char pointFormat, unsigned short pointSize, unsigned char** vlr) {
+	
+	LASzip zip;
+	if (!Setup(&zip, pointFormat, pointSize))
+		return 0;
+
+	unsigned char* bytes;
+	int num;
+	if (!zip.pack(bytes, num))
+		return 0;
+
+	*vlr = new unsigned char[num];
+	memcpy(*vlr, bytes, num);
+	return num;
+}
+
+bool LAZBlockWriter::IsValid() {
+	
+	return (m_zipper != NULL);
+}
+
+void LAZBlockWriter::Write(const unsigned char* buffer, int byteOffset, int byteCount) {
+	
+	const unsigned char* point = buffer + byteOffset;
+	const unsigned char* pointEnd = point + byteCount;
+
+	while (point < pointEnd) {
+		for (unsigned int i = 0; i < m_zip->num_items; i++)
+			m_items[i] = (unsigned char*)point + m_itemOffsets[i];
+		m_zipper->write(m_items);
+		point += m_lz_point_size;
+	}
+}
+
+void LAZBlockWriter::Chunk() {
+	
+	m_zipper->chunk();
+}
+
+long long LAZBlockWriter::Close() {
+	
+	long long length = 0;
+
+	if (m_zipper) {
+		m_zipper->close();
+		delete m_zipper;
+		m_zipper = NULL;
+	}
+
+	if (m_file) {
+#ifdef _WIN32
+		length = _ftelli64(m_file) - m_pointDataOffset;
+#else
+		length = (long long)ftello(m_file) - m_pointDataOffset;
+#endif
+		fclose(m_file);
+		m_file = NULL;
+	}
+
+	return length;
+}
+
+LAZBlockWriter::~LAZBlockWriter() {
+	
+	Close();
+
+	if (m_streamBuffer) {
+		delete [] m_streamBuffer;
+		m_streamBuffer = NULL;
+	}
+
+	if (m_items) {
+		delete [] m_items;
+		m_items = NULL;
+	}
+
+	if (m_itemOffsets) {
+		delete [] m_itemOffsets;
+		m_itemOffsets = NULL;
+	}
+
+	if (m_zip) {
+		delete m_zip;
+		m_zip = NULL;
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "laszipper.hpp"
+
+class LAZBlockWriter
+{
+public:
+
+	// compresses points of the given LAS format into an existing file from
+	// dataOffset on, starting a new chunk whenever Chunk() is called
+	LAZBlockWriter(const char* path, unsigned long dataOffset, unsigned char pointFormat, unsigned short pointSize, int threadCount = 1);
+	~LAZBlockWriter();
+
+	bool IsValid();
+
+	// the LASzip record for the file (which is the same for every writer of a format)
+	static int CreateVLR(unsigned char pointFormat, unsigned short pointSize, unsigned char** vlr);
+
+	void Write(const unsigned char* buffer, int byteOffset, int byteCount);
+	void Chunk();
+	// writes the chunk table and returns the length of the compressed point data
+	long long Close();
+
+private:
+
+	unsigned long m_pointDataOffset;
+
+	char* m_streamBuffer;
+	FILE* m_file;
+
+	LASzip* m_zip;
+	LASzipper* m_zipper;
+
+	unsigned char** m_items;
+	unsigned int* m_itemOffsets;
+	unsigned int m_lz_point_size;
+
+	static bool Setup(LASzip* zip, unsigned char pointFormat, unsigned short pointSize);
+
+};
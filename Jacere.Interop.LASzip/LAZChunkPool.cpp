@@ -0,0 +1,261 @@
+#include "LAZChunkPool.h"
+#include "LAZMappedFile.h"
+
+#include <algorithm>
+#include <string.h>
+
+LAZChunkPool::LAZChunkPool(const char* path, unsigned long dataOffset, const LAZMappedFile* mappedFile, LASzip* zip, LASunzipper* unzipper, long long pointCount, unsigned int pointSize, int threadCount, unsigned int decompressSelective) {
+
+	m_path = path;
+	m_pointDataOffset = dataOffset;
+	m_mappedFile = mappedFile;
+	m_zip = zip;
+	m_pointSize = pointSize;
+	m_pointCount = pointCount;
+	m_decompressSelective = decompressSelective;
+	m_chunkTotal = 0;
+
+	m_nextDispatch = 0;
+	m_currentChunk = 0;
+	m_currentOffset = 0;
+	m_busy = 0;
+	m_stop = false;
+
+	m_itemCounters.resize(3 * (size_t)zip->num_items, 0);
+
+	// copy the chunk table, clamping the (fixed size) last chunk to the point count
+	unsigned int numberChunks = unzipper->get_number_chunks();
+	for (unsigned int i = 0; i < numberChunks; i++)
+	{
+		unsigned int firstPoint;
+		unsigned int chunkPoints;
+		if (!unzipper->get_chunk(i, &firstPoint, &chunkPoints) || firstPoint >= m_pointCount)
+			break;
+
+		if (firstPoint + (long long)chunkPoints > m_pointCount)
+			chunkPoints = (unsigned int)(m_pointCount - firstPoint);
+
+		m_chunkFirst.push_back(firstPoint);
+		m_chunkCount.push_back(chunkPoints);
+	}
+	m_chunkTotal = (long long)m_chunkFirst.size();
+
+	// a single chunk gains nothing from the workers
+	if (m_chunkTotal < 2 || threadCount < 2)
+		return;
+
+	// two slots per worker keeps them busy while the reader drains a chunk
+	ChunkSlot empty = { -1, 0, 0, NULL, false, false };
+	m_slots.resize(threadCount * 2, empty);
+
+	for (int i = 0; i < threadCount; i++)
+		m_threads.push_back(std::thread(&LAZChunkPool::Work, this));
+}
+
+bool LAZChunkPool::IsValid() const {
+
+	return !m_threads.empty();
+}
+
+long long LAZChunkPool::FindChunk(long long pointIndex) const {
+
+	if (pointIndex >= m_pointCount)
+		return m_chunkTotal;
+
+	std::vector<unsigned int>::const_iterator it = std::upper_bound(m_chunkFirst.begin(), m_chunkFirst.end(), (unsigned int)pointIndex);
+	return (long long)(it - m_chunkFirst.begin()) - 1;
+}
+
+void LAZChunkPool::Seek(long long pointIndex) {
+
+	long long chunk = FindChunk(pointIndex);
+	unsigned int offset = (chunk < m_chunkTotal) ? (unsigned int)(pointIndex - m_chunkFirst[(size_t)chunk]) : 0;
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	if (chunk == m_currentChunk) {
+		m_currentOffset = offset;
+		return;
+	}
+
+	// stop handing out work and let the in-flight chunks finish
+	m_nextDispatch = m_chunkTotal;
+	m_changed.wait(lock, [this] { return m_busy == 0; });
+
+	for (size_t i = 0; i < m_slots.size(); i++)
+		m_slots[i].ready = false;
+
+	m_currentChunk = chunk;
+	m_currentOffset = offset;
+	m_nextDispatch = chunk;
+	m_changed.notify_all();
+}
+
+int LAZChunkPool::Read(unsigned char* buffer, int byteCount) {
+
+	unsigned char* bufferCurrent = buffer;
+	unsigned int pointsRemaining = (unsigned int)(byteCount / m_pointSize);
+
+	while (pointsRemaining > 0)
+	{
+		ChunkSlot* slot;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			if (m_currentChunk >= m_chunkTotal)
+				break;
+
+			slot = &m_slots[(size_t)(m_currentChunk % m_slots.size())];
+			m_changed.wait(lock, [this, slot] { return slot->ready && slot->chunk == m_currentChunk; });
+			if (slot->failed)
+				break;
+		}
+
+		// the slot belongs to the reader until it is released below
+		unsigned int points = std::min(slot->pointCount - m_currentOffset, pointsRemaining);
+		memcpy(bufferCurrent, slot->data + (size_t)m_currentOffset * m_pointSize, (size_t)points * m_pointSize);
+		bufferCurrent += (size_t)points * m_pointSize;
+		pointsRemaining -= points;
+		m_currentOffset += points;
+
+		if (m_currentOffset == slot->pointCount) {
+			std::lock_guard<std::mutex> lock(m_mutex);
+			slot->ready = false;
+			++m_currentChunk;
+			m_currentOffset = 0;
+			m_changed.notify_all();
+		}
+	}
+
+	return (int)(bufferCurrent - buffer);
+}
+
+bool LAZChunkPool::DecodeChunk(LASunzipper* unzipper, long long chunk, ChunkSlot* slot) {
+
+	unsigned int chunkPoints = m_chunkCount[(size_t)chunk];
+	if (slot->capacity < chunkPoints) {
+		delete[] slot->data;
+		slot->data = new unsigned char[(size_t)chunkPoints * m_pointSize];
+		slot->capacity = chunkPoints;
+	}
+	slot->pointCount = chunkPoints;
+
+	if (!unzipper->seek(m_chunkFirst[(size_t)chunk]))
+		return false;
+
+	// decode straight into the slot instead of copying each point
+	return (unzipper->read_batch(slot->data, chunkPoints, m_pointSize) == chunkPoints);
+}
+
+void LAZChunkPool::Work() {
+
+	int bufferSize = 1024 * 1024;
+
+	char* streamBuffer = NULL;
+	LASunzipper* unzipper = NULL;
+
+	FILE* file = NULL;
+	if (m_mappedFile) {
+		// every worker reads the same pages in place
+		unzipper = new LASunzipper();
+		unzipper->set_decompress_selective(m_decompressSelective);
+		unzipper->set_chunk_index(m_path.c_str());
+		if (!unzipper->open(m_mappedFile->GetData(), m_mappedFile->GetSize(), m_pointDataOffset, m_zip)) {
+			delete unzipper;
+			unzipper = NULL;
+		}
+	}
+	else if ((file = fopen(m_path.c_str(), "rb")) != NULL) {
+		streamBuffer = new char[bufferSize];
+		setvbuf(file, streamBuffer, _IOFBF, bufferSize);
+
+		if (!fseek(file, m_pointDataOffset, SEEK_SET)) {
+			unzipper = new LASunzipper();
+			unzipper->set_decompress_selective(m_decompressSelective);
+			unzipper->set_chunk_index(m_path.c_str());
+			if (!unzipper->open(file, m_zip)) {
+				delete unzipper;
+				unzipper = NULL;
+			}
+		}
+	}
+
+	// what this worker's unzipper has counted and was added to the pool
+	std::vector<long long> reported(m_itemCounters.size(), 0);
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true)
+	{
+		m_changed.wait(lock, [this] {
+			return m_stop || (m_nextDispatch < m_chunkTotal && m_nextDispatch < m_currentChunk + (long long)m_slots.size());
+		});
+		if (m_stop)
+			break;
+
+		long long chunk = m_nextDispatch++;
+		ChunkSlot* slot = &m_slots[(size_t)(chunk % m_slots.size())];
+		++m_busy;
+
+		lock.unlock();
+		bool decoded = (unzipper != NULL) && DecodeChunk(unzipper, chunk, slot);
+		lock.lock();
+
+		--m_busy;
+		if (decoded)
+			CollectItemCounters(unzipper, reported);
+		slot->chunk = chunk;
+		slot->failed = !decoded;
+		slot->ready = true;
+		m_changed.notify_all();
+	}
+	lock.unlock();
+
+	if (unzipper) {
+		unzipper->close();
+		delete unzipper;
+	}
+
+	if (file)
+		fclose(file);
+
+	delete[] streamBuffer;
+}
+
+void LAZChunkPool::CollectItemCounters(LASunzipper* unzipper, std::vector<long long>& reported) {
+	
+	// the unzipper counts from when it was opened, so only the increase is added
+	for (unsigned int i = 0; i < m_zip->num_items; i++) {
+		long long counters[3];
+		if (!unzipper->get_item_counters(i, &counters[0], &counters[1], &counters[2]))
+			return;
+		for (int k = 0; k < 3; k++) {
+			m_itemCounters[3 * i + k] += counters[k] - reported[3 * i + k];
+			reported[3 * i + k] = counters[k];
+		}
+	}
+}
+
+void LAZChunkPool::AddItemCounters(unsigned int item, long long* cycles, long long* points, long long* bytes) {
+	
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (item >= m_zip->num_items)
+		return;
+
+	*cycles += m_itemCounters[3 * item];
+	*points += m_itemCounters[3 * item + 1];
+	*bytes += m_itemCounters[3 * item + 2];
+}
+
+LAZChunkPool::~LAZChunkPool() {
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+		m_changed.notify_all();
+	}
+
+	for (size_t i = 0; i < m_threads.size(); i++)
+		m_threads[i].join();
+
+	for (size_t i = 0; i < m_slots.size(); i++)
+		delete[] m_slots[i].data;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "lasunzipper.hpp"
+
+class LAZMappedFile;
+
+// Decodes independent LAZ chunks on a pool of worker threads (each with its
+// own unzipper over the shared mapping or its own file handle) and hands
+// the points back in file order.
+class LAZChunkPool
+{
+public:
+
+	LAZChunkPool(const char* path, unsigned long dataOffset, const LAZMappedFile* mappedFile, LASzip* zip, LASunzipper* unzipper, long long pointCount, unsigned int pointSize, int threadCount, unsigned int decompressSelective);
+	~LAZChunkPool();
+
+	bool IsValid() const;
+
+	void Seek(long long pointIndex);
+	int Read(unsigned char* buffer, int byteCount);
+
+	// adds what the workers have counted for decoding an item (see LASunzipper::get_item_counters)
+	void AddItemCounters(unsigned int item, long long* cycles, long long* points, long long* bytes);
+
+private:
+
+	struct ChunkSlot
+	{
+		long long chunk;
+		unsigned int pointCount;
+		unsigned int capacity;
+		unsigned char* data;
+		bool ready;
+		bool failed;
+	};
+
+	void Work();
+	bool DecodeChunk(LASunzipper* unzipper, long long chunk, ChunkSlot* slot);
+	long long FindChunk(long long pointIndex) const;
+	void CollectItemCounters(LASunzipper* unzipper, std::vector<long long>& reported);
+
+	std::string m_path;
+	unsigned long m_pointDataOffset;
+	const LAZMappedFile* m_mappedFile;
+	LASzip* m_zip;
+	unsigned int m_pointSize;
+	long long m_pointCount;
+	unsigned int m_decompressSelective;
+
+	std::vector<unsigned int> m_chunkFirst;
+	std::vector<unsigned int> m_chunkCount;
+	long long m_chunkTotal;
+
+	// cycles, points and bytes of each item (with an instrumented LASzip)
+	std::vector<long long> m_itemCounters;
+
+	std::vector<ChunkSlot> m_slots;
+	std::vector<std::thread> m_threads;
+
+	std::mutex m_mutex;
+	std::condition_variable m_changed;
+
+	long long m_nextDispatch;
+	long long m_currentChunk;
+	unsigned int m_currentOffset;
+	int m_busy;
+	bool m_stop;
+};
@@ -15,6 +15,26 @@ LAZInterop::LAZInterop(System::String^ path, unsigned long dataOffset, array<Byt
 	m_blockReader = new LAZBlockReader(pathStr, dataOffset, pVLR, vlr->Length);
 }
 
+LAZInterop::LAZInterop(System::String^ path, unsigned long dataOffset, array<Byte>^ vlr, long long pointCount, int threadCount) {
+
+	msclr::interop::marshal_context context;
+	const char* pathStr = context.marshal_as<const char*>(path);
+
+	cli::pin_ptr<unsigned char> pVLR = &vlr[0];
+	
+	m_blockReader = new LAZBlockReader(pathStr, dataOffset, pVLR, vlr->Length, pointCount, threadCount);
+}
+
+LAZInterop::LAZInterop(System::String^ path, unsigned long dataOffset, array<Byte>^ vlr, long long pointCount, int threadCount, unsigned int decompressSelective) {
+
+	msclr::interop::marshal_context context;
+	const char* pathStr = context.marshal_as<const char*>(path);
+
+	cli::pin_ptr<unsigned char> pVLR = &vlr[0];
+	
+	m_blockReader = new LAZBlockReader(pathStr, dataOffset, pVLR, vlr->Length, pointCount, threadCount, decompressSelective);
+}
+
 void LAZInterop::Seek(long long byteOffset) {
 	
 	m_blockReader->Seek(byteOffset);
@@ -32,6 +52,90 @@ long long LAZInterop::GetPosition() {
 	return m_blockReader->GetPosition();
 }
 
+array<long long>^ LAZInterop::GetPointRangesInBox(int minX, int minY, int minZ, int maxX, int maxY, int maxZ, bool useZ) {
+	
+	unsigned int chunkCount = m_blockReader->GetChunkCount();
+	if (chunkCount == 0)
+		return nullptr;
+
+	int minXYZ[3] = { minX, minY, minZ };
+	int maxXYZ[3] = { maxX, maxY, maxZ };
+
+	long long* ranges = new long long[2 * chunkCount];
+	int rangeCount = m_blockReader->GetPointRangesInBox(minXYZ, maxXYZ, useZ, ranges);
+	array<long long>^ result = ToManaged(ranges, rangeCount);
+
+	delete[] ranges;
+	return result;
+}
+
+array<long long>^ LAZInterop::GetPointRangesWithClassification(unsigned char classification) {
+	
+	unsigned int chunkCount = m_blockReader->GetChunkCount();
+	if (chunkCount == 0)
+		return nullptr;
+
+	long long* ranges = new long long[2 * chunkCount];
+	int rangeCount = m_blockReader->GetPointRangesWithClassification(classification, ranges);
+	array<long long>^ result = ToManaged(ranges, rangeCount);
+
+	delete[] ranges;
+	return result;
+}
+
+array<long long>^ LAZInterop::GetPointRangesInGpsTime(double minGpsTime, double maxGpsTime) {
+	
+	unsigned int chunkCount = m_blockReader->GetChunkCount();
+	if (chunkCount == 0)
+		return nullptr;
+
+	long long* ranges = new long long[2 * chunkCount];
+	int rangeCount = m_blockReader->GetPointRangesInGpsTime(minGpsTime, maxGpsTime, ranges);
+	array<long long>^ result = ToManaged(ranges, rangeCount);
+
+	delete[] ranges;
+	return result;
+}
+
+array<System::String^>^ LAZInterop::GetItemNames() {
+	
+	unsigned int itemCount = m_blockReader->GetItemCount();
+	array<System::String^>^ result = gcnew array<System::String^>(itemCount);
+	for (unsigned int i = 0; i < itemCount; i++)
+		result[i] = gcnew System::String(m_blockReader->GetItemName(i));
+
+	return result;
+}
+
+array<long long>^ LAZInterop::GetItemCounters() {
+	
+	unsigned int itemCount = m_blockReader->GetItemCount();
+	if (itemCount == 0)
+		return nullptr;
+
+	array<long long>^ result = gcnew array<long long>(3 * itemCount);
+	for (unsigned int i = 0; i < itemCount; i++) {
+		long long cycles, points, bytes;
+		if (!m_blockReader->GetItemCounters(i, &cycles, &points, &bytes))
+			return nullptr;
+
+		result[3 * i] = cycles;
+		result[3 * i + 1] = points;
+		result[3 * i + 2] = bytes;
+	}
+
+	return result;
+}
+
+array<long long>^ LAZInterop::ToManaged(const long long* ranges, int rangeCount) {
+	
+	array<long long>^ result = gcnew array<long long>(2 * rangeCount);
+	for (int i = 0; i < 2 * rangeCount; i++)
+		result[i] = ranges[i];
+
+	return result;
+}
+
 LAZInterop::~LAZInterop() {
 	
 	if (m_blockReader) {
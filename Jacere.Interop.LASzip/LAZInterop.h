@@ -12,6 +12,9 @@ public ref class LAZInterop
 public:
 
 	LAZInterop(System::String^ path, unsigned long dataOffset, array<Byte>^ vlr);
+	LAZInterop(System::String^ path, unsigned long dataOffset, array<Byte>^ vlr, long long pointCount, int threadCount);
+	// layered files only decode the LASZIP_DECOMPRESS_SELECTIVE_* layers that are asked for
+	LAZInterop(System::String^ path, unsigned long dataOffset, array<Byte>^ vlr, long long pointCount, int threadCount, unsigned int decompressSelective);
     ~LAZInterop();
 
 	// provide a logical byte-based access (even though it is actually compressed)
@@ -19,10 +22,25 @@ public:
 	int Read(array<Byte>^ buffer, int byteOffset, int byteCount);
 	long long GetPosition();
 
+	// (first point, point count) pairs of the chunks that may have points inside
+	// the quantized box, or nullptr if the file has no chunk table
+	array<long long>^ GetPointRangesInBox(int minX, int minY, int minZ, int maxX, int maxY, int maxZ, bool useZ);
+	// the same for the chunks with points of a classification or in a gps time window
+	array<long long>^ GetPointRangesWithClassification(unsigned char classification);
+	array<long long>^ GetPointRangesInGpsTime(double minGpsTime, double maxGpsTime);
+
+	// the names of the items of the point and what decoding them has cost so far
+	// as (cycles, points, bytes) for each item, or nullptr unless LASzip was built
+	// with LASZIP_INSTRUMENT
+	array<System::String^>^ GetItemNames();
+	array<long long>^ GetItemCounters();
+
 private:
 
 	LAZBlockReader* m_blockReader;
 
+	static array<long long>^ ToManaged(const long long* ranges, int rangeCount);
+
 };
 
 }}}
@@ -0,0 +1,91 @@
+#include "LAZMappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <stddef.h>
+
+LAZMappedFile::LAZMappedFile(const char* path) {
+
+	m_data = NULL;
+	m_size = 0;
+
+#ifdef _WIN32
+	m_file = INVALID_HANDLE_VALUE;
+	m_mapping = NULL;
+
+	m_file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, NULL);
+	if (m_file == INVALID_HANDLE_VALUE)
+		return;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0)
+		return;
+
+	// a view larger than the address space (32-bit process) cannot be mapped
+	if ((unsigned long long)size.QuadPart > (unsigned long long)(size_t)-1)
+		return;
+
+	m_mapping = CreateFileMappingA(m_file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!m_mapping)
+		return;
+
+	m_data = (const unsigned char*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+	if (m_data)
+		m_size = size.QuadPart;
+#else
+	int file = open(path, O_RDONLY);
+	if (file < 0)
+		return;
+
+	struct stat status;
+	if (!fstat(file, &status) && status.st_size > 0) {
+		void* data = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_SHARED, file, 0);
+		if (data != MAP_FAILED) {
+			m_data = (const unsigned char*)data;
+			m_size = status.st_size;
+		}
+	}
+
+	// the mapping stays valid after the descriptor is closed
+	close(file);
+#endif
+}
+
+bool LAZMappedFile::IsValid() const {
+
+	return (m_data != NULL);
+}
+
+const unsigned char* LAZMappedFile::GetData() const {
+
+	return m_data;
+}
+
+long long LAZMappedFile::GetSize() const {
+
+	return m_size;
+}
+
+LAZMappedFile::~LAZMappedFile() {
+
+#ifdef _WIN32
+	if (m_data)
+		UnmapViewOfFile(m_data);
+
+	if (m_mapping)
+		CloseHandle(m_mapping);
+
+	if (m_file != INVALID_HANDLE_VALUE)
+		CloseHandle(m_file);
+#else
+	if (m_data)
+		munmap((void*)m_data, (size_t)m_size);
+#endif
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+// Read-only mapping of a whole file, shared by every reader of it so the
+// page cache serves them directly (IsValid is false if it cannot be mapped).
+class LAZMappedFile
+{
+public:
+
+	LAZMappedFile(const char* path);
+	~LAZMappedFile();
+
+	bool IsValid() const;
+
+	const unsigned char* GetData() const;
+	long long GetSize() const;
+
+private:
+
+	const unsigned char* m_data;
+	long long m_size;
+
+#ifdef _WIN32
+	void* m_file;
+	void* m_mapping;
+#endif
+
+};
@@ -0,0 +1,61 @@
+#include <msclr/marshal_cppstd.h>
+
+#include "LAZWriterInterop.h"
+#include "LAZBlockWriter.h"
+
+using namespace Jacere::Interop::LASzip;
+
+LAZWriterInterop::LAZWriterInterop(System::String^ path, unsigned long dataOffset, Byte pointFormat, unsigned short pointSize, int threadCount) {
+	
+	msclr::interop::marshal_context context;
+	const char* pathStr = context.marshal_as<const char*>(path);
+
+	m_blockWriter = new LAZBlockWriter(pathStr, dataOffset, pointFormat, pointSize, threadCount);
+	if (!m_blockWriter->IsValid()) {
+		delete m_blockWriter;
+		m_blockWriter = NULL;
+		throw gcnew InvalidOperationException("Unable to open the LAZ writer");
+	}
+}
+
+array<Byte>^ LAZWriterInterop::CreateVLR(Byte pointFormat, unsigned short pointSize) {
+	
+	unsigned char* vlr;
+	int vlrLength = LAZBlockWriter::CreateVLR(pointFormat, pointSize, &vlr);
+	if (vlrLength == 0)
+		return nullptr;
+
+	array<Byte>^ result = gcnew array<Byte>(vlrLength);
+	for (int i = 0; i < vlrLength; i++)
+		result[i] = vlr[i];
+
+	delete[] vlr;
+	return result;
+}
+
+void LAZWriterInterop::Write(array<Byte>^ buffer, int byteOffset, int byteCount) {
+	
+	if (byteCount == 0)
+		return;
+
+	cli::pin_ptr<unsigned char> pBuffer = &buffer[0];
+	m_blockWriter->Write(pBuffer, byteOffset, byteCount);
+}
+
+void LAZWriterInterop::Chunk() {
+	
+	m_blockWriter->Chunk();
+}
+
+long long LAZWriterInterop::Close() {
+	
+	return m_blockWriter->Close();
+}
+
+LAZWriterInterop::~LAZWriterInterop() {
+	
+	if (m_blockWriter) {
+		delete m_blockWriter;
+		m_blockWriter = NULL;
+	}
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "laszipper.hpp"
+#include "LAZBlockWriter.h"
+
+using namespace System;
+
+namespace Jacere { namespace Interop { namespace LASzip {
+
+public ref class LAZWriterInterop
+{
+public:
+
+	// compresses into a file whose header (with the record from CreateVLR) is already written
+	LAZWriterInterop(System::String^ path, unsigned long dataOffset, Byte pointFormat, unsigned short pointSize, int threadCount);
+    ~LAZWriterInterop();
+
+	static array<Byte>^ CreateVLR(Byte pointFormat, unsigned short pointSize);
+
+	// every chunk can be decoded on its own
+	void Write(array<Byte>^ buffer, int byteOffset, int byteCount);
+	void Chunk();
+	long long Close();
+
+private:
+
+	LAZBlockWriter* m_blockWriter;
+
+};
+
+}}}
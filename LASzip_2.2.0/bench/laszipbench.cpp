@@ -0,0 +1,788 @@
+/*
+===============================================================================
+
+  FILE:  laszipbench.cpp
+
+  CONTENTS:
+
+    Benchmarks the LASzip codecs on synthetic point clouds. The micro
+    benchmarks time the arithmetic and the rANS coder on symbols and bits,
+    the integer compressor, and every v1/v2 item codec on its own. The macro
+    benchmarks time whole LASzipper/LASunzipper round trips in memory (with
+    either coder). Each scene has the coherence of a kind of real data
+    (airborne scan lines, a terrestrial station, plain noise) so that the
+    bits per point are meaningful as well.
+
+    usage: laszipbench [-n points] [-r repeats] [-scene airborne|terrestrial|noisy]
+                       [-micro] [-macro] [-coder arithmetic|rans]
+                       [-interleave chunks]
+
+  PROGRAMMERS:
+
+    agent@local
+
+  COPYRIGHT:
+
+    (c) 2026, agent@local
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the COPYING file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    17 October 2026 -- batches can decode several chunks in lock-step
+    17 October 2026 -- times the rANS coder next to the arithmetic coder
+    17 October 2026 -- created to measure every decode optimization
+
+===============================================================================
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "laszip.hpp"
+#include "laszipper.hpp"
+#include "lasunzipper.hpp"
+
+#include "arithmeticencoder.hpp"
+#include "arithmeticdecoder.hpp"
+#include "ransencoder.hpp"
+#include "ransdecoder.hpp"
+#include "bytestreamin_array.hpp"
+#include "bytestreamout_array.hpp"
+#include "integercompressor.hpp"
+#include "laswriteitemcompressed_v1.hpp"
+#include "laswriteitemcompressed_v2.hpp"
+#include "lasreaditemcompressed_v1.hpp"
+#include "lasreaditemcompressed_v2.hpp"
+
+// one point with every attribute the items can store
+
+struct Sample
+{
+  I32 x, y, z;
+  U16 intensity;
+  U8 return_number;
+  U8 number_of_returns;
+  U8 scan_direction;
+  U8 edge;
+  U8 classification;
+  U8 user_data;
+  I16 scan_angle;
+  U16 point_source_id;
+  F64 gps_time;
+  U16 rgb[4];
+  U8 extra[4];
+  U64 wave_offset;
+  F32 wave_location;
+};
+
+// deterministic on every platform (unlike rand)
+
+static U32 random_state = 1;
+
+static U32 random_next()
+{
+  random_state ^= random_state << 13;
+  random_state ^= random_state >> 17;
+  random_state ^= random_state << 5;
+  return random_state;
+}
+
+static I32 random_range(I32 lo, I32 hi)
+{
+  return lo + (I32)(random_next() % (U32)(hi - lo + 1));
+}
+
+static void finish_sample(Sample& s)
+{
+  s.extra[0] = (U8)(s.intensity >> 4);
+  s.extra[1] = (U8)(s.classification * 3);
+  s.extra[2] = (U8)random_range(0, 3);
+  s.extra[3] = 0;
+}
+
+// flight lines of a zig-zag scanner over smooth terrain with some vegetation
+
+static void generate_airborne(std::vector<Sample>& samples, const U32 n)
+{
+  const U32 line_points = 800;
+  U32 i = 0, pulse = 0;
+  U64 wave_offset = 0;
+  random_state = 1;
+  while (i < n)
+  {
+    U32 line = pulse / line_points;
+    U32 k = pulse % line_points;
+    BOOL forward = ((line & 1) == 0);
+    I32 step = (forward ? (I32)k : (I32)(line_points - 1 - k));
+    F64 fx = step*45.0 + line*7.0;
+    F64 fy = line*55.0 + step*0.8;
+    I32 ground = (I32)(10000 + 600*sin(fx/9000.0) + 400*cos(fy/7000.0));
+    BOOL vegetation = (sin(fx/1300.0)*cos(fy/1700.0) > 0.4);
+    U8 returns = (vegetation && (random_next() % 3) ? 2 : 1);
+    U8 r;
+    for (r = 1; r <= returns && i < n; r++, i++)
+    {
+      Sample& s = samples[i];
+      s.x = (I32)fx + random_range(-3, 3);
+      s.y = (I32)fy + random_range(-3, 3);
+      s.z = ground + random_range(-15, 15);
+      if (returns == 2 && r == 1) s.z += 800 + random_range(-300, 300);
+      s.intensity = (U16)(vegetation ? 90 + random_range(0, 60) : 220 + random_range(-25, 25));
+      s.return_number = r;
+      s.number_of_returns = returns;
+      s.scan_direction = (forward ? 1 : 0);
+      s.edge = (k == line_points - 1 ? 1 : 0);
+      s.classification = (returns == 2 && r == 1 ? 5 : 2);
+      s.user_data = 0;
+      s.scan_angle = (I16)(-20 + (40*step)/(I32)line_points);
+      s.point_source_id = (U16)(1 + line/200);
+      s.gps_time = 315000.0 + pulse*0.00001;
+      s.rgb[0] = (U16)(30000 + 8000*sin(fx/2000.0) + random_range(-200, 200));
+      s.rgb[1] = (U16)(vegetation ? 40000 + random_range(-300, 300) : 26000 + random_range(-300, 300));
+      s.rgb[2] = (U16)(20000 + 6000*cos(fy/3000.0) + random_range(-200, 200));
+      s.rgb[3] = (U16)(vegetation ? 52000 + random_range(-500, 500) : 12000 + random_range(-500, 500));
+      s.wave_offset = wave_offset;
+      s.wave_location = (F32)(1000.0 + random_range(-50, 50));
+      wave_offset += 256;
+      finish_sample(s);
+    }
+    pulse++;
+  }
+}
+
+// a station that scans columns from the ground up to the walls around it
+
+static void generate_terrestrial(std::vector<Sample>& samples, const U32 n)
+{
+  const U32 column_points = 1000;
+  const F64 pi = 3.14159265358979323846;
+  U32 i;
+  random_state = 2;
+  for (i = 0; i < n; i++)
+  {
+    Sample& s = samples[i];
+    U32 column = i / column_points;
+    U32 k = i % column_points;
+    F64 azimuth = column*0.0005;
+    F64 elevation = (-40.0 + 100.0*k/column_points)*pi/180.0;
+    F64 range;
+    if (elevation < -0.02)
+      range = 180.0 / sin(-elevation);
+    else
+      range = (3000.0 + 800.0*sin(azimuth*3.0)) / cos(elevation);
+    if (range > 20000.0) range = 20000.0;
+    range += random_range(-2, 2);
+    s.x = (I32)(range*cos(elevation)*cos(azimuth));
+    s.y = (I32)(range*cos(elevation)*sin(azimuth));
+    s.z = (I32)(range*sin(elevation));
+    s.intensity = (U16)(60000.0*300.0/(300.0 + range) + random_range(-100, 100));
+    s.return_number = 1;
+    s.number_of_returns = 1;
+    s.scan_direction = 0;
+    s.edge = (k == column_points - 1 ? 1 : 0);
+    s.classification = (elevation < -0.02 ? 2 : 6);
+    s.user_data = 0;
+    s.scan_angle = 0;
+    s.point_source_id = 1;
+    s.gps_time = 1000.0 + i*0.000002;
+    s.rgb[0] = (U16)(((s.x >> 6) & 0xFF) << 8 | random_range(0, 255));
+    s.rgb[1] = (U16)(((s.y >> 6) & 0xFF) << 8 | random_range(0, 255));
+    s.rgb[2] = (U16)(((s.z >> 4) & 0xFF) << 8 | random_range(0, 255));
+    s.rgb[3] = (U16)(s.intensity & 0xFF00);
+    s.wave_offset = (U64)i*128;
+    s.wave_location = (F32)range;
+    finish_sample(s);
+  }
+}
+
+// independent random attributes as the worst case for every predictor
+
+static void generate_noisy(std::vector<Sample>& samples, const U32 n)
+{
+  U32 i;
+  random_state = 3;
+  for (i = 0; i < n; i++)
+  {
+    Sample& s = samples[i];
+    s.x = random_range(0, 10000000);
+    s.y = random_range(0, 10000000);
+    s.z = random_range(0, 100000);
+    s.intensity = (U16)random_next();
+    s.number_of_returns = (U8)random_range(1, 5);
+    s.return_number = (U8)random_range(1, s.number_of_returns);
+    s.scan_direction = (U8)(random_next() & 1);
+    s.edge = (U8)(random_next() & 1);
+    s.classification = (U8)random_range(0, 31);
+    s.user_data = (U8)random_next();
+    s.scan_angle = (I16)random_range(-90, 90);
+    s.point_source_id = (U16)random_next();
+    s.gps_time = random_range(0, 1000000)*0.001;
+    s.rgb[0] = (U16)random_next();
+    s.rgb[1] = (U16)random_next();
+    s.rgb[2] = (U16)random_next();
+    s.rgb[3] = (U16)random_next();
+    s.wave_offset = random_next();
+    s.wave_location = (F32)random_range(0, 100000);
+    finish_sample(s);
+    s.extra[2] = (U8)random_next();
+    s.extra[3] = (U8)random_next();
+  }
+}
+
+// packing the samples into the memory layout of each item
+
+static void pack_item(U8* item, const LASitem& type, const Sample& s)
+{
+  switch (type.type)
+  {
+  case LASitem::POINT10:
+    memcpy(item + 0, &s.x, 4);
+    memcpy(item + 4, &s.y, 4);
+    memcpy(item + 8, &s.z, 4);
+    memcpy(item + 12, &s.intensity, 2);
+    item[14] = (U8)((s.return_number & 7) | ((s.number_of_returns & 7) << 3) | (s.scan_direction << 6) | (s.edge << 7));
+    item[15] = s.classification;
+    item[16] = (U8)(I8)s.scan_angle;
+    item[17] = s.user_data;
+    memcpy(item + 18, &s.point_source_id, 2);
+    break;
+  case LASitem::GPSTIME11:
+    memcpy(item, &s.gps_time, 8);
+    break;
+  case LASitem::RGB12:
+    memcpy(item, s.rgb, 6);
+    break;
+  case LASitem::WAVEPACKET13:
+    {
+      U32 size = 256;
+      F32 d[3] = { 0.0001f, -0.0002f, -0.5f };
+      item[0] = 1;
+      memcpy(item + 1, &s.wave_offset, 8);
+      memcpy(item + 9, &size, 4);
+      memcpy(item + 13, &s.wave_location, 4);
+      memcpy(item + 17, d, 12);
+    }
+    break;
+  case LASitem::BYTE:
+    memcpy(item, s.extra, type.size);
+    break;
+  case LASitem::POINT14:
+    {
+      I16 scan_angle = (I16)(s.scan_angle*166);
+      memcpy(item + 0, &s.x, 4);
+      memcpy(item + 4, &s.y, 4);
+      memcpy(item + 8, &s.z, 4);
+      memcpy(item + 12, &s.intensity, 2);
+      item[14] = (U8)((s.return_number & 15) | ((s.number_of_returns & 15) << 4));
+      item[15] = (U8)((s.scan_direction << 6) | (s.edge << 7));
+      item[16] = s.classification;
+      item[17] = s.user_data;
+      memcpy(item + 18, &scan_angle, 2);
+      memcpy(item + 20, &s.point_source_id, 2);
+      memcpy(item + 22, &s.gps_time, 8);
+    }
+    break;
+  case LASitem::RGBNIR14:
+    memcpy(item, s.rgb, 8);
+    break;
+  default:
+    break;
+  }
+}
+
+static void pack_items(std::vector<U8>& items, const LASitem& type, const std::vector<Sample>& samples)
+{
+  size_t i;
+  items.assign(samples.size()*type.size, 0);
+  for (i = 0; i < samples.size(); i++)
+  {
+    pack_item(&items[i*type.size], type, samples[i]);
+  }
+}
+
+static void pack_points(std::vector<U8>& points, const LASzip& zip, const std::vector<Sample>& samples)
+{
+  size_t i;
+  U32 j, offset, size = 0;
+  for (j = 0; j < zip.num_items; j++) size += zip.items[j].size;
+  points.assign(samples.size()*size, 0);
+  for (i = 0; i < samples.size(); i++)
+  {
+    offset = 0;
+    for (j = 0; j < zip.num_items; j++)
+    {
+      pack_item(&points[i*size + offset], zip.items[j], samples[i]);
+      offset += zip.items[j].size;
+    }
+  }
+}
+
+// timing and reporting
+
+typedef std::chrono::high_resolution_clock Clock;
+
+// wide enough for the longest name with a " (batch)" after it
+#define NAME_WIDTH 36
+
+static F64 seconds_since(const Clock::time_point& start)
+{
+  return std::chrono::duration<F64>(Clock::now() - start).count();
+}
+
+static void report_header(const char* scene, const U32 n)
+{
+  fprintf(stdout, "\n%s (%u points)\n", scene, n);
+  fprintf(stdout, "  %-*s %12s %10s %12s %10s %10s\n", NAME_WIDTH, "", "enc Mpts/s", "enc MB/s", "dec Mpts/s", "dec MB/s", "bits/pt");
+}
+
+static void format_rate(char* text, const F64 amount, const F64 seconds, const char* format)
+{
+  // a dash for what was not measured
+  if (seconds > 0 && amount > 0)
+    sprintf(text, format, amount/seconds);
+  else
+    strcpy(text, "-");
+}
+
+static void report(const char* name, const U32 n, const U32 raw_bytes, const F64 encode, const F64 decode, const I64 compressed, const BOOL valid)
+{
+  char enc_points[32], enc_bytes[32], dec_points[32], dec_bytes[32];
+  format_rate(enc_points, n/1e6, encode, "%.2f");
+  format_rate(enc_bytes, (F64)n*raw_bytes/1048576.0, encode, "%.1f");
+  format_rate(dec_points, n/1e6, decode, "%.2f");
+  format_rate(dec_bytes, (F64)n*raw_bytes/1048576.0, decode, "%.1f");
+  fprintf(stdout, "  %-*s %12s %10s %12s %10s %10.2f%s\n", NAME_WIDTH, name, enc_points, enc_bytes, dec_points, dec_bytes,
+    (n ? 8.0*compressed/n : 0.0), (valid ? "" : "  MISMATCH"));
+}
+
+// entropy coder with an adaptive symbol model and an adaptive bit model
+
+template<class Encoder, class Decoder>
+static void bench_coder(const char* coder, const std::vector<Sample>& samples, const U32 repeats)
+{
+  U32 r;
+  size_t i, n = samples.size();
+  std::vector<U32> symbols(n), bits(n);
+  for (i = 0; i < n; i++)
+  {
+    symbols[i] = (U32)(samples[i].x - (i ? samples[i-1].x : 0)) & 0xFF;
+    bits[i] = (samples[i].classification == 2);
+  }
+
+  for (U32 kind = 0; kind < 2; kind++)
+  {
+    const std::vector<U32>& data = (kind == 0 ? symbols : bits);
+    F64 best_encode = 0, best_decode = 0;
+    I64 compressed = 0;
+    BOOL valid = TRUE;
+    for (r = 0; r < repeats; r++)
+    {
+      ByteStreamOutArrayLE outstream;
+      Encoder enc;
+      EntropyModel* m = (kind == 0 ? enc.createSymbolModel(256) : enc.createBitModel());
+      if (kind == 0) enc.initSymbolModel(m); else enc.initBitModel(m);
+      Clock::time_point start = Clock::now();
+      enc.init(&outstream);
+      if (kind == 0)
+        for (i = 0; i < n; i++) enc.encodeSymbol(m, data[i]);
+      else
+        for (i = 0; i < n; i++) enc.encodeBit(m, data[i]);
+      enc.done();
+      F64 encode = seconds_since(start);
+      if (kind == 0) enc.destroySymbolModel(m); else enc.destroyBitModel(m);
+      compressed = outstream.getSize();
+
+      ByteStreamInArrayLE instream(outstream.getData(), outstream.getSize());
+      Decoder dec;
+      m = (kind == 0 ? dec.createSymbolModel(256) : dec.createBitModel());
+      if (kind == 0) dec.initSymbolModel(m); else dec.initBitModel(m);
+      U32 mismatches = 0;
+      start = Clock::now();
+      dec.init(&instream);
+      if (kind == 0)
+        for (i = 0; i < n; i++) mismatches += (dec.decodeSymbol(m) != data[i]);
+      else
+        for (i = 0; i < n; i++) mismatches += (dec.decodeBit(m) != data[i]);
+      dec.done();
+      F64 decode = seconds_since(start);
+      if (kind == 0) dec.destroySymbolModel(m); else dec.destroyBitModel(m);
+
+      if (mismatches) valid = FALSE;
+      if (r == 0 || encode < best_encode) best_encode = encode;
+      if (r == 0 || decode < best_decode) best_decode = decode;
+    }
+    std::string name = std::string(coder) + (kind == 0 ? " symbols (256)" : " bits");
+    report(name.c_str(), (U32)n, (kind == 0 ? 1 : 0), best_encode, best_decode, compressed, valid);
+  }
+}
+
+// integer compressor predicting x, y and z from the previous point
+
+static void bench_integer(const std::vector<Sample>& samples, const U32 repeats)
+{
+  U32 r;
+  size_t i, n = samples.size();
+  F64 best_encode = 0, best_decode = 0;
+  I64 compressed = 0;
+  BOOL valid = TRUE;
+  for (r = 0; r < repeats; r++)
+  {
+    ByteStreamOutArrayLE outstream;
+    ArithmeticEncoder enc;
+    IntegerCompressor ic_enc(&enc, 32, 3);
+    ic_enc.initCompressor();
+    Clock::time_point start = Clock::now();
+    enc.init(&outstream);
+    for (i = 1; i < n; i++)
+    {
+      ic_enc.compress(samples[i-1].x, samples[i].x, 0);
+      ic_enc.compress(samples[i-1].y, samples[i].y, 1);
+      ic_enc.compress(samples[i-1].z, samples[i].z, 2);
+    }
+    enc.done();
+    F64 encode = seconds_since(start);
+    compressed = outstream.getSize();
+
+    ByteStreamInArrayLE instream(outstream.getData(), outstream.getSize());
+    ArithmeticDecoder dec;
+    IntegerCompressor ic_dec(&dec, 32, 3);
+    ic_dec.initDecompressor();
+    U32 mismatches = 0;
+    start = Clock::now();
+    dec.init(&instream);
+    for (i = 1; i < n; i++)
+    {
+      mismatches += (ic_dec.decompress(samples[i-1].x, 0) != samples[i].x);
+      mismatches += (ic_dec.decompress(samples[i-1].y, 1) != samples[i].y);
+      mismatches += (ic_dec.decompress(samples[i-1].z, 2) != samples[i].z);
+    }
+    dec.done();
+    F64 decode = seconds_since(start);
+
+    if (mismatches) valid = FALSE;
+    if (r == 0 || encode < best_encode) best_encode = encode;
+    if (r == 0 || decode < best_decode) best_decode = decode;
+  }
+  report("integer compressor (xyz)", (U32)n, 12, best_encode, best_decode, compressed, valid);
+}
+
+// every item codec on its own, one item per point
+
+struct ItemCodec
+{
+  const char* name;
+  LASitem::Type type;
+  U16 size;
+  U16 version;
+};
+
+static const ItemCodec item_codecs[] =
+{
+  { "POINT10 v1", LASitem::POINT10, 20, 1 },
+  { "POINT10 v2", LASitem::POINT10, 20, 2 },
+  { "GPSTIME11 v1", LASitem::GPSTIME11, 8, 1 },
+  { "GPSTIME11 v2", LASitem::GPSTIME11, 8, 2 },
+  { "RGB12 v1", LASitem::RGB12, 6, 1 },
+  { "RGB12 v2", LASitem::RGB12, 6, 2 },
+  { "WAVEPACKET13 v1", LASitem::WAVEPACKET13, 29, 1 },
+  { "BYTE(4) v1", LASitem::BYTE, 4, 1 },
+  { "BYTE(4) v2", LASitem::BYTE, 4, 2 },
+  { "POINT14 v2", LASitem::POINT14, 30, LASZIP_ITEM14_VERSION },
+  { "RGBNIR14 v2", LASitem::RGBNIR14, 8, LASZIP_ITEM14_VERSION },
+};
+
+static LASwriteItem* create_writer(const ItemCodec& codec, EntropyEncoder* enc)
+{
+  switch (codec.type)
+  {
+  case LASitem::POINT10:
+    if (codec.version == 1) return new LASwriteItemCompressed_POINT10_v1(enc);
+    return new LASwriteItemCompressed_POINT10_v2(enc, enc);
+  case LASitem::GPSTIME11:
+    if (codec.version == 1) return new LASwriteItemCompressed_GPSTIME11_v1(enc);
+    return new LASwriteItemCompressed_GPSTIME11_v2(enc);
+  case LASitem::RGB12:
+    if (codec.version == 1) return new LASwriteItemCompressed_RGB12_v1(enc);
+    return new LASwriteItemCompressed_RGB12_v2(enc);
+  case LASitem::WAVEPACKET13:
+    return new LASwriteItemCompressed_WAVEPACKET13_v1(enc);
+  case LASitem::BYTE:
+    if (codec.version == 1) return new LASwriteItemCompressed_BYTE_v1(enc, codec.size);
+    return new LASwriteItemCompressed_BYTE_v2(enc, codec.size);
+  case LASitem::POINT14:
+    return new LASwriteItemCompressed_POINT14_v2(enc, enc, enc);
+  case LASitem::RGBNIR14:
+    return new LASwriteItemCompressed_RGBNIR14_v2(enc);
+  default:
+    return 0;
+  }
+}
+
+static LASreadItem* create_reader(const ItemCodec& codec, EntropyDecoder* dec)
+{
+  switch (codec.type)
+  {
+  case LASitem::POINT10:
+    if (codec.version == 1) return new LASreadItemCompressed_POINT10_v1(dec);
+    return new LASreadItemCompressed_POINT10_v2(dec, dec);
+  case LASitem::GPSTIME11:
+    if (codec.version == 1) return new LASreadItemCompressed_GPSTIME11_v1(dec);
+    return new LASreadItemCompressed_GPSTIME11_v2(dec);
+  case LASitem::RGB12:
+    if (codec.version == 1) return new LASreadItemCompressed_RGB12_v1(dec);
+    return new LASreadItemCompressed_RGB12_v2(dec);
+  case LASitem::WAVEPACKET13:
+    return new LASreadItemCompressed_WAVEPACKET13_v1(dec);
+  case LASitem::BYTE:
+    if (codec.version == 1) return new LASreadItemCompressed_BYTE_v1(dec, codec.size);
+    return new LASreadItemCompressed_BYTE_v2(dec, codec.size);
+  case LASitem::POINT14:
+    return new LASreadItemCompressed_POINT14_v2(dec, dec, dec);
+  case LASitem::RGBNIR14:
+    return new LASreadItemCompressed_RGBNIR14_v2(dec);
+  default:
+    return 0;
+  }
+}
+
+static void bench_items(const std::vector<Sample>& samples, const U32 repeats)
+{
+  U32 c, r;
+  size_t i, n = samples.size();
+  std::vector<U8> items, decoded;
+  for (c = 0; c < sizeof(item_codecs)/sizeof(ItemCodec); c++)
+  {
+    const ItemCodec& codec = item_codecs[c];
+    LASitem type;
+    type.type = codec.type;
+    type.size = codec.size;
+    type.version = codec.version;
+    pack_items(items, type, samples);
+    decoded.assign(items.size(), 0);
+
+    F64 best_encode = 0, best_decode = 0;
+    I64 compressed = 0;
+    BOOL valid = TRUE;
+    for (r = 0; r < repeats; r++)
+    {
+      // the first item is stored raw and starts the prediction (as in LASwritePoint)
+      ByteStreamOutArrayLE outstream;
+      ArithmeticEncoder enc;
+      LASwriteItem* writer = create_writer(codec, &enc);
+      Clock::time_point start = Clock::now();
+      ((LASwriteItemCompressed*)writer)->init(&items[0]);
+      enc.init(&outstream);
+      for (i = 1; i < n; i++) writer->write(&items[i*codec.size]);
+      enc.done();
+      F64 encode = seconds_since(start);
+      delete writer;
+      compressed = outstream.getSize() + codec.size;
+
+      ByteStreamInArrayLE instream(outstream.getData(), outstream.getSize());
+      ArithmeticDecoder dec;
+      LASreadItem* reader = create_reader(codec, &dec);
+      memcpy(&decoded[0], &items[0], codec.size);
+      start = Clock::now();
+      ((LASreadItemCompressed*)reader)->init(&decoded[0]);
+      dec.init(&instream);
+      for (i = 1; i < n; i++) reader->read(&decoded[i*codec.size]);
+      dec.done();
+      F64 decode = seconds_since(start);
+      delete reader;
+
+      if (memcmp(&decoded[0], &items[0], items.size())) valid = FALSE;
+      if (r == 0 || encode < best_encode) best_encode = encode;
+      if (r == 0 || decode < best_decode) best_decode = decode;
+    }
+    report(codec.name, (U32)n, codec.size, best_encode, best_decode, compressed, valid);
+  }
+}
+
+// whole round trips through LASzipper and LASunzipper in memory
+
+struct PointCodec
+{
+  const char* name;
+  U8 point_type;
+  U16 point_size;
+  U16 compressor;
+  U16 version;
+};
+
+static const PointCodec point_codecs[] =
+{
+  { "format 3 pointwise v1", 3, 34, LASZIP_COMPRESSOR_POINTWISE, 1 },
+  { "format 3 chunked v1", 3, 34, LASZIP_COMPRESSOR_CHUNKED, 1 },
+  { "format 3 chunked v2", 3, 34, LASZIP_COMPRESSOR_CHUNKED, 2 },
+  { "format 3 layered v2", 3, 34, LASZIP_COMPRESSOR_LAYERED_CHUNKED, 2 },
+  { "format 7 chunked v2", 7, 36, LASZIP_COMPRESSOR_CHUNKED, 2 },
+  { "format 8 layered v2", 8, 38, LASZIP_COMPRESSOR_LAYERED_CHUNKED, 2 },
+};
+
+static void bench_points(const std::vector<Sample>& samples, const U32 repeats, const U16 coder, const U32 interleave)
+{
+  U32 c, r, j, offset;
+  size_t i, n = samples.size();
+  std::vector<U8> points, decoded;
+  for (c = 0; c < sizeof(point_codecs)/sizeof(PointCodec); c++)
+  {
+    const PointCodec& codec = point_codecs[c];
+    LASzip zip;
+    if (!zip.setup(codec.point_type, codec.point_size, codec.compressor, coder) || !zip.request_version(codec.version))
+    {
+      fprintf(stdout, "  %-*s not supported (%s)\n", NAME_WIDTH, codec.name, zip.get_error());
+      continue;
+    }
+    pack_points(points, zip, samples);
+    decoded.assign(points.size(), 0);
+    std::vector<U8*> point(zip.num_items);
+
+    F64 best_encode = 0, best_decode = 0, best_batch = 0;
+    I64 compressed = 0;
+    BOOL valid = TRUE;
+    for (r = 0; r < repeats; r++)
+    {
+      std::ostringstream outstream;
+      LASzipper zipper;
+      Clock::time_point start = Clock::now();
+      if (!zipper.open(outstream, &zip))
+      {
+        fprintf(stdout, "  %-*s %s\n", NAME_WIDTH, codec.name, zipper.get_error());
+        break;
+      }
+      for (i = 0; i < n; i++)
+      {
+        offset = 0;
+        for (j = 0; j < zip.num_items; j++)
+        {
+          point[j] = &points[i*codec.point_size + offset];
+          offset += zip.items[j].size;
+        }
+        zipper.write(&point[0]);
+      }
+      zipper.close();
+      F64 encode = seconds_since(start);
+      std::string bytes = outstream.str();
+      compressed = (I64)bytes.size();
+
+      // one point at a time
+      LASunzipper unzipper;
+      start = Clock::now();
+      unzipper.open((const U8*)bytes.data(), (I64)bytes.size(), 0, &zip);
+      for (i = 0; i < n; i++)
+      {
+        offset = 0;
+        for (j = 0; j < zip.num_items; j++)
+        {
+          point[j] = &decoded[i*codec.point_size + offset];
+          offset += zip.items[j].size;
+        }
+        if (!unzipper.read(&point[0])) break;
+      }
+      unzipper.close();
+      F64 decode = seconds_since(start);
+      if (memcmp(&decoded[0], &points[0], points.size())) valid = FALSE;
+
+      // many points at once
+      decoded.assign(points.size(), 0);
+      start = Clock::now();
+      unzipper.set_interleave(interleave);
+      unzipper.open((const U8*)bytes.data(), (I64)bytes.size(), 0, &zip);
+      unzipper.read_batch(&decoded[0], (U32)n, codec.point_size);
+      unzipper.close();
+      F64 batch = seconds_since(start);
+      if (memcmp(&decoded[0], &points[0], points.size())) valid = FALSE;
+
+      if (r == 0 || encode < best_encode) best_encode = encode;
+      if (r == 0 || decode < best_decode) best_decode = decode;
+      if (r == 0 || batch < best_batch) best_batch = batch;
+    }
+    report(codec.name, (U32)n, codec.point_size, best_encode, best_decode, compressed, valid);
+    std::string batch_name = std::string(codec.name) + (interleave > 1 ? " (interleaved)" : " (batch)");
+    report(batch_name.c_str(), (U32)n, codec.point_size, 0, best_batch, compressed, valid);
+  }
+}
+
+static void usage()
+{
+  fprintf(stderr, "usage: laszipbench [-n points] [-r repeats] [-scene airborne|terrestrial|noisy] [-micro] [-macro] [-coder arithmetic|rans] [-interleave chunks]\n");
+  exit(1);
+}
+
+int main(int argc, char* argv[])
+{
+  int i;
+  U32 n = 1000000;
+  U32 repeats = 3;
+  U16 coder = LASZIP_CODER_ARITHMETIC;
+  U32 interleave = 0;
+  const char* only_scene = 0;
+  BOOL micro = TRUE;
+  BOOL macro = TRUE;
+
+  for (i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-n") == 0 && i+1 < argc)
+      n = (U32)atoi(argv[++i]);
+    else if (strcmp(argv[i], "-r") == 0 && i+1 < argc)
+      repeats = (U32)atoi(argv[++i]);
+    else if (strcmp(argv[i], "-scene") == 0 && i+1 < argc)
+      only_scene = argv[++i];
+    else if (strcmp(argv[i], "-coder") == 0 && i+1 < argc)
+    {
+      i++;
+      if (strcmp(argv[i], "arithmetic") == 0)
+        coder = LASZIP_CODER_ARITHMETIC;
+      else if (strcmp(argv[i], "rans") == 0)
+        coder = LASZIP_CODER_RANS;
+      else
+        usage();
+    }
+    else if (strcmp(argv[i], "-interleave") == 0 && i+1 < argc)
+      interleave = (U32)atoi(argv[++i]);
+    else if (strcmp(argv[i], "-micro") == 0)
+      macro = FALSE;
+    else if (strcmp(argv[i], "-macro") == 0)
+      micro = FALSE;
+    else
+      usage();
+  }
+  if (n < 2 || repeats < 1 || interleave > LASZIP_INTERLEAVE_CHUNKS_MAX) usage();
+
+  const char* scenes[] = { "airborne", "terrestrial", "noisy" };
+  std::vector<Sample> samples(n);
+  for (i = 0; i < 3; i++)
+  {
+    if (only_scene && strcmp(only_scene, scenes[i])) continue;
+    if (i == 0) generate_airborne(samples, n);
+    else if (i == 1) generate_terrestrial(samples, n);
+    else generate_noisy(samples, n);
+
+    report_header(scenes[i], n);
+    if (micro)
+    {
+      bench_coder<ArithmeticEncoder, ArithmeticDecoder>("arithmetic", samples, repeats);
+      bench_coder<RANSEncoder, RANSDecoder>("rANS", samples, repeats);
+      bench_integer(samples, repeats);
+      bench_items(samples, repeats);
+    }
+    if (macro)
+    {
+      bench_points(samples, repeats, coder, interleave);
+    }
+  }
+  return 0;
+}
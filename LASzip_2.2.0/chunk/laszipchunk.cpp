@@ -0,0 +1,651 @@
+/*
+===============================================================================
+
+  FILE:  laszipchunk.cpp
+
+  CONTENTS:
+
+    Rewrites a LAZ file with new chunks without changing a single point.
+    The new chunks either have a fixed number of points or end wherever
+    the points move into another cell of a square grid, so that every cell
+    of a file whose points were sorted into cells becomes a chunk of its
+    own (with cells larger than -chunk_size split and cells smaller than
+    -min_chunk merged with the next, where the chunk size defaults to the
+    usual 50000 points and the minimum to a tenth of it so that unsorted
+    points do not make a tiny chunk for every change of cell). Several
+    threads decode the chunks of the input and the chunk pool of LASzipper
+    compresses the chunks of the output on several more while the points
+    stream through in blocks, so the memory needed does not grow with the
+    file. The header, the VLRs and the EVLRs are copied with only the chunk
+    size in the LASzip VLR and the offsets that move changed.
+
+    usage: laszipchunk -i in.laz -o out.laz [-chunk_size points] [-cell size]
+                       [-min_chunk points] [-threads n]
+
+  PROGRAMMERS:
+
+    agent@local
+
+  COPYRIGHT:
+
+    (c) 2026, agent@local
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the COPYING file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    17 October 2026 -- cells are split and merged at a default chunk size unless told otherwise
+    17 October 2026 -- created to change the chunking of existing LAZ files
+
+===============================================================================
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mydefs.hpp"
+#include "laszip.hpp"
+#include "laszipper.hpp"
+#include "lasunzipper.hpp"
+
+#if defined _WIN32 && ! defined (__MINGW32__)
+extern "C" int _cdecl _fseeki64(FILE*, __int64, int);
+extern "C" __int64 _cdecl _ftelli64(FILE*);
+#endif
+
+// positions beyond 2 GB in the input and the output
+
+static BOOL seek_file(FILE* file, const I64 position)
+{
+#if defined _WIN32 && ! defined (__MINGW32__)
+  return !(_fseeki64(file, position, SEEK_SET));
+#else
+  return !(fseeko(file, (off_t)position, SEEK_SET));
+#endif
+}
+
+static I64 size_of_file(FILE* file)
+{
+#if defined _WIN32 && ! defined (__MINGW32__)
+  if (_fseeki64(file, 0, SEEK_END)) return -1;
+  return _ftelli64(file);
+#else
+  if (fseeko(file, (off_t)0, SEEK_END)) return -1;
+  return (I64)ftello(file);
+#endif
+}
+
+// the fields of the LAS header are little endian on every platform
+
+static U32 get_le(const U8* bytes, const U32 num_bytes)
+{
+  U32 value = 0;
+  for (U32 i = num_bytes; i > 0; i--) value = (value << 8) | bytes[i-1];
+  return value;
+}
+
+static I64 get_le64(const U8* bytes)
+{
+  return (I64)(((U64)get_le(bytes + 4, 4) << 32) | get_le(bytes, 4));
+}
+
+static void put_le(U8* bytes, U64 value, const U32 num_bytes)
+{
+  for (U32 i = 0; i < num_bytes; i++, value >>= 8) bytes[i] = (U8)(value & 0xFF);
+}
+
+static F64 get_f64(const U8* bytes)
+{
+  U64I64F64 u64i64f64;
+  u64i64f64.i64 = get_le64(bytes);
+  return u64i64f64.f64;
+}
+
+// decodes the chunks of a LAZ file on several threads (chunk c on thread
+// c % num_threads with a LASunzipper of its own) into blocks of points that
+// next() hands out in the order of the file. every thread queues at most
+// two blocks ahead so a huge chunk is decoded while it is being consumed.
+
+class ChunkDecoder
+{
+public:
+  ChunkDecoder();
+  ~ChunkDecoder();
+
+  BOOL open(const char* file_name, const I64 point_data, const LASzip* laszip, const U32 num_points, const U32 num_threads, const U32 block_points);
+  // the next block of points (0 once all are handed out or after an error)
+  const U8* next(U32* count);
+  void close();
+
+  U32 get_number_chunks() const { return (U32)chunk_points.size(); }
+  U32 get_chunk_summary() const { return chunk_summary; }
+  const char* get_error() const { return error.c_str(); }
+
+private:
+  struct Block
+  {
+    std::vector<U8> points;
+    U32 count;
+    U32 thread;
+  };
+  void work(const U32 thread);
+  BOOL fail(const char* err);
+
+  std::string file_name;
+  I64 point_data;
+  const LASzip* laszip;
+  U32 point_size;
+  U32 block_points;
+  U32 chunk_summary;
+  std::vector<U32> chunk_first;
+  std::vector<U32> chunk_points;
+
+  // the chunk that next() hands out and how many of its points are left
+  U32 chunk;
+  U32 chunk_left;
+  Block* current;
+
+  std::vector<std::thread> threads;
+  std::vector< std::deque<Block*> > decoded;
+  std::vector< std::deque<Block*> > spare;
+  std::vector<Block*> blocks;
+  BOOL failed;
+  BOOL stop;
+  std::string error;
+  std::mutex mutex;
+  std::condition_variable changed;
+};
+
+ChunkDecoder::ChunkDecoder()
+{
+  point_data = 0;
+  laszip = 0;
+  point_size = 0;
+  block_points = 0;
+  chunk_summary = LASZIP_CHUNK_SUMMARY_NONE;
+  chunk = 0;
+  chunk_left = 0;
+  current = 0;
+  failed = FALSE;
+  stop = FALSE;
+}
+
+ChunkDecoder::~ChunkDecoder()
+{
+  close();
+}
+
+BOOL ChunkDecoder::open(const char* file_name, const I64 point_data, const LASzip* laszip, const U32 num_points, const U32 num_threads, const U32 block_points)
+{
+  U32 c, t;
+  close();
+  failed = FALSE;
+  error.clear();
+  chunk_summary = LASZIP_CHUNK_SUMMARY_NONE;
+  this->file_name = file_name;
+  this->point_data = point_data;
+  this->laszip = laszip;
+  this->block_points = block_points;
+  point_size = 0;
+  for (c = 0; c < laszip->num_items; c++) point_size += laszip->items[c].size;
+
+  // the chunk table says where every chunk starts (and what it summarizes)
+  FILE* file = fopen(file_name, "rb");
+  if (file == 0) return fail("cannot open input file");
+  LASunzipper unzipper;
+  if (!seek_file(file, point_data) || !unzipper.open(file, laszip))
+  {
+    fclose(file);
+    return fail(unzipper.get_error() ? unzipper.get_error() : "cannot seek to point data");
+  }
+  U32 number_chunks = unzipper.get_number_chunks();
+  chunk_first.clear();
+  chunk_points.clear();
+  for (c = 0; c < number_chunks; c++)
+  {
+    U32 first, count;
+    if (!unzipper.get_chunk(c, &first, &count) || first > num_points) break;
+    // the last chunk may hold fewer points than the chunk size
+    if (count > num_points - first) count = num_points - first;
+    chunk_first.push_back(first);
+    chunk_points.push_back(count);
+  }
+  if (chunk_points.size() == 0)
+  {
+    // without a chunk table the points can only be decoded one after another
+    chunk_first.push_back(0);
+    chunk_points.push_back(num_points);
+  }
+  else
+  {
+    I32 min_xyz[3], max_xyz[3];
+    U32 counts[LASZIP_CHUNK_SUMMARY_NUM_CLASSIFICATIONS];
+    F64 min_gps_time, max_gps_time;
+    U16 min_intensity, max_intensity;
+    if (unzipper.get_chunk_bounds(0, min_xyz, max_xyz)) chunk_summary |= LASZIP_CHUNK_SUMMARY_XYZ_BOUNDS;
+    if (unzipper.get_chunk_classifications(0, counts)) chunk_summary |= LASZIP_CHUNK_SUMMARY_CLASSIFICATIONS;
+    if (unzipper.get_chunk_return_numbers(0, counts)) chunk_summary |= LASZIP_CHUNK_SUMMARY_RETURN_NUMBERS;
+    if (unzipper.get_chunk_gps_time(0, &min_gps_time, &max_gps_time)) chunk_summary |= LASZIP_CHUNK_SUMMARY_GPS_TIME;
+    if (unzipper.get_chunk_intensity(0, &min_intensity, &max_intensity)) chunk_summary |= LASZIP_CHUNK_SUMMARY_INTENSITY;
+  }
+  unzipper.close();
+  fclose(file);
+
+  // skip empty chunks
+  chunk = 0;
+  while (chunk < chunk_points.size() && chunk_points[chunk] == 0) chunk++;
+  chunk_left = (chunk < chunk_points.size() ? chunk_points[chunk] : 0);
+
+  // one block for the decoder, two for the queue and one for the caller
+  U32 used_threads = (num_threads < chunk_points.size() ? num_threads : (U32)chunk_points.size());
+  if (used_threads == 0) used_threads = 1;
+  decoded.assign(used_threads, std::deque<Block*>());
+  spare.assign(used_threads, std::deque<Block*>());
+  for (t = 0; t < used_threads; t++)
+  {
+    for (c = 0; c < 4; c++)
+    {
+      Block* block = new Block;
+      block->count = 0;
+      block->thread = t;
+      blocks.push_back(block);
+      spare[t].push_back(block);
+    }
+  }
+  for (t = 0; t < used_threads; t++)
+  {
+    threads.push_back(std::thread(&ChunkDecoder::work, this, t));
+  }
+  return TRUE;
+}
+
+void ChunkDecoder::work(const U32 thread)
+{
+  U32 num_threads = (U32)decoded.size();
+  FILE* file = fopen(file_name.c_str(), "rb");
+  LASunzipper unzipper;
+  if (file == 0 || !seek_file(file, point_data) || !unzipper.open(file, laszip))
+  {
+    if (file) fclose(file);
+    std::lock_guard<std::mutex> lock(mutex);
+    fail("cannot open input file on decoding thread");
+    return;
+  }
+  for (U32 c = thread; c < chunk_points.size(); c += num_threads)
+  {
+    U32 left = chunk_points[c];
+    if (left && !unzipper.seek(chunk_first[c]))
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      fail(unzipper.get_error());
+      break;
+    }
+    while (left)
+    {
+      Block* block;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this, thread] { return stop || !spare[thread].empty(); });
+        if (stop) break;
+        block = spare[thread].front();
+        spare[thread].pop_front();
+      }
+      U32 count = (left < block_points ? left : block_points);
+      if (block->points.size() < (size_t)block_points*point_size) block->points.resize((size_t)block_points*point_size);
+      block->count = unzipper.read_batch(&block->points[0], count, point_size);
+      std::lock_guard<std::mutex> lock(mutex);
+      if (block->count != count)
+      {
+        fail("input file is truncated");
+        break;
+      }
+      decoded[thread].push_back(block);
+      changed.notify_all();
+      left -= count;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    if (stop) break;
+  }
+  unzipper.close();
+  fclose(file);
+}
+
+BOOL ChunkDecoder::fail(const char* err)
+{
+  // called with the mutex locked by the decoding threads
+  if (!failed) error = (err ? err : "unknown error");
+  failed = TRUE;
+  stop = TRUE;
+  changed.notify_all();
+  return FALSE;
+}
+
+const U8* ChunkDecoder::next(U32* count)
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  if (current)
+  {
+    spare[current->thread].push_back(current);
+    current = 0;
+    changed.notify_all();
+  }
+  if (chunk_left == 0 || failed) return 0;
+  U32 thread = chunk % decoded.size();
+  changed.wait(lock, [this, thread] { return failed || !decoded[thread].empty(); });
+  if (failed) return 0;
+  current = decoded[thread].front();
+  decoded[thread].pop_front();
+  chunk_left -= current->count;
+  if (chunk_left == 0)
+  {
+    chunk++;
+    while (chunk < chunk_points.size() && chunk_points[chunk] == 0) chunk++;
+    chunk_left = (chunk < chunk_points.size() ? chunk_points[chunk] : 0);
+  }
+  *count = current->count;
+  return &current->points[0];
+}
+
+void ChunkDecoder::close()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stop = TRUE;
+    changed.notify_all();
+  }
+  for (size_t t = 0; t < threads.size(); t++) threads[t].join();
+  threads.clear();
+  for (size_t b = 0; b < blocks.size(); b++) delete blocks[b];
+  blocks.clear();
+  decoded.clear();
+  spare.clear();
+  current = 0;
+  stop = FALSE;
+}
+
+// the parts of the LAS header that rechunking reads or changes
+
+struct Header
+{
+  U8 version_minor;
+  U32 header_size;
+  U32 offset_to_point_data;
+  U32 number_of_vlrs;
+  U32 number_of_points;
+  F64 scale[2];
+  F64 offset[2];
+  // where the LASzip VLR is and how long its data is
+  U32 laszip_vlr;
+  U32 laszip_length;
+  // where the points end and what follows them (the EVLRs) begins
+  I64 point_data_end;
+};
+
+static BOOL read_header(FILE* file, std::vector<U8>& vlrs, Header& header, const char** error)
+{
+  U8 bytes[227];
+  *error = "input is not a LAS file";
+  if (fread(bytes, 1, 227, file) != 227 || strncmp((const char*)bytes, "LASF", 4)) return FALSE;
+  header.version_minor = bytes[25];
+  header.header_size = get_le(bytes + 94, 2);
+  header.offset_to_point_data = get_le(bytes + 96, 4);
+  header.number_of_vlrs = get_le(bytes + 100, 4);
+  if (header.header_size < 227 || header.offset_to_point_data < header.header_size) return FALSE;
+
+  // the header and the VLRs (and whatever follows them) up to the points
+  vlrs.resize(header.offset_to_point_data);
+  if (!seek_file(file, 0) || fread(&vlrs[0], 1, vlrs.size(), file) != vlrs.size()) return FALSE;
+  const U8* h = &vlrs[0];
+  header.number_of_points = get_le(h + 107, 4);
+  header.scale[0] = get_f64(h + 131);
+  header.scale[1] = get_f64(h + 139);
+  header.offset[0] = get_f64(h + 155);
+  header.offset[1] = get_f64(h + 163);
+
+  I64 file_size = size_of_file(file);
+  header.point_data_end = file_size;
+  if (header.version_minor >= 3 && header.header_size >= 235)
+  {
+    // the waveform data packets stored inside the file follow the points
+    I64 start_of_waveform_data = get_le64(h + 227);
+    if (start_of_waveform_data > (I64)header.offset_to_point_data && start_of_waveform_data < header.point_data_end) header.point_data_end = start_of_waveform_data;
+  }
+  if (header.version_minor >= 4 && header.header_size >= 255)
+  {
+    I64 start_of_first_evlr = get_le64(h + 235);
+    U32 number_of_evlrs = get_le(h + 243, 4);
+    if (number_of_evlrs && start_of_first_evlr > (I64)header.offset_to_point_data && start_of_first_evlr < header.point_data_end) header.point_data_end = start_of_first_evlr;
+    if (header.number_of_points == 0)
+    {
+      I64 number_of_points = get_le64(h + 247);
+      *error = "LASzip cannot handle more than 4294967295 points";
+      if (number_of_points > (I64)U32_MAX) return FALSE;
+      header.number_of_points = (U32)number_of_points;
+    }
+  }
+
+  // find the LASzip VLR
+  *error = "input has no LASzip VLR (is it a LAZ file?)";
+  U32 position = header.header_size;
+  header.laszip_vlr = 0;
+  header.laszip_length = 0;
+  for (U32 i = 0; i < header.number_of_vlrs && position + 54 <= header.offset_to_point_data; i++)
+  {
+    U32 record_id = get_le(h + position + 18, 2);
+    U32 record_length = get_le(h + position + 20, 2);
+    if (record_id == 22204 && strncmp((const char*)h + position + 2, "laszip encoded", 16) == 0)
+    {
+      header.laszip_vlr = position;
+      header.laszip_length = record_length;
+    }
+    position += 54 + record_length;
+  }
+  if (header.laszip_vlr == 0 || header.laszip_vlr + 54 + header.laszip_length > header.offset_to_point_data) return FALSE;
+  return TRUE;
+}
+
+// the header, the VLRs and the EVLRs of the output are those of the input
+// with another LASzip VLR and with the offsets that this moves
+
+static BOOL write_vlrs(FILE* file, std::vector<U8>& vlrs, const Header& header, const U8* laszip_bytes, const U32 laszip_length)
+{
+  std::vector<U8> out(vlrs.begin(), vlrs.begin() + header.laszip_vlr + 54);
+  out.insert(out.end(), laszip_bytes, laszip_bytes + laszip_length);
+  out.insert(out.end(), vlrs.begin() + header.laszip_vlr + 54 + header.laszip_length, vlrs.end());
+  put_le(&out[header.laszip_vlr + 20], laszip_length, 2);
+  put_le(&out[96], out.size(), 4);
+  vlrs.swap(out);
+  return (fwrite(&vlrs[0], 1, vlrs.size(), file) == vlrs.size());
+}
+
+static BOOL copy_bytes(FILE* in, const I64 from, const I64 to, FILE* out)
+{
+  std::vector<U8> buffer(1 << 20);
+  if (!seek_file(in, from)) return FALSE;
+  for (I64 left = to - from; left > 0;)
+  {
+    size_t num = (size_t)(left < (I64)buffer.size() ? left : (I64)buffer.size());
+    if (fread(&buffer[0], 1, num, in) != num || fwrite(&buffer[0], 1, num, out) != num) return FALSE;
+    left -= num;
+  }
+  return TRUE;
+}
+
+static BOOL shift_offset(FILE* out, const std::vector<U8>& vlrs, const U32 field, const I64 old_end, const I64 new_end)
+{
+  // only positions behind the points move
+  I64 position = get_le64(&vlrs[field]);
+  if (position < old_end) return TRUE;
+  U8 bytes[8];
+  put_le(bytes, (U64)(position - old_end + new_end), 8);
+  return seek_file(out, field) && (fwrite(bytes, 1, 8, out) == 8);
+}
+
+static void usage()
+{
+  fprintf(stderr, "usage: laszipchunk -i in.laz -o out.laz [-chunk_size points] [-cell size] [-min_chunk points] [-threads n]\n");
+  exit(1);
+}
+
+static int fail(const char* message, const char* reason=0)
+{
+  if (reason) fprintf(stderr, "ERROR: %s: %s\n", message, reason);
+  else fprintf(stderr, "ERROR: %s\n", message);
+  return 1;
+}
+
+int main(int argc, char* argv[])
+{
+  int i;
+  const char* file_name_in = 0;
+  const char* file_name_out = 0;
+  U32 chunk_size = LASZIP_CHUNK_SIZE_DEFAULT;
+  F64 cell_size = 0.0;
+  U32 min_chunk = U32_MAX;
+  U32 num_threads = std::thread::hardware_concurrency();
+  U32 block_points = 65536;
+
+  for (i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-i") == 0 && i+1 < argc)
+      file_name_in = argv[++i];
+    else if (strcmp(argv[i], "-o") == 0 && i+1 < argc)
+      file_name_out = argv[++i];
+    else if (strcmp(argv[i], "-chunk_size") == 0 && i+1 < argc)
+      chunk_size = (U32)atoi(argv[++i]);
+    else if (strcmp(argv[i], "-cell") == 0 && i+1 < argc)
+      cell_size = atof(argv[++i]);
+    else if (strcmp(argv[i], "-min_chunk") == 0 && i+1 < argc)
+      min_chunk = (U32)atoi(argv[++i]);
+    else if (strcmp(argv[i], "-threads") == 0 && i+1 < argc)
+      num_threads = (U32)atoi(argv[++i]);
+    else
+      usage();
+  }
+  if (file_name_in == 0 || file_name_out == 0 || chunk_size == 0 || cell_size < 0.0) usage();
+  if (strcmp(file_name_in, file_name_out) == 0) return fail("input and output must be different files");
+  if (num_threads == 0) num_threads = 1;
+  // a tenth of the chunk size keeps unsorted points from making tiny chunks
+  if (min_chunk == U32_MAX) min_chunk = chunk_size / 10;
+  if (min_chunk > chunk_size) min_chunk = chunk_size;
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+  FILE* in = fopen(file_name_in, "rb");
+  if (in == 0) return fail("cannot open input file", file_name_in);
+  std::vector<U8> vlrs;
+  Header header;
+  const char* error;
+  if (!read_header(in, vlrs, header, &error)) return fail(error, file_name_in);
+
+  LASzip laszip_in;
+  if (!laszip_in.unpack(&vlrs[header.laszip_vlr + 54], header.laszip_length)) return fail("cannot unpack LASzip VLR", laszip_in.get_error());
+
+  // the same items, versions and coder but other chunks
+  LASzip laszip_out;
+  laszip_out.unpack(&vlrs[header.laszip_vlr + 54], header.laszip_length);
+  if (laszip_out.compressor == LASZIP_COMPRESSOR_POINTWISE) laszip_out.compressor = LASZIP_COMPRESSOR_CHUNKED;
+  laszip_out.set_chunk_size(cell_size > 0.0 ? U32_MAX : chunk_size);
+  U8* laszip_bytes;
+  I32 laszip_length;
+  if (!laszip_out.pack(laszip_bytes, laszip_length)) return fail("cannot pack LASzip VLR", laszip_out.get_error());
+
+  ChunkDecoder decoder;
+  if (!decoder.open(file_name_in, header.offset_to_point_data, &laszip_in, header.number_of_points, num_threads, block_points)) return fail("cannot decode input", decoder.get_error());
+
+  FILE* out = fopen(file_name_out, "wb");
+  if (out == 0) return fail("cannot open output file", file_name_out);
+  if (!write_vlrs(out, vlrs, header, laszip_bytes, (U32)laszip_length)) return fail("cannot write header", file_name_out);
+
+  LASzipper zipper;
+  zipper.set_threads(num_threads);
+  if (decoder.get_chunk_summary()) zipper.set_chunk_summary(decoder.get_chunk_summary());
+  if (!zipper.open(out, &laszip_out)) return fail("cannot compress output", zipper.get_error());
+
+  std::vector<U32> item_offsets(laszip_out.num_items);
+  U32 point_size = 0;
+  for (i = 0; i < laszip_out.num_items; i++)
+  {
+    item_offsets[i] = point_size;
+    point_size += laszip_out.items[i].size;
+  }
+  std::vector<U8*> point(laszip_out.num_items);
+
+  // in cells a chunk ends where a point is in another cell than the one
+  // before (once it has min_chunk points) or where it has chunk_size points
+  U32 chunk_count = 0;
+  U32 number_chunks = 0;
+  U32 num_points = 0;
+  I64 cell_x = 0, cell_y = 0;
+  const U8* points;
+  U32 count;
+  while ((points = decoder.next(&count)))
+  {
+    for (U32 p = 0; p < count; p++)
+    {
+      U8* data = (U8*)points + (size_t)p*point_size;
+      if (cell_size > 0.0)
+      {
+        I32 xy[2];
+        memcpy(xy, data, sizeof(xy));
+        I64 x = (I64)floor((header.scale[0]*xy[0] + header.offset[0]) / cell_size);
+        I64 y = (I64)floor((header.scale[1]*xy[1] + header.offset[1]) / cell_size);
+        if (chunk_count && (chunk_count == chunk_size || ((x != cell_x || y != cell_y) && chunk_count >= min_chunk)))
+        {
+          if (!zipper.chunk()) return fail("cannot end chunk", zipper.get_error());
+          number_chunks++;
+          chunk_count = 0;
+        }
+        cell_x = x;
+        cell_y = y;
+      }
+      for (i = 0; i < laszip_out.num_items; i++) point[i] = data + item_offsets[i];
+      if (!zipper.write(&point[0])) return fail("cannot compress point", zipper.get_error());
+      chunk_count++;
+      num_points++;
+    }
+  }
+  if (num_points != header.number_of_points) return fail("cannot decode input", decoder.get_error());
+  if (!zipper.close()) return fail("cannot finish output", zipper.get_error());
+  if (cell_size > 0.0) number_chunks += (chunk_count ? 1 : 0);
+  else number_chunks = (num_points + chunk_size - 1) / chunk_size;
+
+  // the EVLRs (or waveform data packets) that followed the points
+  I64 point_data_end = size_of_file(out);
+  I64 file_size = size_of_file(in);
+  if (!copy_bytes(in, header.point_data_end, file_size, out)) return fail("cannot copy EVLRs", file_name_out);
+  if (header.version_minor >= 3 && header.header_size >= 235)
+  {
+    if (!shift_offset(out, vlrs, 227, header.point_data_end, point_data_end)) return fail("cannot update header", file_name_out);
+  }
+  if (header.version_minor >= 4 && header.header_size >= 255)
+  {
+    if (!shift_offset(out, vlrs, 235, header.point_data_end, point_data_end)) return fail("cannot update header", file_name_out);
+  }
+  decoder.close();
+  fclose(in);
+  if (fclose(out)) return fail("cannot close output file", file_name_out);
+
+  // points that are not sorted into cells change cells all the time
+  if ((cell_size > 0.0) && (min_chunk < chunk_size / 10) && (number_chunks > 1) && (num_points / number_chunks < chunk_size / 10))
+  {
+    fprintf(stderr, "WARNING: chunks have only %u points on average. are the points sorted into cells of size %g?\n", num_points / number_chunks, cell_size);
+  }
+  fprintf(stderr, "rechunked %u points from %u into %u chunks with %u threads in %.2f seconds\n", num_points, decoder.get_number_chunks(), number_chunks, num_threads, std::chrono::duration<F64>(std::chrono::steady_clock::now() - start).count());
+  return 0;
+}
@@ -77,28 +77,113 @@
 ArithmeticDecoder::ArithmeticDecoder()
 {
   instream = 0;
+  arena = new ArithmeticModelArena();
+  window_start = 0;
+  window_curr = 0;
+  window_end = 0;
+}
+
+inline U32 ArithmeticDecoder::getByte()
+{
+  // buffered streams are read without a virtual call or an exception check
+  if (window_curr < window_end) return *window_curr++;
+  return getByteRefill();
+}
+
+U32 ArithmeticDecoder::getByteRefill()
+{
+  if (window_start)
+  {
+    syncWindow();
+    U32 num_bytes = instream->getWindow(&window_start);
+    if (num_bytes)
+    {
+      window_curr = window_start;
+      window_end = window_start + num_bytes;
+      return *window_curr++;
+    }
+    window_start = 0;
+  }
+  // the stream throws at its end
+  return instream->getByte();
+}
+
+void ArithmeticDecoder::syncWindow()
+{
+  // tell the stream how far we have read so it can be used again
+  instream->skipWindow((U32)(window_curr - window_start));
+  window_start = 0;
+  window_curr = 0;
+  window_end = 0;
 }
 
 BOOL ArithmeticDecoder::init(ByteStreamIn* instream)
 {
   if (instream == 0) return FALSE;
+  if (window_start) syncWindow();
   this->instream = instream;
+  U32 num_bytes = instream->getWindow(&window_start);
+  window_curr = window_start;
+  window_end = window_start + num_bytes;
+  if (num_bytes == 0) window_start = 0;
   length = AC__MaxLength;
-  value = (instream->getByte() << 24);
-  value |= (instream->getByte() << 16);
-  value |= (instream->getByte() << 8);
-  value |= (instream->getByte());
+  value = (getByte() << 24);
+  value |= (getByte() << 16);
+  value |= (getByte() << 8);
+  value |= (getByte());
   return TRUE;
 }
 
 void ArithmeticDecoder::done()
 {
+  if (window_start) syncWindow();
   instream = 0;
+}
+
+I64 ArithmeticDecoder::tell() const
+{
+  // the stream only moves past its window once the window is skipped
+  if (window_start) return instream->tell() + (window_curr - window_start);
+  return instream->tell();
+}
+
+U32 ArithmeticDecoder::getStateSize() const
+{
+  return 2*sizeof(U32) + sizeof(I64) + arena->getStateSize();
+}
+
+U8* ArithmeticDecoder::saveState(U8* state) const
+{
+  // the position in the stream of the next byte to be read
+  I64 position = instream->tell();
+  if (window_start) position += (window_curr - window_start);
+  memcpy(state, &value, sizeof(U32)); state += sizeof(U32);
+  memcpy(state, &length, sizeof(U32)); state += sizeof(U32);
+  memcpy(state, &position, sizeof(I64)); state += sizeof(I64);
+  return arena->saveState(state);
+}
+
+const U8* ArithmeticDecoder::restoreState(const U8* state)
+{
+  I64 position;
+  memcpy(&value, state, sizeof(U32)); state += sizeof(U32);
+  memcpy(&length, state, sizeof(U32)); state += sizeof(U32);
+  memcpy(&position, state, sizeof(I64)); state += sizeof(I64);
+  // the window is dropped without syncing as the stream is repositioned
+  window_start = 0;
+  window_curr = 0;
+  window_end = 0;
+  if (!instream->seek(position)) return 0;
+  U32 num_bytes = instream->getWindow(&window_start);
+  window_curr = window_start;
+  window_end = window_start + num_bytes;
+  if (num_bytes == 0) window_start = 0;
+  return arena->restoreState(state);
 }
 
 EntropyModel* ArithmeticDecoder::createBitModel()
 {
-  ArithmeticBitModel* m = new ArithmeticBitModel();
+  ArithmeticBitModel* m = arena->createBitModel();
   return (EntropyModel*)m;
 }
 
@@ -111,12 +196,12 @@ void ArithmeticDecoder::initBitModel(EntropyModel* model)
 void ArithmeticDecoder::destroyBitModel(EntropyModel* model)
 {
   ArithmeticBitModel* m = (ArithmeticBitModel*)model;
-  delete m;
+  arena->destroyBitModel(m);
 }
 
 EntropyModel* ArithmeticDecoder::createSymbolModel(U32 n)
 {
-  ArithmeticModel* m = new ArithmeticModel(n, false);
+  ArithmeticModel* m = arena->createSymbolModel(n, false);
   return (EntropyModel*)m;
 }
 
@@ -129,7 +214,7 @@ void ArithmeticDecoder::initSymbolModel(EntropyModel* model, U32 *table)
 void ArithmeticDecoder::destroySymbolModel(EntropyModel* model)
 {
   ArithmeticModel* m = (ArithmeticModel*)model;
-  delete m;
+  arena->destroySymbolModel(m);
 }
 
 U32 ArithmeticDecoder::decodeBit(EntropyModel* model)
@@ -168,11 +253,11 @@ U32 ArithmeticDecoder::decodeSymbol(EntropyModel* model)
 
     while (n > sym + 1) {                      // finish with bisection search
       U32 k = (sym + n) >> 1;
-      if (m->distribution[k] > dv) n = k; else sym = k;
+      if (m->entries[k].distribution > dv) n = k; else sym = k;
     }
                                                            // compute products
-    x = m->distribution[sym] * length;
-    if (sym != m->last_symbol) y = m->distribution[sym+1] * length;
+    x = m->entries[sym].distribution * length;
+    if (sym != m->last_symbol) y = m->entries[sym+1].distribution * length;
   }
 
   else {                                  // decode using only multiplications
@@ -182,7 +267,7 @@ U32 ArithmeticDecoder::decodeSymbol(EntropyModel* model)
     U32 k = (n = m->symbols) >> 1;
                                                 // decode via bisection search
     do {
-      U32 z = length * m->distribution[k];
+      U32 z = length * m->entries[k].distribution;
       if (z > value) {
         n = k;
         y = z;                                             // value is smaller
@@ -199,7 +284,7 @@ U32 ArithmeticDecoder::decodeSymbol(EntropyModel* model)
 
   if (length < AC__MinLength) renorm_dec_interval();        // renormalization
 
-  ++m->symbol_count[sym];
+  ++m->entries[sym].symbol_count;
   if (--m->symbols_until_update == 0) m->update();    // periodic model update
 
   return sym;
@@ -289,12 +374,12 @@ inline F64 ArithmeticDecoder::readDouble() /* danger in float reinterpretation *
 
 ArithmeticDecoder::~ArithmeticDecoder()
 {
-
+  delete arena;
 }
 
 inline void ArithmeticDecoder::renorm_dec_interval()
 {
   do {                                          // read least-significant byte
-    value = (value << 8) | instream->getByte();
+    value = (value << 8) | getByte();
   } while ((length <<= 8) < AC__MinLength);        // length multiplied by 256
 }
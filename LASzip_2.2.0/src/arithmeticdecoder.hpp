@@ -25,6 +25,10 @@
   
   CHANGE HISTORY:
   
+    17 October 2026 -- tell() includes what was read through the stream's window
+    17 October 2026 -- state is saved and restored with the models of the arena
+    17 October 2026 -- models are allocated from an arena owned by the decoder
+    17 October 2026 -- read bytes through a pointer when the stream is buffered
     10 January 2011 -- licensing change for LGPL release and liblas integration
     8 December 2010 -- unified framework for all entropy coders
     30 October 2009 -- refactoring Amir Said's FastAC code
@@ -36,6 +40,8 @@
 
 #include "entropydecoder.hpp"
 
+class ArithmeticModelArena;
+
 class ArithmeticDecoder : public EntropyDecoder
 {
 public:
@@ -47,6 +53,14 @@ public:
 /* Manage decoding                                           */
   BOOL init(ByteStreamIn* instream);
   void done();
+
+/* Position in the stream of the next byte to be decoded     */
+  I64 tell() const;
+
+/* Save and restore the decoding state including all models  */
+  U32 getStateSize() const;
+  U8* saveState(U8* state) const;
+  const U8* restoreState(const U8* state);
 
 /* Manage an entropy model for a single bit                  */
   EntropyModel* createBitModel();
@@ -91,6 +105,15 @@ public:
 private:
 
   ByteStreamIn* instream;
+  ArithmeticModelArena* arena;
+
+  // bytes of the stream's window not yet consumed (if it has one)
+  const U8* window_start;
+  const U8* window_curr;
+  const U8* window_end;
+  U32 getByte();
+  U32 getByteRefill();
+  void syncWindow();
 
   void renorm_dec_interval();
   U32 base, value, length;
@@ -71,6 +71,7 @@
 
 #include <string.h>
 #include <assert.h>
+#include <math.h>
 
 #include <stdio.h>
 
@@ -81,6 +82,7 @@ FILE* file = 0;
 ArithmeticEncoder::ArithmeticEncoder()
 {
   outstream = 0;
+  arena = new ArithmeticModelArena();
 
   outbuffer = (U8*)malloc(sizeof(U8)*2*AC_BUFFER_SIZE);
   endbuffer = outbuffer + 2 * AC_BUFFER_SIZE;
@@ -89,6 +91,7 @@ ArithmeticEncoder::ArithmeticEncoder()
 ArithmeticEncoder::~ArithmeticEncoder()
 {
   free(outbuffer);
+  delete arena;
 }
 
 BOOL ArithmeticEncoder::init(ByteStreamOut* outstream)
@@ -99,10 +102,24 @@ BOOL ArithmeticEncoder::init(ByteStreamOut* outstream)
   length = AC__MaxLength;
   outbyte = outbuffer;
   endbyte = endbuffer;
+  flushed = 0;
   return TRUE;
+}
+
+I64 ArithmeticEncoder::tell() const
+{
+  // one half of the buffer lags behind for carries and the other is being filled
+  return outstream->tell() + 2 * AC_BUFFER_SIZE - (endbyte - outbyte);
+}
+
+F64 ArithmeticEncoder::tellBits() const
+{
+  // every bit that the interval has lost since it was last renormalized was spent
+  I64 bytes = flushed + 2 * AC_BUFFER_SIZE - (endbyte - outbyte);
+  return 8.0 * bytes + 32.0 - log((F64)length) / log(2.0);
 }
 
-void ArithmeticEncoder::done()
+BOOL ArithmeticEncoder::done()
 {
   U32 init_base = base;                 // done encoding: set final data bytes
   BOOL another_byte = TRUE;
@@ -134,11 +151,12 @@ void ArithmeticEncoder::done()
   if (another_byte) outstream->putByte(0);
 
   outstream = 0;
+  return TRUE;
 }
 
 EntropyModel* ArithmeticEncoder::createBitModel()
 {
-  ArithmeticBitModel* m = new ArithmeticBitModel();
+  ArithmeticBitModel* m = arena->createBitModel();
   return (EntropyModel*)m;
 }
 
@@ -151,12 +169,12 @@ void ArithmeticEncoder::initBitModel(EntropyModel* model)
 void ArithmeticEncoder::destroyBitModel(EntropyModel* model)
 {
   ArithmeticBitModel* m = (ArithmeticBitModel*)model;
-  delete m;
+  arena->destroyBitModel(m);
 }
 
 EntropyModel* ArithmeticEncoder::createSymbolModel(U32 n)
 {
-  ArithmeticModel* m = new ArithmeticModel(n, true);
+  ArithmeticModel* m = arena->createSymbolModel(n, true);
   return (EntropyModel*)m;
 }
 
@@ -169,7 +187,7 @@ void ArithmeticEncoder::initSymbolModel(EntropyModel* model, U32* table)
 void ArithmeticEncoder::destroySymbolModel(EntropyModel* model)
 {
   ArithmeticModel* m = (ArithmeticModel*)model;
-  delete m;
+  arena->destroySymbolModel(m);
 }
 
 void ArithmeticEncoder::encodeBit(EntropyModel* model, U32 sym)
@@ -202,20 +220,20 @@ void ArithmeticEncoder::encodeSymbol(EntropyModel* model, U32 sym)
   U32 x, init_base = base;
                                                            // compute products
   if (sym == m->last_symbol) {
-    x = m->distribution[sym] * (length >> DM__LengthShift);
+    x = m->entries[sym].distribution * (length >> DM__LengthShift);
     base   += x;                                            // update interval
     length -= x;                                          // no product needed
   }
   else {
-    x = m->distribution[sym] * (length >>= DM__LengthShift);
+    x = m->entries[sym].distribution * (length >>= DM__LengthShift);
     base   += x;                                            // update interval
-    length  = m->distribution[sym+1] * length - x;
+    length  = m->entries[sym+1].distribution * length - x;
   }
 
   if (init_base > base) propagate_carry();                 // overflow = carry
   if (length < AC__MinLength) renorm_enc_interval();        // renormalization
 
-  ++m->symbol_count[sym];
+  ++m->entries[sym].symbol_count;
   if (--m->symbols_until_update == 0) m->update();    // periodic model update
 }
 
@@ -329,6 +347,7 @@ inline void ArithmeticEncoder::manage_outbuffer()
 {
   if (outbyte == endbuffer) outbyte = outbuffer;
   outstream->putBytes(outbyte, AC_BUFFER_SIZE);
+  flushed += AC_BUFFER_SIZE;
   endbyte = outbyte + AC_BUFFER_SIZE;
   assert(endbyte > outbyte);
   assert(outbyte < endbuffer);    
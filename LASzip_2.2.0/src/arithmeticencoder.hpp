@@ -25,6 +25,9 @@
   
   CHANGE HISTORY:
   
+    17 October 2026 -- tellBits() with the fraction of a bit the interval holds
+    17 October 2026 -- tell() includes the bytes still held in the buffer
+    17 October 2026 -- models are allocated from an arena owned by the encoder
     10 January 2011 -- licensing change for LGPL release and liblas integration
     8 December 2010 -- unified framework for all entropy coders
     30 October 2009 -- refactoring Amir Said's FastAC code
@@ -36,6 +39,8 @@
 
 #include "entropyencoder.hpp"
 
+class ArithmeticModelArena;
+
 class ArithmeticEncoder : public EntropyEncoder
 {
 public:
@@ -46,7 +51,13 @@ public:
 
 /* Manage encoding                                           */
   BOOL init(ByteStreamOut* outstream);
-  void done();
+  BOOL done();
+
+/* Position in the stream that the encoded bytes reach       */
+  I64 tell() const;
+
+/* Bits the encoding has used since init (with fractions)    */
+  F64 tellBits() const;
 
 /* Manage an entropy model for a single bit                  */
   EntropyModel* createBitModel();
@@ -91,6 +102,7 @@ public:
 private:
 
   ByteStreamOut* outstream;
+  ArithmeticModelArena* arena;
 
   void propagate_carry();
   void renorm_enc_interval();
@@ -99,6 +111,7 @@ private:
   U8* endbuffer;
   U8* outbyte;
   U8* endbyte;
+  I64 flushed;
   U32 base, value, length;
 };
 
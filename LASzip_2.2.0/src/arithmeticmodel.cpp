@@ -71,22 +71,43 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
-ArithmeticModel::ArithmeticModel(U32 symbols, BOOL compress)
+#include <mutex>
+#include <new>
+
+ArithmeticModel::ArithmeticModel(U32 symbols, BOOL compress, U32* memory)
 {
   this->symbols = symbols;
   this->compress = compress;
-  distribution = 0;
+  this->memory = memory;
+  pristine = 0;
+  entries = 0;
 }
 
 ArithmeticModel::~ArithmeticModel()
 {
-  if (distribution) delete [] distribution;
+  if (entries && ((U32*)entries != memory)) delete [] (U32*)entries;
+}
+
+U32 ArithmeticModel::get_table_size(U32 symbols, BOOL compress)
+{
+  if ( (symbols < 2) || (symbols > (1 << 11)) )
+  {
+    return 0;
+  }
+  if ((!compress) && (symbols > 16))
+  {
+    U32 table_bits = 3;
+    while (symbols > (1U << (table_bits + 2))) ++table_bits;
+    return 2*symbols+(1 << table_bits)+2;
+  }
+  return 2*symbols;
 }
 
 I32 ArithmeticModel::init(U32* table)
 {
-  if (distribution == 0)
+  if (entries == 0)
   {
     if ( (symbols < 2) || (symbols > (1 << 11)) )
     {
@@ -99,28 +120,37 @@ I32 ArithmeticModel::init(U32* table)
       while (symbols > (1U << (table_bits + 2))) ++table_bits;
       table_size  = 1 << table_bits;
       table_shift = DM__LengthShift - table_bits;
-      distribution = new U32[2*symbols+table_size+2];
-      decoder_table = distribution + 2 * symbols;
+      entries = (ArithmeticModelEntry*)(memory ? memory : new U32[2*symbols+table_size+2]);
+      decoder_table = (U32*)(entries + symbols);
     }
     else // small alphabet: no table needed
     {                                  
       decoder_table = 0;
       table_size = table_shift = 0;
-      distribution = new U32[2*symbols];
+      entries = (ArithmeticModelEntry*)(memory ? memory : new U32[2*symbols]);
     }
-    if (distribution == 0)
+    if (entries == 0)
     {
       return -1; // "cannot allocate model memory");
     }
-    symbol_count = distribution + symbols;
+  }
+
+  // at chunk boundaries copying the initial state beats recomputing it
+  if ((table == 0) && pristine)
+  {
+    total_count = pristine->total_count;
+    update_cycle = pristine->update_cycle;
+    symbols_until_update = pristine->symbols_until_update;
+    memcpy(entries, pristine->entries, sizeof(U32)*get_table_size(symbols, compress));
+    return 0;
   }
 
   total_count = 0;
   update_cycle = symbols;
   if (table)
-    for (U32 k = 0; k < symbols; k++) symbol_count[k] = table[k];
+    for (U32 k = 0; k < symbols; k++) entries[k].symbol_count = table[k];
   else
-    for (U32 k = 0; k < symbols; k++) symbol_count[k] = 1;
+    for (U32 k = 0; k < symbols; k++) entries[k].symbol_count = 1;
 
   update();
   symbols_until_update = update_cycle = (symbols + 6) >> 1;
@@ -136,7 +166,7 @@ void ArithmeticModel::update()
     total_count = 0;
     for (U32 n = 0; n < symbols; n++)
     {
-      total_count += (symbol_count[n] = (symbol_count[n] + 1) >> 1);
+      total_count += (entries[n].symbol_count = (entries[n].symbol_count + 1) >> 1);
     }
   }
   
@@ -148,17 +178,17 @@ void ArithmeticModel::update()
   {
     for (k = 0; k < symbols; k++)
     {
-      distribution[k] = (scale * sum) >> (31 - DM__LengthShift);
-      sum += symbol_count[k];
+      entries[k].distribution = (scale * sum) >> (31 - DM__LengthShift);
+      sum += entries[k].symbol_count;
     }
   }
   else
   {
     for (k = 0; k < symbols; k++)
     {
-      distribution[k] = (scale * sum) >> (31 - DM__LengthShift);
-      sum += symbol_count[k];
-      U32 w = distribution[k] >> table_shift;
+      entries[k].distribution = (scale * sum) >> (31 - DM__LengthShift);
+      sum += entries[k].symbol_count;
+      U32 w = entries[k].distribution >> table_shift;
       while (s < w) decoder_table[++s] = k - 1;
     }
     decoder_table[0] = 0;
@@ -210,3 +240,203 @@ void ArithmeticBitModel::update()
   if (update_cycle > 64) update_cycle = 64;
   bits_until_update = update_cycle;
 }
+
+// blocks of finished arenas are kept for the next ones (up to 32 MB)
+#define AC_ARENA_ALIGNMENT 64
+#define AC_ARENA_BLOCK_SIZE 65536
+#define AC_ARENA_MAX_CACHED_BLOCKS 512
+
+static std::mutex arena_cache_mutex;
+static void* arena_cache = 0;
+static U32 arena_cache_blocks = 0;
+
+static inline U32 arena_round(U32 size)
+{
+  return (size + (AC_ARENA_ALIGNMENT - 1)) & ~(AC_ARENA_ALIGNMENT - 1);
+}
+
+ArithmeticModelArena::ArithmeticModelArena()
+{
+  blocks = 0;
+  current = 0;
+  pristines = 0;
+  curr = 0;
+  end = 0;
+}
+
+ArithmeticModelArena::~ArithmeticModelArena()
+{
+  while (blocks)
+  {
+    Block* block = blocks;
+    blocks = block->next;
+    if (block->size == AC_ARENA_BLOCK_SIZE)
+    {
+      std::lock_guard<std::mutex> lock(arena_cache_mutex);
+      if (arena_cache_blocks < AC_ARENA_MAX_CACHED_BLOCKS)
+      {
+        block->next = (Block*)arena_cache;
+        arena_cache = block;
+        arena_cache_blocks++;
+        continue;
+      }
+    }
+    free(block);
+  }
+}
+
+void* ArithmeticModelArena::allocate(U32 size)
+{
+  size = arena_round(size);
+  if ((curr == 0) || ((U32)(end - curr) < size))
+  {
+    // the block header takes the first cache line
+    U32 block_size = AC_ARENA_BLOCK_SIZE;
+    if (size > AC_ARENA_BLOCK_SIZE - 2*AC_ARENA_ALIGNMENT) block_size = size + 2*AC_ARENA_ALIGNMENT;
+    // a block left behind by restoreState() is used again
+    Block* block = (current ? current->next : blocks);
+    if ((block == 0) || (block->size < block_size))
+    {
+      block = 0;
+      if (block_size == AC_ARENA_BLOCK_SIZE)
+      {
+        std::lock_guard<std::mutex> lock(arena_cache_mutex);
+        if (arena_cache)
+        {
+          block = (Block*)arena_cache;
+          arena_cache = block->next;
+          arena_cache_blocks--;
+        }
+      }
+      if (block == 0)
+      {
+        block = (Block*)malloc(block_size);
+        if (block == 0) return 0;
+      }
+      block->size = block_size;
+      if (current)
+      {
+        block->next = current->next;
+        current->next = block;
+      }
+      else
+      {
+        block->next = blocks;
+        blocks = block;
+      }
+    }
+    current = block;
+    U8* start = (U8*)block + sizeof(Block);
+    curr = start + ((AC_ARENA_ALIGNMENT - ((size_t)start % AC_ARENA_ALIGNMENT)) % AC_ARENA_ALIGNMENT);
+    end = (U8*)block + block_size;
+  }
+  void* memory = curr;
+  curr += size;
+  return memory;
+}
+
+ArithmeticModel* ArithmeticModelArena::placeSymbolModel(U32 symbols, BOOL compress)
+{
+  U32 model_size = arena_round(sizeof(ArithmeticModel));
+  U32 table_size = ArithmeticModel::get_table_size(symbols, compress);
+  U8* memory = (U8*)allocate(model_size + sizeof(U32)*table_size);
+  if (memory == 0) return 0;
+  return new (memory) ArithmeticModel(symbols, compress, (table_size ? (U32*)(memory + model_size) : 0));
+}
+
+const ArithmeticModel* ArithmeticModelArena::getPristine(U32 symbols, BOOL compress)
+{
+  // one freshly initialized model per alphabet size is kept for the arena's lifetime
+  Pristine* pristine;
+  for (pristine = pristines; pristine; pristine = pristine->next)
+  {
+    if ((pristine->model->symbols == symbols) && (pristine->model->compress == compress)) return pristine->model;
+  }
+  if (ArithmeticModel::get_table_size(symbols, compress) == 0) return 0;
+  ArithmeticModel* model = placeSymbolModel(symbols, compress);
+  if ((model == 0) || (model->init() != 0)) return 0;
+  pristine = (Pristine*)allocate(sizeof(Pristine));
+  if (pristine == 0) return 0;
+  pristine->model = model;
+  pristine->next = pristines;
+  pristines = pristine;
+  return model;
+}
+
+ArithmeticModel* ArithmeticModelArena::createSymbolModel(U32 symbols, BOOL compress)
+{
+  ArithmeticModel* model = placeSymbolModel(symbols, compress);
+  if (model) model->pristine = getPristine(symbols, compress);
+  return model;
+}
+
+void ArithmeticModelArena::destroySymbolModel(ArithmeticModel* model)
+{
+  // the memory goes back with the arena
+  if (model) model->~ArithmeticModel();
+}
+
+ArithmeticBitModel* ArithmeticModelArena::createBitModel()
+{
+  void* memory = allocate(sizeof(ArithmeticBitModel));
+  if (memory == 0) return 0;
+  return new (memory) ArithmeticBitModel();
+}
+
+void ArithmeticModelArena::destroyBitModel(ArithmeticBitModel* model)
+{
+  if (model) model->~ArithmeticBitModel();
+}
+
+U32 ArithmeticModelArena::getStateSize() const
+{
+  U32 size = sizeof(Block*) + 2*sizeof(U8*) + sizeof(Pristine*);
+  Block* block;
+  for (block = (current ? blocks : 0); block; block = block->next)
+  {
+    if (block == current)
+    {
+      size += (U32)(curr - ((U8*)block + sizeof(Block)));
+      break;
+    }
+    size += block->size - sizeof(Block);
+  }
+  return size;
+}
+
+U8* ArithmeticModelArena::saveState(U8* state) const
+{
+  memcpy(state, &current, sizeof(Block*)); state += sizeof(Block*);
+  memcpy(state, &curr, sizeof(U8*)); state += sizeof(U8*);
+  memcpy(state, &end, sizeof(U8*)); state += sizeof(U8*);
+  memcpy(state, &pristines, sizeof(Pristine*)); state += sizeof(Pristine*);
+  // the block headers are not part of the state as restoring may relink them
+  Block* block;
+  for (block = (current ? blocks : 0); block; block = block->next)
+  {
+    U8* start = (U8*)block + sizeof(Block);
+    U32 size = (U32)((block == current ? curr : (U8*)block + block->size) - start);
+    memcpy(state, start, size);
+    state += size;
+    if (block == current) break;
+  }
+  return state;
+}
+
+const U8* ArithmeticModelArena::restoreState(const U8* state)
+{
+  memcpy(&current, state, sizeof(Block*)); state += sizeof(Block*);
+  memcpy(&curr, state, sizeof(U8*)); state += sizeof(U8*);
+  memcpy(&end, state, sizeof(U8*)); state += sizeof(U8*);
+  memcpy(&pristines, state, sizeof(Pristine*)); state += sizeof(Pristine*);
+  Block* block;
+  for (block = (current ? blocks : 0); block; block = block->next)
+  {
+    U8* start = (U8*)block + sizeof(Block);
+    U32 size = (U32)((block == current ? curr : (U8*)block + block->size) - start);
+    memcpy(start, state, size);
+    state += size;
+    if (block == current) break;
+  }
+  return state;
+}
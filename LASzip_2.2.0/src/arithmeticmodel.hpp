@@ -25,6 +25,11 @@
   
   CHANGE HISTORY:
   
+    17 October 2026 -- the models are shared with the rANS coder
+    17 October 2026 -- arena state can be saved and restored for seek checkpoints
+    17 October 2026 -- distribution and counts interleaved, hot fields in one line
+    17 October 2026 -- chunk resets copy a pristine model instead of recomputing
+    17 October 2026 -- models and their tables are carved from a recycled arena
     10 January 2011 -- licensing change for LGPL release and liblas integration
     8 December 2010 -- unified framework for all entropy coders
     30 October 2009 -- refactoring Amir Said's FastAC code
@@ -54,22 +59,44 @@ const U32 BM__MaxCount    = 1 << BM__LengthShift;  // for adaptive models
 const U32 DM__LengthShift = 15;     // length bits discarded before mult.
 const U32 DM__MaxCount    = 1 << DM__LengthShift;  // for adaptive models
 
+// the rANS coders scale all probabilities to DM__LengthShift bits and keep
+// their states within [RANS__MinState, RANS__MinState << 8) byte by byte
+const U32 RANS__MinState  = 1U << 23;
+
+// the decoder reads distribution[sym], distribution[sym+1] and then bumps
+// symbol_count[sym], so keeping them side by side touches one cache line
+struct ArithmeticModelEntry
+{
+  U32 distribution;
+  U32 symbol_count;
+};
+
 class ArithmeticModel
 {
 public:
-  ArithmeticModel(U32 symbols, BOOL compress);
+  ArithmeticModel(U32 symbols, BOOL compress, U32* memory=0);
   ~ArithmeticModel();
 
   I32 init(U32* table=0);
 
+  // number of U32 the tables need (zero if the number of symbols is invalid)
+  static U32 get_table_size(U32 symbols, BOOL compress);
+
 private:
   void update();
-  U32 * distribution, * symbol_count, * decoder_table;
-  U32 total_count, update_cycle, symbols_until_update;
-  U32 symbols, last_symbol, table_size, table_shift;
+  // fields used for every symbol come first and share one cache line
+  ArithmeticModelEntry * entries;
+  U32 * decoder_table;
+  U32 table_shift, last_symbol, symbols_until_update;
+  U32 symbols, total_count, update_cycle, table_size;
   BOOL compress;
+  U32 * memory;
+  const ArithmeticModel* pristine;
   friend class ArithmeticEncoder;
   friend class ArithmeticDecoder;
+  friend class RANSEncoder;
+  friend class RANSDecoder;
+  friend class ArithmeticModelArena;
 };
 
 class ArithmeticBitModel
@@ -86,6 +113,49 @@ private:
   U32 bit_0_prob, bit_0_count, bit_count;
   friend class ArithmeticEncoder;
   friend class ArithmeticDecoder;
+  friend class RANSEncoder;
+  friend class RANSDecoder;
+};
+
+class ArithmeticModelArena
+{
+public:
+  ArithmeticModelArena();
+  ~ArithmeticModelArena();
+
+  // each model is placed right next to its tables on a cache line boundary
+  // and re-initializes by copying a freshly initialized model of its size
+  ArithmeticModel* createSymbolModel(U32 symbols, BOOL compress);
+  void destroySymbolModel(ArithmeticModel* model);
+  ArithmeticBitModel* createBitModel();
+  void destroyBitModel(ArithmeticBitModel* model);
+
+  // the contents of all models and where allocation continues (blocks that
+  // were allocated after a restored state are reused in the same order so
+  // that later states of the same chunk stay valid)
+  U32 getStateSize() const;
+  U8* saveState(U8* state) const;
+  const U8* restoreState(const U8* state);
+
+private:
+  struct Block
+  {
+    Block* next;
+    U32 size;
+  };
+  struct Pristine
+  {
+    Pristine* next;
+    ArithmeticModel* model;
+  };
+  void* allocate(U32 size);
+  ArithmeticModel* placeSymbolModel(U32 symbols, BOOL compress);
+  const ArithmeticModel* getPristine(U32 symbols, BOOL compress);
+  Block* blocks; // oldest first
+  Block* current;
+  Pristine* pristines;
+  U8* curr;
+  U8* end;
 };
 
 #endif
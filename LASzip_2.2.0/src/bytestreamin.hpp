@@ -24,6 +24,8 @@
   
   CHANGE HISTORY:
   
+    17 October 2026 -- windows of streams that reuse their buffers are not stable
+    17 October 2026 -- optional window for reading buffered bytes without a call
      1 October 2011 -- added 64 bit file support in MSVC 6.0 at McCafe at Hbf Linz
     10 January 2011 -- licensing change for LGPL release and liblas integration
     12 December 2010 -- created from ByteStreamOutFile after Howard got pushy (-;
@@ -62,6 +64,12 @@ public:
   virtual BOOL seek(const I64 position) = 0;
 /* seek to the end of the file                               */
   virtual BOOL seekEnd(const I64 distance=0) = 0;
+/* bytes that can be read directly (none if not buffered)    */
+  virtual U32 getWindow(const U8** bytes) { *bytes = 0; return 0; };
+/* skip bytes that were read directly from the window        */
+  virtual void skipWindow(const U32) {};
+/* window bytes stay valid after later reads from the stream */
+  virtual BOOL isWindowStable() const { return TRUE; };
 /* destructor                                                */
   virtual ~ByteStreamIn() {};
 };
@@ -0,0 +1,302 @@
+/*
+===============================================================================
+
+  FILE:  bytestreamin_async.cpp
+
+  CONTENTS:
+
+    see corresponding header file
+
+  PROGRAMMERS:
+
+    agent@local
+
+  COPYRIGHT:
+
+    (c) 2026, agent@local
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the COPYING file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    see corresponding header file
+
+===============================================================================
+*/
+#include "bytestreamin_async.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined _WIN32
+#include <windows.h>
+#include <io.h>
+#include <malloc.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+// reads start at multiples of this and the buffers are aligned to it
+#define LASZIP_READ_AHEAD_ALIGNMENT 4096
+
+ByteStreamInFileAsync::ByteStreamInFileAsync(FILE* file, const U32 num_buffers, const U32 buffer_size)
+{
+  U32 i;
+  this->file = file;
+  this->num_buffers = (num_buffers < 2 ? 2 : num_buffers);
+  this->buffer_size = ((buffer_size + LASZIP_READ_AHEAD_ALIGNMENT - 1) / LASZIP_READ_AHEAD_ALIGNMENT) * LASZIP_READ_AHEAD_ALIGNMENT;
+  if (this->buffer_size == 0) this->buffer_size = LASZIP_READ_AHEAD_ALIGNMENT;
+
+#if defined _WIN32
+  memory = (U8*)_aligned_malloc((size_t)this->num_buffers*this->buffer_size, LASZIP_READ_AHEAD_ALIGNMENT);
+#else
+  if (posix_memalign((void**)&memory, LASZIP_READ_AHEAD_ALIGNMENT, (size_t)this->num_buffers*this->buffer_size)) memory = 0;
+#endif
+  buffers = new Buffer[this->num_buffers];
+  for (i = 0; i < this->num_buffers; i++)
+  {
+    buffers[i].data = memory + (size_t)i*this->buffer_size;
+    buffers[i].start = 0;
+    buffers[i].size = 0;
+    buffers[i].last = FALSE;
+  }
+
+  // the reads bypass the FILE* so its position is where they begin
+#if defined _WIN32 && ! defined (__MINGW32__)
+  file_size = _filelengthi64(_fileno(file));
+  I64 position = _ftelli64(file);
+#elif defined (__MINGW32__)
+  file_size = _filelengthi64(_fileno(file));
+  I64 position = (I64)ftello64(file);
+#else
+  struct stat info;
+  file_size = (fstat(fileno(file), &info) == 0 ? (I64)info.st_size : 0);
+  I64 position = (I64)ftello(file);
+#endif
+
+  start(position);
+}
+
+ByteStreamInFileAsync::~ByteStreamInFileAsync()
+{
+  stop();
+  delete [] buffers;
+#if defined _WIN32
+  if (memory) _aligned_free(memory);
+#else
+  if (memory) free(memory);
+#endif
+}
+
+void ByteStreamInFileAsync::start(const I64 position)
+{
+  // the first read is aligned and the decoder starts into its buffer
+  start_position = (position < 0 ? 0 : position);
+  read_position = start_position - (start_position % LASZIP_READ_AHEAD_ALIGNMENT);
+  start_offset = (U32)(start_position - read_position);
+  produced = 0;
+  consumed = 0;
+  stopping = false;
+  current = 0;
+  offset = 0;
+  thread = std::thread(&ByteStreamInFileAsync::work, this);
+}
+
+void ByteStreamInFileAsync::stop()
+{
+  if (!thread.joinable()) return;
+  stopping = true;
+  wake();
+  thread.join();
+}
+
+void ByteStreamInFileAsync::wake()
+{
+  // the other side checks before it sleeps, so no wake up gets lost
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+  }
+  changed.notify_all();
+}
+
+void ByteStreamInFileAsync::work()
+{
+  while (!stopping)
+  {
+    U32 p = produced.load(std::memory_order_relaxed);
+    if (p - consumed.load(std::memory_order_acquire) == num_buffers)
+    {
+      // every buffer is ahead of the decoder
+      std::unique_lock<std::mutex> lock(mutex);
+      changed.wait(lock, [this, p] { return stopping || (p - consumed.load(std::memory_order_acquire) < num_buffers); });
+      continue;
+    }
+    Buffer* buffer = &buffers[p % num_buffers];
+    buffer->start = read_position;
+    buffer->size = read(buffer->data, buffer_size, read_position);
+    buffer->last = (buffer->size < buffer_size);
+    read_position += buffer->size;
+    produced.store(p + 1, std::memory_order_release);
+    wake();
+    if (buffer->last) break;
+  }
+}
+
+BOOL ByteStreamInFileAsync::next()
+{
+  if (current)
+  {
+    if (current->last) return FALSE;
+    // hand the buffer back to the I/O thread
+    current = 0;
+    consumed.fetch_add(1, std::memory_order_release);
+    wake();
+  }
+  U32 c = consumed.load(std::memory_order_relaxed);
+  if (produced.load(std::memory_order_acquire) == c)
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this, c] { return produced.load(std::memory_order_acquire) != c; });
+  }
+  current = &buffers[c % num_buffers];
+  offset = 0;
+  if (c == 0)
+  {
+    offset = (start_offset < current->size ? start_offset : current->size);
+  }
+  return TRUE;
+}
+
+U32 ByteStreamInFileAsync::read(U8* bytes, const U32 num_bytes, const I64 position)
+{
+  U32 total = 0;
+#if defined _WIN32
+  // a positioned read on the handle is the pread() of windows
+  HANDLE handle = (HANDLE)_get_osfhandle(_fileno(file));
+  while (total < num_bytes)
+  {
+    OVERLAPPED overlapped;
+    memset(&overlapped, 0, sizeof(overlapped));
+    I64 at = position + total;
+    overlapped.Offset = (DWORD)(at & 0xFFFFFFFF);
+    overlapped.OffsetHigh = (DWORD)(at >> 32);
+    DWORD num_read = 0;
+    if (!ReadFile(handle, bytes + total, num_bytes - total, &num_read, &overlapped) || (num_read == 0)) break;
+    total += num_read;
+  }
+#else
+  int fd = fileno(file);
+  while (total < num_bytes)
+  {
+    ssize_t num_read = pread(fd, bytes + total, num_bytes - total, (off_t)(position + total));
+    if (num_read < 0 && errno == EINTR) continue;
+    if (num_read <= 0) break;
+    total += (U32)num_read;
+  }
+#endif
+  return total;
+}
+
+U32 ByteStreamInFileAsync::getByte()
+{
+  if (current && offset < current->size)
+  {
+    return current->data[offset++];
+  }
+  U8 byte;
+  getBytes(&byte, 1);
+  return (U32)byte;
+}
+
+void ByteStreamInFileAsync::getBytes(U8* bytes, const U32 num_bytes)
+{
+  U32 num;
+  U32 remaining = num_bytes;
+  while (remaining)
+  {
+    if (current == 0 || offset == current->size)
+    {
+      if (!next())
+      {
+        throw EOF;
+      }
+      continue;
+    }
+    num = current->size - offset;
+    if (num > remaining) num = remaining;
+    memcpy(bytes, current->data + offset, num);
+    bytes += num;
+    offset += num;
+    remaining -= num;
+  }
+}
+
+BOOL ByteStreamInFileAsync::isSeekable() const
+{
+  return TRUE;
+}
+
+I64 ByteStreamInFileAsync::tell() const
+{
+  if (current) return current->start + offset;
+  return start_position;
+}
+
+BOOL ByteStreamInFileAsync::seek(const I64 position)
+{
+  if (current && position >= current->start)
+  {
+    // short skips forward move through what is read ahead anyway
+    I64 ahead = current->start + (I64)num_buffers*buffer_size;
+    while ((position > current->start + current->size) && (position < ahead) && next());
+    if (position >= current->start && position <= current->start + current->size)
+    {
+      offset = (U32)(position - current->start);
+      return TRUE;
+    }
+  }
+  else if (current == 0 && position == start_position)
+  {
+    return TRUE;
+  }
+  // anything else restarts the reading at the new position
+  stop();
+  start(position);
+  return TRUE;
+}
+
+BOOL ByteStreamInFileAsync::seekEnd(const I64 distance)
+{
+  return seek(file_size - distance);
+}
+
+U32 ByteStreamInFileAsync::getWindow(const U8** bytes)
+{
+  if (current == 0 || offset == current->size)
+  {
+    if (!next())
+    {
+      *bytes = 0;
+      return 0;
+    }
+  }
+  *bytes = current->data + offset;
+  return current->size - offset;
+}
+
+void ByteStreamInFileAsync::skipWindow(const U32 num_bytes)
+{
+  offset += num_bytes;
+}
+
+BOOL ByteStreamInFileAsync::isWindowStable() const
+{
+  return FALSE;
+}
@@ -0,0 +1,250 @@
+/*
+===============================================================================
+
+  FILE:  bytestreamin_async.hpp
+
+  CONTENTS:
+
+    Class for FILE*-based input streams that read ahead on their own I/O
+    thread. The thread fills several large aligned buffers with positioned
+    reads (pread) while the decoder works through earlier ones, and hands
+    them over through a single-producer/single-consumer ring so that disk
+    or network latency overlaps with the entropy decoding.
+
+  PROGRAMMERS:
+
+    agent@local
+
+  COPYRIGHT:
+
+    (c) 2026, agent@local
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the COPYING file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    17 October 2026 -- created for overlapping reads with decoding
+
+===============================================================================
+*/
+#ifndef BYTE_STREAM_IN_ASYNC_H
+#define BYTE_STREAM_IN_ASYNC_H
+
+#include "bytestreamin.hpp"
+
+#include <stdio.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#define LASZIP_READ_AHEAD_BUFFERS 4
+#define LASZIP_READ_AHEAD_BUFFER_SIZE 1048576
+
+class ByteStreamInFileAsync : public ByteStreamIn
+{
+public:
+  // reads ahead from the current position of the file (which is not moved)
+  ByteStreamInFileAsync(FILE* file, const U32 num_buffers=LASZIP_READ_AHEAD_BUFFERS, const U32 buffer_size=LASZIP_READ_AHEAD_BUFFER_SIZE);
+/* read a single byte                                        */
+  U32 getByte();
+/* read an array of bytes                                    */
+  void getBytes(U8* bytes, const U32 num_bytes);
+/* is the stream seekable (e.g. stdin is not)                */
+  BOOL isSeekable() const;
+/* get current position of stream                            */
+  I64 tell() const;
+/* seek to this position in the stream                       */
+  BOOL seek(const I64 position);
+/* seek to the end of the file                               */
+  BOOL seekEnd(const I64 distance=0);
+/* the rest of the current buffer can be read directly       */
+  U32 getWindow(const U8** bytes);
+/* skip bytes that were read directly                        */
+  void skipWindow(const U32 num_bytes);
+/* buffers are reused once they were read                    */
+  BOOL isWindowStable() const;
+/* destructor                                                */
+  ~ByteStreamInFileAsync();
+private:
+  struct Buffer
+  {
+    U8* data;
+    I64 start;
+    U32 size;
+    BOOL last;
+  };
+  void start(const I64 position);
+  void stop();
+  void work();
+  BOOL next();
+  U32 read(U8* bytes, const U32 num_bytes, const I64 position);
+  void wake();
+
+  FILE* file;
+  I64 file_size;
+  U32 num_buffers;
+  U32 buffer_size;
+  U8* memory;
+  Buffer* buffers;
+
+  // the I/O thread fills buffers[produced % num_buffers] and the decoder
+  // reads buffers[consumed % num_buffers] (the lock is only for sleeping)
+  std::atomic<U32> produced;
+  std::atomic<U32> consumed;
+  std::atomic<bool> stopping;
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::thread thread;
+  I64 read_position;
+
+  // the buffer the decoder is in
+  Buffer* current;
+  U32 offset;
+  I64 start_position;
+  U32 start_offset;
+};
+
+class ByteStreamInFileAsyncLE : public ByteStreamInFileAsync
+{
+public:
+  ByteStreamInFileAsyncLE(FILE* file, const U32 num_buffers=LASZIP_READ_AHEAD_BUFFERS, const U32 buffer_size=LASZIP_READ_AHEAD_BUFFER_SIZE);
+/* read 16 bit low-endian field                              */
+  void get16bitsLE(U8* bytes);
+/* read 32 bit low-endian field                              */
+  void get32bitsLE(U8* bytes);
+/* read 64 bit low-endian field                              */
+  void get64bitsLE(U8* bytes);
+/* read 16 bit big-endian field                              */
+  void get16bitsBE(U8* bytes);
+/* read 32 bit big-endian field                              */
+  void get32bitsBE(U8* bytes);
+/* read 64 bit big-endian field                              */
+  void get64bitsBE(U8* bytes);
+private:
+  U8 swapped[8];
+};
+
+class ByteStreamInFileAsyncBE : public ByteStreamInFileAsync
+{
+public:
+  ByteStreamInFileAsyncBE(FILE* file, const U32 num_buffers=LASZIP_READ_AHEAD_BUFFERS, const U32 buffer_size=LASZIP_READ_AHEAD_BUFFER_SIZE);
+/* read 16 bit low-endian field                              */
+  void get16bitsLE(U8* bytes);
+/* read 32 bit low-endian field                              */
+  void get32bitsLE(U8* bytes);
+/* read 64 bit low-endian field                              */
+  void get64bitsLE(U8* bytes);
+/* read 16 bit big-endian field                              */
+  void get16bitsBE(U8* bytes);
+/* read 32 bit big-endian field                              */
+  void get32bitsBE(U8* bytes);
+/* read 64 bit big-endian field                              */
+  void get64bitsBE(U8* bytes);
+private:
+  U8 swapped[8];
+};
+
+inline ByteStreamInFileAsyncLE::ByteStreamInFileAsyncLE(FILE* file, const U32 num_buffers, const U32 buffer_size) : ByteStreamInFileAsync(file, num_buffers, buffer_size)
+{
+}
+
+inline void ByteStreamInFileAsyncLE::get16bitsLE(U8* bytes)
+{
+  getBytes(bytes, 2);
+}
+
+inline void ByteStreamInFileAsyncLE::get32bitsLE(U8* bytes)
+{
+  getBytes(bytes, 4);
+}
+
+inline void ByteStreamInFileAsyncLE::get64bitsLE(U8* bytes)
+{
+  getBytes(bytes, 8);
+}
+
+inline void ByteStreamInFileAsyncLE::get16bitsBE(U8* bytes)
+{
+  getBytes(swapped, 2);
+  bytes[0] = swapped[1];
+  bytes[1] = swapped[0];
+}
+
+inline void ByteStreamInFileAsyncLE::get32bitsBE(U8* bytes)
+{
+  getBytes(swapped, 4);
+  bytes[0] = swapped[3];
+  bytes[1] = swapped[2];
+  bytes[2] = swapped[1];
+  bytes[3] = swapped[0];
+}
+
+inline void ByteStreamInFileAsyncLE::get64bitsBE(U8* bytes)
+{
+  getBytes(swapped, 8);
+  bytes[0] = swapped[7];
+  bytes[1] = swapped[6];
+  bytes[2] = swapped[5];
+  bytes[3] = swapped[4];
+  bytes[4] = swapped[3];
+  bytes[5] = swapped[2];
+  bytes[6] = swapped[1];
+  bytes[7] = swapped[0];
+}
+
+inline ByteStreamInFileAsyncBE::ByteStreamInFileAsyncBE(FILE* file, const U32 num_buffers, const U32 buffer_size) : ByteStreamInFileAsync(file, num_buffers, buffer_size)
+{
+}
+
+inline void ByteStreamInFileAsyncBE::get16bitsLE(U8* bytes)
+{
+  getBytes(swapped, 2);
+  bytes[0] = swapped[1];
+  bytes[1] = swapped[0];
+}
+
+inline void ByteStreamInFileAsyncBE::get32bitsLE(U8* bytes)
+{
+  getBytes(swapped, 4);
+  bytes[0] = swapped[3];
+  bytes[1] = swapped[2];
+  bytes[2] = swapped[1];
+  bytes[3] = swapped[0];
+}
+
+inline void ByteStreamInFileAsyncBE::get64bitsLE(U8* bytes)
+{
+  getBytes(swapped, 8);
+  bytes[0] = swapped[7];
+  bytes[1] = swapped[6];
+  bytes[2] = swapped[5];
+  bytes[3] = swapped[4];
+  bytes[4] = swapped[3];
+  bytes[5] = swapped[2];
+  bytes[6] = swapped[1];
+  bytes[7] = swapped[0];
+}
+
+inline void ByteStreamInFileAsyncBE::get16bitsBE(U8* bytes)
+{
+  getBytes(bytes, 2);
+}
+
+inline void ByteStreamInFileAsyncBE::get32bitsBE(U8* bytes)
+{
+  getBytes(bytes, 4);
+}
+
+inline void ByteStreamInFileAsyncBE::get64bitsBE(U8* bytes)
+{
+  getBytes(bytes, 8);
+}
+
+#endif
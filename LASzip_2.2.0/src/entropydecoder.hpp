@@ -24,6 +24,8 @@
   
   CHANGE HISTORY:
   
+    17 October 2026 -- tell() for counting the bytes that each item consumes
+    17 October 2026 -- decoder state can be saved and restored for seek checkpoints
     10 January 2011 -- licensing change for LGPL release and liblas integration  
     8 December 2010 -- unified framework for all entropy coders
   
@@ -47,6 +49,14 @@ public:
 /* Manage decoding                                           */
   virtual BOOL init(ByteStreamIn* instream) = 0;
   virtual void done() = 0;
+
+/* Position in the stream of the next byte to be decoded     */
+  virtual I64 tell() const = 0;
+
+/* Save and restore the decoding state including all models  */
+  virtual U32 getStateSize() const = 0;
+  virtual U8* saveState(U8* state) const = 0;
+  virtual const U8* restoreState(const U8* state) = 0;
 
 /* Manage an entropy model for a single bit                  */
   virtual EntropyModel* createBitModel() = 0;
@@ -24,6 +24,8 @@
   
   CHANGE HISTORY:
   
+    17 October 2026 -- tellBits() for reporting what each field costs
+    17 October 2026 -- tell() for counting the bytes that each item produces
     10 January 2011 -- licensing change for LGPL release and liblas integration
     8 December 2010 -- unified framework for all entropy coders
   
@@ -46,7 +48,13 @@ public:
 
 /* Manage decoding                                           */
   virtual BOOL init(ByteStreamOut* outstream) = 0;
-  virtual void done() = 0;
+  virtual BOOL done() = 0;
+
+/* Position in the stream that the encoded bytes reach       */
+  virtual I64 tell() const = 0;
+
+/* Bits the encoding has used since init (with fractions)    */
+  virtual F64 tellBits() const = 0;
 
 /* Manage an entropy model for a single bit                  */
   virtual EntropyModel* createBitModel() = 0;
@@ -33,15 +33,9 @@
 #define COMPRESS_ONLY_K
 #undef COMPRESS_ONLY_K
 
-#define CREATE_HISTOGRAMS
-#undef CREATE_HISTOGRAMS
-
 #include <stdlib.h>
 #include <assert.h>
-
-#ifdef CREATE_HISTOGRAMS
 #include <math.h>
-#endif
 
 IntegerCompressor::IntegerCompressor(EntropyEncoder* enc, U32 bits, U32 contexts, U32 bits_high, U32 range)
 {
@@ -92,17 +86,10 @@ IntegerCompressor::IntegerCompressor(EntropyEncoder* enc, U32 bits, U32 contexts
   mBits = 0;
   mCorrector = 0;
 
-#ifdef CREATE_HISTOGRAMS
-  corr_histogram = (int**)malloc(sizeof(int*) * (corr_bits+1));
-  for (int k = 0; k <= corr_bits; k++)
-  {
-    corr_histogram[k] = (int*)malloc(sizeof(int) * ((1<<k)+1));
-    for (int c = 0; c <= (1<<k); c++)
-    {
-      corr_histogram[k][c] = 0;
-    }
-  }  
-#endif
+  stat_number = 0;
+  stat_bits = 0;
+  stat_k = 0;
+  stat_corr = 0;
 }
 
 IntegerCompressor::IntegerCompressor(EntropyDecoder* dec, U32 bits, U32 contexts, U32 bits_high, U32 range)
@@ -153,6 +140,11 @@ IntegerCompressor::IntegerCompressor(EntropyDecoder* dec, U32 bits, U32 contexts
 
   mBits = 0;
   mCorrector = 0;
+
+  stat_number = 0;
+  stat_bits = 0;
+  stat_k = 0;
+  stat_corr = 0;
 }
 
 IntegerCompressor::~IntegerCompressor()
@@ -181,38 +173,130 @@ IntegerCompressor::~IntegerCompressor()
   }
 #endif
 
-#ifdef CREATE_HISTOGRAMS
-  if (end)
+  setStatistics(FALSE);
+}
+
+void IntegerCompressor::setStatistics(BOOL statistics)
+{
+  U32 i, j;
+
+  if (statistics)
   {
-    int total_number = 0;
-    double total_entropy = 0.0f;
-    double total_raw = 0.0f;
-    for (int k = 0; k <= corr_bits; k++)
+    assert(enc);
+    if (stat_number) return;
+    stat_number = new U64[contexts];
+    stat_bits = new F64[contexts];
+    stat_k = new U64*[contexts];
+    stat_corr = new U32**[contexts];
+    for (i = 0; i < contexts; i++)
     {
-      int number = 0;
-      int different = 0;
-      for (int c = 0; c <= (1<<k); c++)
+      stat_number[i] = 0;
+      stat_bits[i] = 0.0;
+      stat_k[i] = new U64[corr_bits+1];
+      stat_corr[i] = new U32*[corr_bits+1];
+      for (j = 0; j <= corr_bits; j++)
       {
-        number += corr_histogram[k][c];
+        stat_k[i][j] = 0;
+        stat_corr[i][j] = 0; // allocated once the first corrector needs it
       }
-      double prob,entropy = 0.0f;
-      for (c = 0; c <= (1<<k); c++)
+    }
+  }
+  else if (stat_number)
+  {
+    for (i = 0; i < contexts; i++)
+    {
+      for (j = 0; j <= corr_bits; j++)
       {
-        if (corr_histogram[k][c])
-        {
-          different++;
-          prob = (double)corr_histogram[k][c]/(double)number;
-          entropy -= log(prob)*prob/log(2.0);
-        }
+        if (stat_corr[i][j]) delete [] stat_corr[i][j];
       }
-      fprintf(stderr, "k: %d number: %d different: %d entropy: %lg raw: %1.1f\n",k,number,different,entropy, (float)(k?k:1));
-      total_number += number;
-      total_entropy += (entropy*number);
-      total_raw += ((k?k:1)*number);
-    }  
-    fprintf(stderr, "TOTAL: number: %d entropy: %lg raw: %lg\n",total_number,total_entropy/total_number,total_raw/total_number);
+      delete [] stat_corr[i];
+      delete [] stat_k[i];
+    }
+    delete [] stat_corr;
+    delete [] stat_k;
+    delete [] stat_bits;
+    delete [] stat_number;
+    stat_number = 0;
+    stat_bits = 0;
+    stat_k = 0;
+    stat_corr = 0;
   }
-#endif
+}
+
+BOOL IntegerCompressor::getStatistics(U32 context, U64* number, F64* bits, U64* k_counts, F64* entropy) const
+{
+  U32 i, s;
+
+  if (stat_number == 0 || context >= contexts) return FALSE;
+
+  if (number) *number = stat_number[context];
+  if (bits) *bits = stat_bits[context];
+  if (k_counts)
+  {
+    for (i = 0; i <= corr_bits; i++) k_counts[i] = stat_k[context][i];
+  }
+  if (entropy)
+  {
+    // the entropy of k plus that of the corrector given k (with raw bits as they are)
+    F64 total = 0.0;
+    for (i = 0; i <= corr_bits; i++)
+    {
+      if (stat_k[context][i] == 0) continue;
+      F64 p = (F64)stat_k[context][i] / (F64)stat_number[context];
+      total -= p * log(p) / log(2.0);
+      if (stat_corr[context][i] == 0) continue;
+      F64 h = 0.0;
+      for (s = 0; s < getCorrectorSymbols(i); s++)
+      {
+        if (stat_corr[context][i][s] == 0) continue;
+        F64 q = (F64)stat_corr[context][i][s] / (F64)stat_k[context][i];
+        h -= q * log(q) / log(2.0);
+      }
+      if (i > bits_high) h += (i - bits_high);
+      total += p * h;
+    }
+    *entropy = total;
+  }
+  return TRUE;
+}
+
+U32 IntegerCompressor::getCorrectorSymbols(U32 k) const
+{
+  // the same symbols as the models of writeCorrector() use
+  if (k == 0) return 2;
+  if (k >= 32) return 0;
+  return (k <= bits_high ? (1u << k) : (1u << bits_high));
+}
+
+void IntegerCompressor::addStatistics(I32 c, U32 context, F64 bits)
+{
+  U32 sym;
+
+  stat_number[context]++;
+  stat_bits[context] += bits;
+  stat_k[context][k]++;
+
+  if (k >= 32) return; // only k was coded
+
+  // translate c into the symbol that writeCorrector() coded
+  if (k)
+  {
+    if (c < 0) c += (I32)((1u << k) - 1);
+    else c -= 1;
+    sym = (k <= bits_high ? (U32)c : ((U32)c >> (k - bits_high)));
+  }
+  else
+  {
+    sym = (U32)c;
+  }
+
+  if (stat_corr[context][k] == 0)
+  {
+    U32 n = getCorrectorSymbols(k);
+    stat_corr[context][k] = new U32[n];
+    for (U32 s = 0; s < n; s++) stat_corr[context][k][s] = 0;
+  }
+  stat_corr[context][k][sym]++;
 }
 
 void IntegerCompressor::initCompressor()
@@ -268,6 +352,14 @@ void IntegerCompressor::compress(I32 pred, I32 real, U32 context)
   // we fold the corrector into the interval [ corr_min  ...  corr_max ]
   if (corr < corr_min) corr += corr_range;
   else if (corr > corr_max) corr -= corr_range;
+  if (stat_number)
+  {
+    // what the corrector costs is what the encoder's interval shrank by
+    F64 bits = enc->tellBits();
+    writeCorrector(corr, mBits[context]);
+    addStatistics(corr, context, enc->tellBits() - bits);
+    return;
+  }
   writeCorrector(corr, mBits[context]);
 }
 
@@ -396,17 +488,11 @@ void IntegerCompressor::writeCorrector(I32 c, EntropyModel* mBits)
       {
         // so we translate c into the interval [ 0 ...  + 2^(k-1) - 1 ] by adding (2^k - 1)
         enc->writeBits(k, c + ((1<<k) - 1));
-#ifdef CREATE_HISTOGRAMS
-        corr_histogram[k][c + ((1<<k) - 1)]++;
-#endif
       }
       else // then c is in the interval [ 2^(k-1) + 1  ...  2^k ]
       {
         // so we translate c into the interval [ 2^(k-1) ...  + 2^k - 1 ] by subtracting 1
         enc->writeBits(k, c - 1);
-#ifdef CREATE_HISTOGRAMS
-        corr_histogram[k][c - 1]++;
-#endif
       }
     }
   }
@@ -414,9 +500,6 @@ void IntegerCompressor::writeCorrector(I32 c, EntropyModel* mBits)
   {
     assert((c == 0) || (c == 1));
     enc->writeBit(c);
-#ifdef CREATE_HISTOGRAMS
-    corr_histogram[0][c]++;
-#endif
   }
 #else // COMPRESS_ONLY_K
   if (k) // then c is either smaller than 0 or bigger than 1
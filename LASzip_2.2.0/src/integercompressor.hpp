@@ -36,6 +36,7 @@
   
   CHANGE HISTORY:
   
+    17 October 2026 -- statistics of the bits, the k and the entropy of each context
     10 January 2011 -- licensing change for LGPL release and liblas integration
     10 December 2010 -- unified for all entropy coders at Baeckerei Schaefer
     31 October 2009 -- switched from the Rangecoder to the Entropycoder
@@ -70,6 +71,15 @@ public:
   // Get the k corrector bits from the last compress/decompress call
   U32 getK() const {return k;};
 
+  // Keep statistics of what compress() spends in each context (or stop)
+  void setStatistics(BOOL statistics);
+  U32 getContexts() const {return contexts;};
+  U32 getCorrBits() const {return corr_bits;};
+  // the number of values compressed in a context, the bits spent on them,
+  // how often each k occurred (corr_bits+1 counts) and the order-0 entropy
+  // of their correctors in bits per value (FALSE without statistics)
+  BOOL getStatistics(U32 context, U64* number, F64* bits, U64* k_counts, F64* entropy) const;
+
 private:
   void writeCorrector(I32 c, EntropyModel* model);
   I32 readCorrector(EntropyModel* model);
@@ -94,7 +104,12 @@ private:
 
   EntropyModel** mCorrector;
 
-  int** corr_histogram;
+  U64* stat_number;
+  F64* stat_bits;
+  U64** stat_k;
+  U32*** stat_corr;
+  U32 getCorrectorSymbols(U32 k) const;
+  void addStatistics(I32 c, U32 context, F64 bits);
 };
 
 #endif
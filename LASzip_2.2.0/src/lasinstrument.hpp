@@ -0,0 +1,80 @@
+/*
+===============================================================================
+
+  FILE:  lasinstrument.hpp
+
+  CONTENTS:
+
+    Counters for what the encoding or decoding of each item costs: the
+    processor cycles spent in its reader or writer, the number of points
+    and the compressed bytes. They are only kept in builds that define
+    LASZIP_INSTRUMENT and cost nothing otherwise because all code that
+    updates them is compiled out.
+
+  PROGRAMMERS:
+
+    agent@local
+
+  COPYRIGHT:
+
+    (c) 2026, agent@local
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the COPYING file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    17 October 2026 -- fused codecs count each of their items as well
+    17 October 2026 -- created for finding out which item slows down a dataset
+
+===============================================================================
+*/
+#ifndef LAS_INSTRUMENT_H
+#define LAS_INSTRUMENT_H
+
+#include "mydefs.hpp"
+
+#ifdef LASZIP_INSTRUMENT
+
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+#define LASZIP_CYCLES() ((I64)__rdtsc())
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__i386__) || defined(__x86_64__))
+#include <x86intrin.h>
+#define LASZIP_CYCLES() ((I64)__rdtsc())
+#else
+// without a time stamp counter the "cycles" are nanoseconds
+#include <chrono>
+#define LASZIP_CYCLES() ((I64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count())
+#endif
+
+class LASitemCounters
+{
+public:
+  I64 cycles;
+  I64 points;
+  I64 bytes;
+  LASitemCounters() { reset(); };
+  void reset() { cycles = 0; points = 0; bytes = 0; };
+  void add(const LASitemCounters& other) { cycles += other.cycles; points += other.points; bytes += other.bytes; };
+};
+
+// tells how far the coders of an item have got in bytes so that a codec
+// for several items at once can count each of them
+class LASitemPositions
+{
+public:
+  virtual I64 item_position(const U32 i) const = 0;
+  virtual ~LASitemPositions() {};
+};
+
+// runs the code for an item and counts its cycles (not those of telling the position) and bytes
+#define LASZIP_COUNT(positions, counters, i, code) { I64 position = (positions)->item_position(i); I64 cycles = LASZIP_CYCLES(); code; (counters)[i].cycles += LASZIP_CYCLES() - cycles; (counters)[i].bytes += (positions)->item_position(i) - position; (counters)[i].points++; }
+
+#endif
+
+#endif
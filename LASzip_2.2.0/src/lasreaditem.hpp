@@ -24,6 +24,7 @@
   
   CHANGE HISTORY:
   
+    17 October 2026 -- compressed items may save and restore their context
     10 January 2011 -- licensing change for LGPL release and liblas integration
     7 December 2010 -- refactored after getting invited to KAUST in Saudi Arabia
   
@@ -67,6 +68,12 @@ class LASreadItemCompressed : public LASreadItem
 public:
   virtual BOOL init(const U8* item)=0;
 
+  // the context needed to continue decompressing at this point (an item
+  // that cannot do this returns U32_MAX as the size of its state)
+  virtual U32 get_state_size() const { return U32_MAX; };
+  virtual U8* save_state(U8* state) const { return state; };
+  virtual const U8* restore_state(const U8* state) { return state; };
+
   virtual ~LASreadItemCompressed(){};
 };
 
@@ -34,6 +34,19 @@
 #include <assert.h>
 #include <string.h>
 
+// the seek checkpoints of LASreadPoint copy the context of the items
+static inline U8* save_bytes(U8* state, const void* bytes, const U32 size)
+{
+  memcpy(state, bytes, size);
+  return state + size;
+}
+
+static inline const U8* restore_bytes(const U8* state, void* bytes, const U32 size)
+{
+  memcpy(bytes, state, size);
+  return state + size;
+}
+
 struct LASpoint10
 {
   I32 x;
@@ -50,20 +63,24 @@ struct LASpoint10
   U16 point_source_ID;
 };
 
-LASreadItemCompressed_POINT10_v2::LASreadItemCompressed_POINT10_v2(EntropyDecoder* dec)
+LASreadItemCompressed_POINT10_v2::LASreadItemCompressed_POINT10_v2(EntropyDecoder* dec, EntropyDecoder* dec_attributes)
 {
   U32 i;
 
-  /* set decoder */
+  /* set decoders (the attributes are skipped without one) */
   assert(dec);
   this->dec = dec;
+  this->dec_attributes = dec_attributes;
 
   /* create models and integer compressors */
   m_changed_values = dec->createSymbolModel(64);
-  ic_intensity = new IntegerCompressor(dec, 16, 4);
-  m_scan_angle_rank[0] = dec->createSymbolModel(256);
-  m_scan_angle_rank[1] = dec->createSymbolModel(256);
-  ic_point_source_ID = new IntegerCompressor(dec, 16);
+  if (dec_attributes)
+  {
+    ic_intensity = new IntegerCompressor(dec_attributes, 16, 4);
+    m_scan_angle_rank[0] = dec_attributes->createSymbolModel(256);
+    m_scan_angle_rank[1] = dec_attributes->createSymbolModel(256);
+    ic_point_source_ID = new IntegerCompressor(dec_attributes, 16);
+  }
   for (i = 0; i < 256; i++)
   {
     m_bit_byte[i] = 0;
@@ -80,15 +97,18 @@ LASreadItemCompressed_POINT10_v2::~LASreadItemCompressed_POINT10_v2()
   U32 i;
 
   dec->destroySymbolModel(m_changed_values);
-  delete ic_intensity;
-  dec->destroySymbolModel(m_scan_angle_rank[0]);
-  dec->destroySymbolModel(m_scan_angle_rank[1]);
-  delete ic_point_source_ID;
+  if (dec_attributes)
+  {
+    delete ic_intensity;
+    dec_attributes->destroySymbolModel(m_scan_angle_rank[0]);
+    dec_attributes->destroySymbolModel(m_scan_angle_rank[1]);
+    delete ic_point_source_ID;
+  }
   for (i = 0; i < 256; i++)
   {
     if (m_bit_byte[i]) dec->destroySymbolModel(m_bit_byte[i]);
-    if (m_classification[i]) dec->destroySymbolModel(m_classification[i]);
-    if (m_user_data[i]) dec->destroySymbolModel(m_user_data[i]);
+    if (m_classification[i]) dec_attributes->destroySymbolModel(m_classification[i]);
+    if (m_user_data[i]) dec_attributes->destroySymbolModel(m_user_data[i]);
   }
   delete ic_dx;
   delete ic_dy;
@@ -110,15 +130,18 @@ BOOL LASreadItemCompressed_POINT10_v2::init(const U8* item)
 
   /* init models and integer compressors */
   dec->initSymbolModel(m_changed_values);
-  ic_intensity->initDecompressor();
-  dec->initSymbolModel(m_scan_angle_rank[0]);
-  dec->initSymbolModel(m_scan_angle_rank[1]);
-  ic_point_source_ID->initDecompressor();
+  if (dec_attributes)
+  {
+    ic_intensity->initDecompressor();
+    dec_attributes->initSymbolModel(m_scan_angle_rank[0]);
+    dec_attributes->initSymbolModel(m_scan_angle_rank[1]);
+    ic_point_source_ID->initDecompressor();
+  }
   for (i = 0; i < 256; i++)
   {
     if (m_bit_byte[i]) dec->initSymbolModel(m_bit_byte[i]);
-    if (m_classification[i]) dec->initSymbolModel(m_classification[i]);
-    if (m_user_data[i]) dec->initSymbolModel(m_user_data[i]);
+    if (m_classification[i]) dec_attributes->initSymbolModel(m_classification[i]);
+    if (m_user_data[i]) dec_attributes->initSymbolModel(m_user_data[i]);
   }
   ic_dx->initDecompressor();
   ic_dy->initDecompressor();
@@ -127,9 +150,12 @@ BOOL LASreadItemCompressed_POINT10_v2::init(const U8* item)
   /* init last item */
   memcpy(last_item, item, 20);
 
-  /* but set intensity to zero */ 
-  last_item[12] = 0;
-  last_item[13] = 0;
+  /* but set intensity to zero (skipped attributes keep their first value) */ 
+  if (dec_attributes)
+  {
+    last_item[12] = 0;
+    last_item[13] = 0;
+  }
 
   return TRUE;
 }
@@ -161,50 +187,53 @@ inline void LASreadItemCompressed_POINT10_v2::read(U8* item)
     m = number_return_map[n][r];
     l = number_return_level[n][r];
 
-    // decompress the intensity if it has changed
-    if (changed_values & 16)
+    if (dec_attributes)
     {
-      ((LASpoint10*)last_item)->intensity = (U16)ic_intensity->decompress(last_intensity[m], (m < 3 ? m : 3));
-      last_intensity[m] = ((LASpoint10*)last_item)->intensity;
-    }
-    else
-    {
-      ((LASpoint10*)last_item)->intensity = last_intensity[m];
-    }
+      // decompress the intensity if it has changed
+      if (changed_values & 16)
+      {
+        ((LASpoint10*)last_item)->intensity = (U16)ic_intensity->decompress(last_intensity[m], (m < 3 ? m : 3));
+        last_intensity[m] = ((LASpoint10*)last_item)->intensity;
+      }
+      else
+      {
+        ((LASpoint10*)last_item)->intensity = last_intensity[m];
+      }
 
-    // decompress the classification ... if it has changed
-    if (changed_values & 8)
-    {
-      if (m_classification[last_item[15]] == 0)
+      // decompress the classification ... if it has changed
+      if (changed_values & 8)
       {
-        m_classification[last_item[15]] = dec->createSymbolModel(256);
-        dec->initSymbolModel(m_classification[last_item[15]]);
+        if (m_classification[last_item[15]] == 0)
+        {
+          m_classification[last_item[15]] = dec_attributes->createSymbolModel(256);
+          dec_attributes->initSymbolModel(m_classification[last_item[15]]);
+        }
+        last_item[15] = (U8)dec_attributes->decodeSymbol(m_classification[last_item[15]]);
       }
-      last_item[15] = (U8)dec->decodeSymbol(m_classification[last_item[15]]);
-    }
     
-    // decompress the scan_angle_rank ... if it has changed
-    if (changed_values & 4)
-    {
-      I32 val = dec->decodeSymbol(m_scan_angle_rank[((LASpoint10*)last_item)->scan_direction_flag]);
-      last_item[16] = U8_FOLD(val + last_item[16]);
-    }
+      // decompress the scan_angle_rank ... if it has changed
+      if (changed_values & 4)
+      {
+        I32 val = dec_attributes->decodeSymbol(m_scan_angle_rank[((LASpoint10*)last_item)->scan_direction_flag]);
+        last_item[16] = U8_FOLD(val + last_item[16]);
+      }
 
-    // decompress the user_data ... if it has changed
-    if (changed_values & 2)
-    {
-      if (m_user_data[last_item[17]] == 0)
+      // decompress the user_data ... if it has changed
+      if (changed_values & 2)
       {
-        m_user_data[last_item[17]] = dec->createSymbolModel(256);
-        dec->initSymbolModel(m_user_data[last_item[17]]);
+        if (m_user_data[last_item[17]] == 0)
+        {
+          m_user_data[last_item[17]] = dec_attributes->createSymbolModel(256);
+          dec_attributes->initSymbolModel(m_user_data[last_item[17]]);
+        }
+        last_item[17] = (U8)dec_attributes->decodeSymbol(m_user_data[last_item[17]]);
       }
-      last_item[17] = (U8)dec->decodeSymbol(m_user_data[last_item[17]]);
-    }
 
-    // decompress the point_source_ID ... if it has changed
-    if (changed_values & 1)
-    {
-      ((LASpoint10*)last_item)->point_source_ID = (U16)ic_point_source_ID->decompress(((LASpoint10*)last_item)->point_source_ID);
+      // decompress the point_source_ID ... if it has changed
+      if (changed_values & 1)
+      {
+        ((LASpoint10*)last_item)->point_source_ID = (U16)ic_point_source_ID->decompress(((LASpoint10*)last_item)->point_source_ID);
+      }
     }
   }
   else
@@ -237,6 +266,36 @@ inline void LASreadItemCompressed_POINT10_v2::read(U8* item)
   memcpy(item, last_item, 20);
 }
 
+U32 LASreadItemCompressed_POINT10_v2::get_state_size() const
+{
+  return sizeof(last_item) + sizeof(last_intensity) + sizeof(last_x_diff_median5) + sizeof(last_y_diff_median5) + sizeof(last_height) + sizeof(m_bit_byte) + sizeof(m_classification) + sizeof(m_user_data);
+}
+
+U8* LASreadItemCompressed_POINT10_v2::save_state(U8* state) const
+{
+  state = save_bytes(state, last_item, sizeof(last_item));
+  state = save_bytes(state, last_intensity, sizeof(last_intensity));
+  state = save_bytes(state, last_x_diff_median5, sizeof(last_x_diff_median5));
+  state = save_bytes(state, last_y_diff_median5, sizeof(last_y_diff_median5));
+  state = save_bytes(state, last_height, sizeof(last_height));
+  // models created on demand after the checkpoint are created again
+  state = save_bytes(state, m_bit_byte, sizeof(m_bit_byte));
+  state = save_bytes(state, m_classification, sizeof(m_classification));
+  return save_bytes(state, m_user_data, sizeof(m_user_data));
+}
+
+const U8* LASreadItemCompressed_POINT10_v2::restore_state(const U8* state)
+{
+  state = restore_bytes(state, last_item, sizeof(last_item));
+  state = restore_bytes(state, last_intensity, sizeof(last_intensity));
+  state = restore_bytes(state, last_x_diff_median5, sizeof(last_x_diff_median5));
+  state = restore_bytes(state, last_y_diff_median5, sizeof(last_y_diff_median5));
+  state = restore_bytes(state, last_height, sizeof(last_height));
+  state = restore_bytes(state, m_bit_byte, sizeof(m_bit_byte));
+  state = restore_bytes(state, m_classification, sizeof(m_classification));
+  return restore_bytes(state, m_user_data, sizeof(m_user_data));
+}
+
 /*
 ===============================================================================
                        LASreadItemCompressed_GPSTIME11_v2
@@ -399,6 +458,29 @@ inline void LASreadItemCompressed_GPSTIME11_v2::read(U8* item)
   *((I64*)item) = last_gpstime[last].i64;
 }
 
+U32 LASreadItemCompressed_GPSTIME11_v2::get_state_size() const
+{
+  return sizeof(last) + sizeof(next) + sizeof(last_gpstime) + sizeof(last_gpstime_diff) + sizeof(multi_extreme_counter);
+}
+
+U8* LASreadItemCompressed_GPSTIME11_v2::save_state(U8* state) const
+{
+  state = save_bytes(state, &last, sizeof(last));
+  state = save_bytes(state, &next, sizeof(next));
+  state = save_bytes(state, last_gpstime, sizeof(last_gpstime));
+  state = save_bytes(state, last_gpstime_diff, sizeof(last_gpstime_diff));
+  return save_bytes(state, multi_extreme_counter, sizeof(multi_extreme_counter));
+}
+
+const U8* LASreadItemCompressed_GPSTIME11_v2::restore_state(const U8* state)
+{
+  state = restore_bytes(state, &last, sizeof(last));
+  state = restore_bytes(state, &next, sizeof(next));
+  state = restore_bytes(state, last_gpstime, sizeof(last_gpstime));
+  state = restore_bytes(state, last_gpstime_diff, sizeof(last_gpstime_diff));
+  return restore_bytes(state, multi_extreme_counter, sizeof(multi_extreme_counter));
+}
+
 /*
 ===============================================================================
                        LASreadItemCompressed_RGB12_v2
@@ -524,6 +606,387 @@ inline void LASreadItemCompressed_RGB12_v2::read(U8* item)
   memcpy(last_item, item, 6);
 }
 
+U32 LASreadItemCompressed_RGB12_v2::get_state_size() const
+{
+  return sizeof(last_item);
+}
+
+U8* LASreadItemCompressed_RGB12_v2::save_state(U8* state) const
+{
+  return save_bytes(state, last_item, sizeof(last_item));
+}
+
+const U8* LASreadItemCompressed_RGB12_v2::restore_state(const U8* state)
+{
+  return restore_bytes(state, last_item, sizeof(last_item));
+}
+
+/*
+===============================================================================
+                       LASreadItemCompressed_POINT14_v2
+===============================================================================
+*/
+
+struct LASpoint14
+{
+  I32 x;
+  I32 y;
+  I32 z;
+  U16 intensity;
+  U8 return_number : 4;
+  U8 number_of_returns_of_given_pulse : 4;
+  U8 classification_flags : 4;
+  U8 scanner_channel : 2;
+  U8 scan_direction_flag : 1;
+  U8 edge_of_flight_line : 1;
+  U8 classification;
+  U8 user_data;
+  I16 scan_angle;
+  U16 point_source_ID;
+};
+
+LASreadItemCompressed_POINT14_v2::LASreadItemCompressed_POINT14_v2(EntropyDecoder* dec, EntropyDecoder* dec_attributes, EntropyDecoder* dec_gpstime)
+{
+  U32 i;
+
+  /* set decoders (the attributes are skipped without one) */
+  assert(dec);
+  this->dec = dec;
+  this->dec_attributes = dec_attributes;
+
+  /* create models and integer compressors */
+  m_changed_values = dec->createSymbolModel(128);
+  if (dec_attributes)
+  {
+    ic_intensity = new IntegerCompressor(dec_attributes, 16, 4);
+    ic_scan_angle = new IntegerCompressor(dec_attributes, 16, 2);
+    ic_point_source_ID = new IntegerCompressor(dec_attributes, 16);
+  }
+  for (i = 0; i < 256; i++)
+  {
+    m_return_byte[i] = 0;
+    m_flag_byte[i] = 0;
+    m_classification[i] = 0;
+    m_user_data[i] = 0;
+  }
+  ic_dx = new IntegerCompressor(dec, 32, 2);  // 32 bits, 2 context
+  ic_dy = new IntegerCompressor(dec, 32, 22); // 32 bits, 22 contexts
+  ic_z = new IntegerCompressor(dec, 32, 20);  // 32 bits, 20 contexts
+
+  /* the gps time is compressed exactly like a GPSTIME11 item */
+  gpstime = (dec_gpstime ? new LASreadItemCompressed_GPSTIME11_v2(dec_gpstime) : 0);
+}
+
+LASreadItemCompressed_POINT14_v2::~LASreadItemCompressed_POINT14_v2()
+{
+  U32 i;
+
+  dec->destroySymbolModel(m_changed_values);
+  if (dec_attributes)
+  {
+    delete ic_intensity;
+    delete ic_scan_angle;
+    delete ic_point_source_ID;
+  }
+  for (i = 0; i < 256; i++)
+  {
+    if (m_return_byte[i]) dec->destroySymbolModel(m_return_byte[i]);
+    if (m_flag_byte[i]) dec_attributes->destroySymbolModel(m_flag_byte[i]);
+    if (m_classification[i]) dec_attributes->destroySymbolModel(m_classification[i]);
+    if (m_user_data[i]) dec_attributes->destroySymbolModel(m_user_data[i]);
+  }
+  delete ic_dx;
+  delete ic_dy;
+  delete ic_z;
+  if (gpstime) delete gpstime;
+}
+
+BOOL LASreadItemCompressed_POINT14_v2::init(const U8* item)
+{
+  U32 i;
+
+  /* init state */
+  for (i=0; i < 16; i++)
+  {
+    last_x_diff_median5[i].init();
+    last_y_diff_median5[i].init();
+    last_intensity[i] = 0;
+    last_height[i/2] = 0;
+  }
+
+  /* init models and integer compressors */
+  dec->initSymbolModel(m_changed_values);
+  if (dec_attributes)
+  {
+    ic_intensity->initDecompressor();
+    ic_scan_angle->initDecompressor();
+    ic_point_source_ID->initDecompressor();
+  }
+  for (i = 0; i < 256; i++)
+  {
+    if (m_return_byte[i]) dec->initSymbolModel(m_return_byte[i]);
+    if (m_flag_byte[i]) dec_attributes->initSymbolModel(m_flag_byte[i]);
+    if (m_classification[i]) dec_attributes->initSymbolModel(m_classification[i]);
+    if (m_user_data[i]) dec_attributes->initSymbolModel(m_user_data[i]);
+  }
+  ic_dx->initDecompressor();
+  ic_dy->initDecompressor();
+  ic_z->initDecompressor();
+  if (gpstime && !gpstime->init(item + 22)) return FALSE;
+
+  /* init last item (a skipped gps time keeps its first value) */
+  memcpy(last_item, item, 30);
+
+  /* but set intensity to zero (skipped attributes keep their first value) */ 
+  if (dec_attributes)
+  {
+    last_item[12] = 0;
+    last_item[13] = 0;
+  }
+
+  return TRUE;
+}
+
+inline void LASreadItemCompressed_POINT14_v2::read(U8* item)
+{
+  U32 r, n, m, l;
+  U32 k_bits;
+  I32 median, diff;
+
+  // decompress which other values have changed
+  I32 changed_values = dec->decodeSymbol(m_changed_values);
+
+  // decompress the return_number and number_of_returns_of_given_pulse if they have changed
+  if (changed_values & 64)
+  {
+    if (m_return_byte[last_item[14]] == 0)
+    {
+      m_return_byte[last_item[14]] = dec->createSymbolModel(256);
+      dec->initSymbolModel(m_return_byte[last_item[14]]);
+    }
+    last_item[14] = (U8)dec->decodeSymbol(m_return_byte[last_item[14]]);
+  }
+
+  // up to 15 returns share the contexts of the first 7
+  r = ((LASpoint14*)last_item)->return_number;
+  n = ((LASpoint14*)last_item)->number_of_returns_of_given_pulse;
+  m = number_return_map[n < 8 ? n : 7][r < 8 ? r : 7];
+  l = number_return_level[n < 8 ? n : 7][r < 8 ? r : 7];
+
+  if (dec_attributes)
+  {
+    // decompress the classification_flags, scanner_channel, scan_direction_flag, ... if they have changed
+    if (changed_values & 32)
+    {
+      if (m_flag_byte[last_item[15]] == 0)
+      {
+        m_flag_byte[last_item[15]] = dec_attributes->createSymbolModel(256);
+        dec_attributes->initSymbolModel(m_flag_byte[last_item[15]]);
+      }
+      last_item[15] = (U8)dec_attributes->decodeSymbol(m_flag_byte[last_item[15]]);
+    }
+
+    // decompress the intensity if it has changed
+    if (changed_values & 16)
+    {
+      last_intensity[m] = (U16)ic_intensity->decompress(last_intensity[m], (m < 3 ? m : 3));
+    }
+    ((LASpoint14*)last_item)->intensity = last_intensity[m];
+
+    // decompress the classification ... if it has changed
+    if (changed_values & 8)
+    {
+      if (m_classification[last_item[16]] == 0)
+      {
+        m_classification[last_item[16]] = dec_attributes->createSymbolModel(256);
+        dec_attributes->initSymbolModel(m_classification[last_item[16]]);
+      }
+      last_item[16] = (U8)dec_attributes->decodeSymbol(m_classification[last_item[16]]);
+    }
+
+    // decompress the scan_angle ... if it has changed
+    if (changed_values & 4)
+    {
+      ((LASpoint14*)last_item)->scan_angle = (I16)(U16)ic_scan_angle->decompress((U16)((LASpoint14*)last_item)->scan_angle, ((LASpoint14*)last_item)->scan_direction_flag);
+    }
+
+    // decompress the user_data ... if it has changed
+    if (changed_values & 2)
+    {
+      if (m_user_data[last_item[17]] == 0)
+      {
+        m_user_data[last_item[17]] = dec_attributes->createSymbolModel(256);
+        dec_attributes->initSymbolModel(m_user_data[last_item[17]]);
+      }
+      last_item[17] = (U8)dec_attributes->decodeSymbol(m_user_data[last_item[17]]);
+    }
+
+    // decompress the point_source_ID ... if it has changed
+    if (changed_values & 1)
+    {
+      ((LASpoint14*)last_item)->point_source_ID = (U16)ic_point_source_ID->decompress(((LASpoint14*)last_item)->point_source_ID);
+    }
+  }
+
+  // decompress x coordinate
+  median = last_x_diff_median5[m].get();
+  diff = ic_dx->decompress(median, n==1);
+  ((LASpoint14*)last_item)->x += diff;
+  last_x_diff_median5[m].add(diff);
+
+  // decompress y coordinate
+  median = last_y_diff_median5[m].get();
+  k_bits = ic_dx->getK();
+  diff = ic_dy->decompress(median, (n==1) + ( k_bits < 20 ? U32_ZERO_BIT_0(k_bits) : 20 ));
+  ((LASpoint14*)last_item)->y += diff;
+  last_y_diff_median5[m].add(diff);
+
+  // decompress z coordinate
+  k_bits = (ic_dx->getK() + ic_dy->getK()) / 2;
+  ((LASpoint14*)last_item)->z = ic_z->decompress(last_height[l], (n==1) + (k_bits < 18 ? U32_ZERO_BIT_0(k_bits) : 18));
+  last_height[l] = ((LASpoint14*)last_item)->z;
+
+  // copy the last point
+  if (gpstime)
+  {
+    memcpy(item, last_item, 22);
+
+    // decompress the gps_time
+    gpstime->LASreadItemCompressed_GPSTIME11_v2::read(item + 22);
+  }
+  else
+  {
+    memcpy(item, last_item, 30);
+  }
+}
+
+U32 LASreadItemCompressed_POINT14_v2::get_state_size() const
+{
+  U32 size = sizeof(last_item) + sizeof(last_intensity) + sizeof(last_x_diff_median5) + sizeof(last_y_diff_median5) + sizeof(last_height) + sizeof(m_return_byte) + sizeof(m_flag_byte) + sizeof(m_classification) + sizeof(m_user_data);
+  if (gpstime) size += gpstime->get_state_size();
+  return size;
+}
+
+U8* LASreadItemCompressed_POINT14_v2::save_state(U8* state) const
+{
+  state = save_bytes(state, last_item, sizeof(last_item));
+  state = save_bytes(state, last_intensity, sizeof(last_intensity));
+  state = save_bytes(state, last_x_diff_median5, sizeof(last_x_diff_median5));
+  state = save_bytes(state, last_y_diff_median5, sizeof(last_y_diff_median5));
+  state = save_bytes(state, last_height, sizeof(last_height));
+  // models created on demand after the checkpoint are created again
+  state = save_bytes(state, m_return_byte, sizeof(m_return_byte));
+  state = save_bytes(state, m_flag_byte, sizeof(m_flag_byte));
+  state = save_bytes(state, m_classification, sizeof(m_classification));
+  state = save_bytes(state, m_user_data, sizeof(m_user_data));
+  if (gpstime) state = gpstime->save_state(state);
+  return state;
+}
+
+const U8* LASreadItemCompressed_POINT14_v2::restore_state(const U8* state)
+{
+  state = restore_bytes(state, last_item, sizeof(last_item));
+  state = restore_bytes(state, last_intensity, sizeof(last_intensity));
+  state = restore_bytes(state, last_x_diff_median5, sizeof(last_x_diff_median5));
+  state = restore_bytes(state, last_y_diff_median5, sizeof(last_y_diff_median5));
+  state = restore_bytes(state, last_height, sizeof(last_height));
+  state = restore_bytes(state, m_return_byte, sizeof(m_return_byte));
+  state = restore_bytes(state, m_flag_byte, sizeof(m_flag_byte));
+  state = restore_bytes(state, m_classification, sizeof(m_classification));
+  state = restore_bytes(state, m_user_data, sizeof(m_user_data));
+  if (gpstime) state = gpstime->restore_state(state);
+  return state;
+}
+
+/*
+===============================================================================
+                       LASreadItemCompressed_RGBNIR14_v2
+===============================================================================
+*/
+
+LASreadItemCompressed_RGBNIR14_v2::LASreadItemCompressed_RGBNIR14_v2(EntropyDecoder* dec)
+{
+  /* set decoder */
+  assert(dec);
+  this->dec = dec;
+
+  /* the RGB part is compressed exactly like a RGB12 item */
+  rgb = new LASreadItemCompressed_RGB12_v2(dec);
+
+  /* create models and integer compressors */
+  m_nir_byte_used = dec->createSymbolModel(4);
+  m_nir_diff_0 = dec->createSymbolModel(256);
+  m_nir_diff_1 = dec->createSymbolModel(256);
+}
+
+LASreadItemCompressed_RGBNIR14_v2::~LASreadItemCompressed_RGBNIR14_v2()
+{
+  delete rgb;
+  dec->destroySymbolModel(m_nir_byte_used);
+  dec->destroySymbolModel(m_nir_diff_0);
+  dec->destroySymbolModel(m_nir_diff_1);
+}
+
+BOOL LASreadItemCompressed_RGBNIR14_v2::init(const U8* item)
+{
+  /* init state */
+  if (!rgb->init(item)) return FALSE;
+
+  /* init models and integer compressors */
+  dec->initSymbolModel(m_nir_byte_used);
+  dec->initSymbolModel(m_nir_diff_0);
+  dec->initSymbolModel(m_nir_diff_1);
+
+  /* init last item */
+  last_nir = ((U16*)item)[3];
+  return TRUE;
+}
+
+inline void LASreadItemCompressed_RGBNIR14_v2::read(U8* item)
+{
+  U8 corr;
+  U16 nir;
+  rgb->LASreadItemCompressed_RGB12_v2::read(item);
+  U32 sym = dec->decodeSymbol(m_nir_byte_used);
+  if (sym & (1 << 0))
+  {
+    corr = dec->decodeSymbol(m_nir_diff_0);
+    nir = (U16)U8_FOLD(corr + (last_nir&255));
+  }
+  else
+  {
+    nir = last_nir&0xFF;
+  }
+  if (sym & (1 << 1))
+  {
+    corr = dec->decodeSymbol(m_nir_diff_1);
+    nir |= (((U16)U8_FOLD(corr + (last_nir>>8))) << 8);
+  }
+  else
+  {
+    nir |= (last_nir&0xFF00);
+  }
+  ((U16*)item)[3] = nir;
+  last_nir = nir;
+}
+
+U32 LASreadItemCompressed_RGBNIR14_v2::get_state_size() const
+{
+  return sizeof(last_nir) + rgb->get_state_size();
+}
+
+U8* LASreadItemCompressed_RGBNIR14_v2::save_state(U8* state) const
+{
+  state = save_bytes(state, &last_nir, sizeof(last_nir));
+  return rgb->save_state(state);
+}
+
+const U8* LASreadItemCompressed_RGBNIR14_v2::restore_state(const U8* state)
+{
+  state = restore_bytes(state, &last_nir, sizeof(last_nir));
+  return rgb->restore_state(state);
+}
+
 /*
 ===============================================================================
                        LASreadItemCompressed_BYTE_v2
@@ -589,3 +1052,131 @@ inline void LASreadItemCompressed_BYTE_v2::read(U8* item)
   }
   memcpy(last_item, item, number);
 }
+
+U32 LASreadItemCompressed_BYTE_v2::get_state_size() const
+{
+  return number;
+}
+
+U8* LASreadItemCompressed_BYTE_v2::save_state(U8* state) const
+{
+  return save_bytes(state, last_item, number);
+}
+
+const U8* LASreadItemCompressed_BYTE_v2::restore_state(const U8* state)
+{
+  return restore_bytes(state, last_item, number);
+}
+
+#ifdef LASZIP_INSTRUMENT
+#define LASZIP_COUNT_FUSED(i, read_item) LASZIP_COUNT(positions, counters, i, read_item)
+#define LASZIP_COUNT_LANE(lane, i, read_item) LASZIP_COUNT(lane->positions, lane->counters, i, read_item)
+#else
+#define LASZIP_COUNT_FUSED(i, read_item) read_item
+#define LASZIP_COUNT_LANE(lane, i, read_item) read_item
+#endif
+
+// the item readers are called directly so that they can be inlined
+template <BOOL GPSTIME, BOOL RGB>
+class LASreadFusedCompressed_POINT10_v2 : public LASreadFusedCompressed_v2
+{
+public:
+
+  LASreadFusedCompressed_POINT10_v2(LASreadItem** readers)
+  {
+    point10 = (LASreadItemCompressed_POINT10_v2*)readers[0];
+    gpstime11 = (GPSTIME ? (LASreadItemCompressed_GPSTIME11_v2*)readers[1] : 0);
+    rgb12 = (RGB ? (LASreadItemCompressed_RGB12_v2*)readers[GPSTIME ? 2 : 1] : 0);
+  }
+
+  void read(U8* const * point)
+  {
+    LASZIP_COUNT_FUSED(0, point10->LASreadItemCompressed_POINT10_v2::read(point[0]));
+    if (GPSTIME) LASZIP_COUNT_FUSED(1, gpstime11->LASreadItemCompressed_GPSTIME11_v2::read(point[1]));
+    if (RGB) LASZIP_COUNT_FUSED((GPSTIME ? 2 : 1), rgb12->LASreadItemCompressed_RGB12_v2::read(point[GPSTIME ? 2 : 1]));
+  }
+
+  U32 read(U8* points, const U32 count, const U32 stride)
+  {
+    U32 i = 0;
+    try
+    {
+      for (; i < count; i++)
+      {
+        LASZIP_COUNT_FUSED(0, point10->LASreadItemCompressed_POINT10_v2::read(points));
+        if (GPSTIME) LASZIP_COUNT_FUSED(1, gpstime11->LASreadItemCompressed_GPSTIME11_v2::read(points + 20));
+        if (RGB) LASZIP_COUNT_FUSED((GPSTIME ? 2 : 1), rgb12->LASreadItemCompressed_RGB12_v2::read(points + (GPSTIME ? 28 : 20)));
+        points += stride;
+      }
+    }
+    catch (...)
+    {
+      // the point that was being read when the stream ended is incomplete
+    }
+    return i;
+  }
+
+  void read(LASreadFusedCompressed_v2* const * lanes, const U32 num_lanes, U8** points, const U32 count, const U32 stride)
+  {
+    U32 i, l;
+    LASreadFusedCompressed_POINT10_v2* lane[LASZIP_INTERLEAVE_CHUNKS_MAX];
+    U8* point[LASZIP_INTERLEAVE_CHUNKS_MAX];
+    for (l = 0; l < num_lanes; l++)
+    {
+      lane[l] = (LASreadFusedCompressed_POINT10_v2*)lanes[l];
+      point[l] = points[l];
+    }
+    for (i = 0; i < count; i++)
+    {
+      for (l = 0; l < num_lanes; l++)
+      {
+        LASZIP_COUNT_LANE(lane[l], 0, lane[l]->point10->LASreadItemCompressed_POINT10_v2::read(point[l]));
+        if (GPSTIME) LASZIP_COUNT_LANE(lane[l], 1, lane[l]->gpstime11->LASreadItemCompressed_GPSTIME11_v2::read(point[l] + 20));
+        if (RGB) LASZIP_COUNT_LANE(lane[l], (GPSTIME ? 2 : 1), lane[l]->rgb12->LASreadItemCompressed_RGB12_v2::read(point[l] + (GPSTIME ? 28 : 20)));
+        point[l] += stride;
+      }
+    }
+    for (l = 0; l < num_lanes; l++) points[l] = point[l];
+  }
+
+private:
+  LASreadItemCompressed_POINT10_v2* point10;
+  LASreadItemCompressed_GPSTIME11_v2* gpstime11;
+  LASreadItemCompressed_RGB12_v2* rgb12;
+};
+
+LASreadFusedCompressed_v2* LASreadFusedCompressed_v2::create(const U32 num_items, const LASitem* items, LASreadItem** readers)
+{
+  U32 i = 0;
+  BOOL gpstime = FALSE;
+  BOOL rgb = FALSE;
+
+  if (num_items == 0 || items[0].type != LASitem::POINT10 || items[0].version != 2) return 0;
+  i++;
+  if (i < num_items && items[i].type == LASitem::GPSTIME11 && items[i].version == 2)
+  {
+    gpstime = TRUE;
+    i++;
+  }
+  if (i < num_items && items[i].type == LASitem::RGB12 && items[i].version == 2)
+  {
+    rgb = TRUE;
+    i++;
+  }
+  if (i != num_items) return 0;
+
+  if (gpstime)
+  {
+    if (rgb)
+      return new LASreadFusedCompressed_POINT10_v2<TRUE, TRUE>(readers);
+    else
+      return new LASreadFusedCompressed_POINT10_v2<TRUE, FALSE>(readers);
+  }
+  else
+  {
+    if (rgb)
+      return new LASreadFusedCompressed_POINT10_v2<FALSE, TRUE>(readers);
+    else
+      return new LASreadFusedCompressed_POINT10_v2<FALSE, FALSE>(readers);
+  }
+}
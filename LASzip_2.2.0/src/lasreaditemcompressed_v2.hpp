@@ -24,6 +24,13 @@
   
   CHANGE HISTORY:
   
+    17 October 2026 -- the fused reader can decode several chunks in lock-step
+    17 October 2026 -- the fused reader returns how many points of a run it read
+    17 October 2026 -- the fused reader can count each of its items (LASZIP_INSTRUMENT)
+    17 October 2026 -- the context of the items can be saved for seek checkpoints
+    17 October 2026 -- attributes (and POINT14 gps time) may use their own decoders
+    17 October 2026 -- compressed POINT14 and RGBNIR14 for LAS 1.4 point types
+    17 October 2026 -- fused reader for POINT10 with GPSTIME11 and/or RGB12
     5 March 2011 -- created first night in ibiza to improve the RGB compressor
   
 ===============================================================================
@@ -36,20 +43,28 @@
 #include "integercompressor.hpp"
 
 #include "laszip_common_v2.hpp"
+#include "laszip.hpp"
+#include "lasinstrument.hpp"
 
 class LASreadItemCompressed_POINT10_v2 : public LASreadItemCompressed
 {
 public:
 
-  LASreadItemCompressed_POINT10_v2(EntropyDecoder* dec);
+  // the attributes are decoded with their own decoder (or skipped if it is 0)
+  LASreadItemCompressed_POINT10_v2(EntropyDecoder* dec, EntropyDecoder* dec_attributes);
 
   BOOL init(const U8* item);
   void read(U8* item);
 
+  U32 get_state_size() const;
+  U8* save_state(U8* state) const;
+  const U8* restore_state(const U8* state);
+
   ~LASreadItemCompressed_POINT10_v2();
 
 private:
   EntropyDecoder* dec;
+  EntropyDecoder* dec_attributes;
   U8 last_item[20];
   U16 last_intensity[16];
   StreamingMedian5 last_x_diff_median5[16];
@@ -77,6 +92,10 @@ public:
   BOOL init(const U8* item);
   void read(U8* item);
 
+  U32 get_state_size() const;
+  U8* save_state(U8* state) const;
+  const U8* restore_state(const U8* state);
+
   ~LASreadItemCompressed_GPSTIME11_v2();
 
 private:
@@ -100,6 +119,10 @@ public:
   BOOL init(const U8* item);
   void read(U8* item);
 
+  U32 get_state_size() const;
+  U8* save_state(U8* state) const;
+  const U8* restore_state(const U8* state);
+
   ~LASreadItemCompressed_RGB12_v2();
 
 private:
@@ -115,6 +138,70 @@ private:
   EntropyModel* m_rgb_diff_5;
 };
 
+class LASreadItemCompressed_POINT14_v2 : public LASreadItemCompressed
+{
+public:
+
+  // the attributes and the gps time are decoded with their own decoders (or skipped if they are 0)
+  LASreadItemCompressed_POINT14_v2(EntropyDecoder* dec, EntropyDecoder* dec_attributes, EntropyDecoder* dec_gpstime);
+
+  BOOL init(const U8* item);
+  void read(U8* item);
+
+  U32 get_state_size() const;
+  U8* save_state(U8* state) const;
+  const U8* restore_state(const U8* state);
+
+  ~LASreadItemCompressed_POINT14_v2();
+
+private:
+  EntropyDecoder* dec;
+  EntropyDecoder* dec_attributes;
+  U8 last_item[30];
+  U16 last_intensity[16];
+  StreamingMedian5 last_x_diff_median5[16];
+  StreamingMedian5 last_y_diff_median5[16];
+  I32 last_height[8];
+
+  EntropyModel* m_changed_values;
+  IntegerCompressor* ic_intensity;
+  IntegerCompressor* ic_scan_angle;
+  IntegerCompressor* ic_point_source_ID;
+  EntropyModel* m_return_byte[256];
+  EntropyModel* m_flag_byte[256];
+  EntropyModel* m_classification[256];
+  EntropyModel* m_user_data[256];
+  IntegerCompressor* ic_dx;
+  IntegerCompressor* ic_dy;
+  IntegerCompressor* ic_z;
+  LASreadItemCompressed_GPSTIME11_v2* gpstime;
+};
+
+class LASreadItemCompressed_RGBNIR14_v2 : public LASreadItemCompressed
+{
+public:
+
+  LASreadItemCompressed_RGBNIR14_v2(EntropyDecoder* dec);
+
+  BOOL init(const U8* item);
+  void read(U8* item);
+
+  U32 get_state_size() const;
+  U8* save_state(U8* state) const;
+  const U8* restore_state(const U8* state);
+
+  ~LASreadItemCompressed_RGBNIR14_v2();
+
+private:
+  EntropyDecoder* dec;
+  U16 last_nir;
+
+  EntropyModel* m_nir_byte_used;
+  EntropyModel* m_nir_diff_0;
+  EntropyModel* m_nir_diff_1;
+  LASreadItemCompressed_RGB12_v2* rgb;
+};
+
 class LASreadItemCompressed_BYTE_v2 : public LASreadItemCompressed
 {
 public:
@@ -124,6 +211,10 @@ public:
   BOOL init(const U8* item);
   void read(U8* item);
 
+  U32 get_state_size() const;
+  U8* save_state(U8* state) const;
+  const U8* restore_state(const U8* state);
+
   ~LASreadItemCompressed_BYTE_v2();
 
 private:
@@ -134,4 +225,30 @@ private:
   EntropyModel** m_byte;
 };
 
+class LASreadFusedCompressed_v2
+{
+public:
+
+  // returns 0 unless the items are POINT10 followed by GPSTIME11 and/or RGB12 (all version 2)
+  static LASreadFusedCompressed_v2* create(const U32 num_items, const LASitem* items, LASreadItem** readers);
+
+  virtual void read(U8* const * point)=0;
+  // returns how many of the points were read completely (fewer if the stream ended)
+  virtual U32 read(U8* points, const U32 count, const U32 stride)=0;
+  // reads count points into every points[lane] with one point of every lane in
+  // turn from fused readers of the same items (throws if a stream ends) so that
+  // the dependency chains of the independent lanes overlap in the processor
+  virtual void read(LASreadFusedCompressed_v2* const * lanes, const U32 num_lanes, U8** points, const U32 count, const U32 stride)=0;
+
+  virtual ~LASreadFusedCompressed_v2(){};
+
+#ifdef LASZIP_INSTRUMENT
+  // every item is still counted on its own
+  void count(const LASitemPositions* positions, LASitemCounters* counters) { this->positions = positions; this->counters = counters; };
+protected:
+  const LASitemPositions* positions;
+  LASitemCounters* counters;
+#endif
+};
+
 #endif
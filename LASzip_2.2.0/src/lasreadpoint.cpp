@@ -32,13 +32,54 @@
 #include "lasreadpoint.hpp"
 
 #include "arithmeticdecoder.hpp"
+#include "ransdecoder.hpp"
 #include "lasreaditemraw.hpp"
 #include "lasreaditemcompressed_v1.hpp"
 #include "lasreaditemcompressed_v2.hpp"
+#include "bytestreamin_array.hpp"
 
 #include <stdlib.h>
 #include <string.h>
 
+// how many uncompressed points are read from the stream at once
+#define LASZIP_RAW_BLOCK_POINTS 4096
+
+#ifdef LASZIP_INSTRUMENT
+// reads an item and counts its cycles and bytes
+#define LASZIP_COUNT_ITEM(i, read_item) LASZIP_COUNT(this, counters, i, read_item)
+#else
+#define LASZIP_COUNT_ITEM(i, read_item) read_item
+#endif
+
+// stands in for an item whose layers are not decompressed and repeats the
+// value the item had at the start of the chunk
+class LASreadItemCompressed_SKIPPED : public LASreadItemCompressed
+{
+public:
+  LASreadItemCompressed_SKIPPED(const U32 size)
+  {
+    this->size = size;
+    first_item = new U8[size];
+  };
+  BOOL init(const U8* item)
+  {
+    memcpy(first_item, item, size);
+    return TRUE;
+  };
+  void read(U8* item)
+  {
+    memcpy(item, first_item, size);
+  };
+  U32 get_state_size() const { return 0; };
+  ~LASreadItemCompressed_SKIPPED()
+  {
+    delete [] first_item;
+  };
+private:
+  U32 size;
+  U8* first_item;
+};
+
 LASreadPoint::LASreadPoint()
 {
   point_size = 0;
@@ -47,7 +88,16 @@ LASreadPoint::LASreadPoint()
   readers = 0;
   readers_raw = 0;
   readers_compressed = 0;
+  fused = 0;
   dec = 0;
+  laszip = 0;
+  // used for layered decompression
+  num_layers = 0;
+  layer_decs = 0;
+  layer_streams = 0;
+  layer_buffers = 0;
+  layer_alloced = 0;
+  layer_sizes = 0;
   // used for chunking
   chunk_size = U32_MAX;
   chunk_count = 0;
@@ -56,12 +106,56 @@ LASreadPoint::LASreadPoint()
   tabled_chunks = 0;
   chunk_totals = 0;
   chunk_starts = 0;
+  indexed_chunks = 0;
+  // used for chunk summaries
+  summary_contents = LASZIP_CHUNK_SUMMARY_NONE;
+  chunk_bounds = 0;
+  chunk_classifications = 0;
+  chunk_return_numbers = 0;
+  chunk_gps_times = 0;
+  chunk_intensities = 0;
   // used for seeking
   point_start = 0;
   seek_point = 0;
+  checkpoint_interval = 0;
+  checkpoint_chunk = 0;
+  num_checkpoints = 0;
+  alloced_checkpoints = 0;
+  checkpoints = 0;
+  checkpoint_sizes = 0;
+  // used for batch reading
+  item_offsets = 0;
+  batch_point = 0;
+  // used for block reading
+  raw_copy = FALSE;
+  raw_block = 0;
+  raw_stream = 0;
+  // used for interleaved decoding
+  num_lanes = 0;
+  lanes = 0;
+  lane_streams = 0;
+  lane_buffers = 0;
+  lane_alloced = 0;
+#ifdef LASZIP_INSTRUMENT
+  counters = 0;
+  item_layers = 0;
+#endif
 }
 
-BOOL LASreadPoint::setup(U32 num_items, const LASitem* items, const LASzip* laszip)
+EntropyDecoder* LASreadPoint::create_decoder() const
+{
+  switch (laszip->coder)
+  {
+  case LASZIP_CODER_ARITHMETIC:
+    return new ArithmeticDecoder();
+  case LASZIP_CODER_RANS:
+    return new RANSDecoder();
+  }
+  // entropy decoder not supported
+  return 0;
+}
+
+BOOL LASreadPoint::setup(U32 num_items, const LASitem* items, const LASzip* laszip, const U32 decompress_selective)
 {
   U32 i;
 
@@ -72,19 +166,14 @@ BOOL LASreadPoint::setup(U32 num_items, const LASitem* items, const LASzip* lasz
     if (items != laszip->items) return FALSE;
   }
 
+  this->laszip = laszip;
+
   // create entropy decoder (if requested)
   dec = 0;
   if (laszip && laszip->compressor)
   {
-    switch (laszip->coder)
-    {
-    case LASZIP_CODER_ARITHMETIC:
-      dec = new ArithmeticDecoder();
-      break;
-    default:
-      // entropy decoder not supported
-      return FALSE;
-    }
+    dec = create_decoder();
+    if (dec == 0) return FALSE;
   }
  
   // initizalize the readers
@@ -94,8 +183,14 @@ BOOL LASreadPoint::setup(U32 num_items, const LASitem* items, const LASzip* lasz
   // disable chunking
   chunk_size = U32_MAX;
 
+#ifdef LASZIP_INSTRUMENT
+  if (counters) delete [] counters;
+  counters = new LASitemCounters[num_readers];
+#endif
+
   // always create the raw readers
   readers_raw = new LASreadItem*[num_readers];
+  raw_copy = IS_LITTLE_ENDIAN();
   for (i = 0; i < num_readers; i++)
   {
     switch (items[i].type)
@@ -129,7 +224,16 @@ BOOL LASreadPoint::setup(U32 num_items, const LASitem* items, const LASzip* lasz
       break;
     case LASitem::POINT14:
       if (IS_LITTLE_ENDIAN())
-        readers_raw[i] = new LASreadItemRaw_POINT14_LE();
+      {
+        // our own compressor works on the plain LAS 1.4 record
+        if (items[i].version == LASZIP_ITEM14_VERSION)
+          readers_raw[i] = new LASreadItemRaw_BYTE(30);
+        else
+        {
+          readers_raw[i] = new LASreadItemRaw_POINT14_LE();
+          raw_copy = FALSE;
+        }
+      }
       else
         return FALSE;
       break;
@@ -145,6 +249,69 @@ BOOL LASreadPoint::setup(U32 num_items, const LASitem* items, const LASzip* lasz
     point_size += items[i].size;
   }
 
+  // where each item goes in an interleaved batch of points
+  if (item_offsets) delete [] item_offsets;
+  item_offsets = new U32[num_readers];
+  if (batch_point) delete [] batch_point;
+  batch_point = new U8*[num_readers];
+  item_offsets[0] = 0;
+  for (i = 1; i < num_readers; i++)
+  {
+    item_offsets[i] = item_offsets[i-1] + items[i-1].size;
+  }
+
+  // the layered decompressor gives each selected layer its own decoder
+  U32 l, layer = 0;
+  U32 selective[LASZIP_LAYERS_PER_ITEM_MAX];
+  BOOL skipped = FALSE;
+  if (dec && laszip->compressor == LASZIP_COMPRESSOR_LAYERED_CHUNKED)
+  {
+    num_layers = 0;
+    for (i = 0; i < num_readers; i++)
+    {
+      if (items[i].version < 2 && items[i].type != LASitem::WAVEPACKET13) return FALSE;
+      num_layers += get_layers_v2(&items[i], selective);
+    }
+    layer_decs = new EntropyDecoder*[num_layers];
+    layer_streams = new ByteStreamInArray*[num_layers];
+    layer_buffers = new U8*[num_layers];
+    layer_alloced = new U32[num_layers];
+    layer_sizes = new U32[num_layers];
+#ifdef LASZIP_INSTRUMENT
+    item_layers = new U32[num_readers+1];
+#endif
+    for (i = 0; i < num_readers; i++)
+    {
+      U32 number = get_layers_v2(&items[i], selective);
+#ifdef LASZIP_INSTRUMENT
+      item_layers[i] = layer;
+#endif
+      for (l = 0; l < number; l++)
+      {
+        if ((selective[l] == LASZIP_DECOMPRESS_SELECTIVE_XYZ) || (selective[l] & decompress_selective))
+        {
+          layer_decs[layer] = create_decoder();
+          if (IS_LITTLE_ENDIAN())
+            layer_streams[layer] = new ByteStreamInArrayLE(0, 0);
+          else
+            layer_streams[layer] = new ByteStreamInArrayBE(0, 0);
+        }
+        else
+        {
+          layer_decs[layer] = 0;
+          layer_streams[layer] = 0;
+        }
+        layer_buffers[layer] = 0;
+        layer_alloced[layer] = 0;
+        layer++;
+      }
+    }
+#ifdef LASZIP_INSTRUMENT
+    item_layers[num_readers] = layer;
+#endif
+    layer = 0;
+  }
+
   if (dec)
   {
     readers_compressed = new LASreadItem*[num_readers];
@@ -160,52 +327,83 @@ BOOL LASreadPoint::setup(U32 num_items, const LASitem* items, const LASzip* lasz
     if (!seek_point[0]) return FALSE;
     for (i = 0; i < num_readers; i++)
     {
+      // every layer of the item has its own decoder unless it is pointwise
+      EntropyDecoder* decs[LASZIP_LAYERS_PER_ITEM_MAX] = { dec, dec, dec };
+      if (layer_decs)
+      {
+        U32 number = get_layers_v2(&items[i], selective);
+        for (l = 0; l < number; l++) decs[l] = layer_decs[layer++];
+      }
+      if (i) seek_point[i] = seek_point[i-1]+items[i-1].size;
+      if (decs[0] == 0)
+      {
+        readers_compressed[i] = new LASreadItemCompressed_SKIPPED(items[i].size);
+        skipped = TRUE;
+        continue;
+      }
       switch (items[i].type)
       {
       case LASitem::POINT10:
         if (items[i].version == 1)
-          readers_compressed[i] = new LASreadItemCompressed_POINT10_v1(dec);
+          readers_compressed[i] = new LASreadItemCompressed_POINT10_v1(decs[0]);
         else if (items[i].version == 2)
-          readers_compressed[i] = new LASreadItemCompressed_POINT10_v2(dec);
+          readers_compressed[i] = new LASreadItemCompressed_POINT10_v2(decs[0], decs[1]);
         else
           return FALSE;
         break;
       case LASitem::GPSTIME11:
         if (items[i].version == 1)
-          readers_compressed[i] = new LASreadItemCompressed_GPSTIME11_v1(dec);
+          readers_compressed[i] = new LASreadItemCompressed_GPSTIME11_v1(decs[0]);
         else if (items[i].version == 2)
-          readers_compressed[i] = new LASreadItemCompressed_GPSTIME11_v2(dec);
+          readers_compressed[i] = new LASreadItemCompressed_GPSTIME11_v2(decs[0]);
         else
           return FALSE;
         break;
       case LASitem::RGB12:
         if (items[i].version == 1)
-          readers_compressed[i] = new LASreadItemCompressed_RGB12_v1(dec);
+          readers_compressed[i] = new LASreadItemCompressed_RGB12_v1(decs[0]);
         else if (items[i].version == 2)
-          readers_compressed[i] = new LASreadItemCompressed_RGB12_v2(dec);
+          readers_compressed[i] = new LASreadItemCompressed_RGB12_v2(decs[0]);
         else
           return FALSE;
         break;
       case LASitem::WAVEPACKET13:
         if (items[i].version == 1)
-          readers_compressed[i] = new LASreadItemCompressed_WAVEPACKET13_v1(dec);
+          readers_compressed[i] = new LASreadItemCompressed_WAVEPACKET13_v1(decs[0]);
         else
           return FALSE;
         break;
       case LASitem::BYTE:
         if (items[i].version == 1)
-          readers_compressed[i] = new LASreadItemCompressed_BYTE_v1(dec, items[i].size);
+          readers_compressed[i] = new LASreadItemCompressed_BYTE_v1(decs[0], items[i].size);
         else if (items[i].version == 2)
-          readers_compressed[i] = new LASreadItemCompressed_BYTE_v2(dec, items[i].size);
+          readers_compressed[i] = new LASreadItemCompressed_BYTE_v2(decs[0], items[i].size);
+        else
+          return FALSE;
+        break;
+      case LASitem::POINT14:
+        if (items[i].version == LASZIP_ITEM14_VERSION)
+          readers_compressed[i] = new LASreadItemCompressed_POINT14_v2(decs[0], decs[1], decs[2]);
+        else
+          return FALSE;
+        break;
+      case LASitem::RGBNIR14:
+        if (items[i].version == LASZIP_ITEM14_VERSION)
+          readers_compressed[i] = new LASreadItemCompressed_RGBNIR14_v2(decs[0]);
         else
           return FALSE;
         break;
       default:
         return FALSE;
       }
-      if (i) seek_point[i] = seek_point[i-1]+items[i-1].size;
     }
-    if (laszip->compressor == LASZIP_COMPRESSOR_POINTWISE_CHUNKED)
+    // the common point types are decoded by one fused reader
+    if (fused) delete fused;
+    fused = (skipped ? 0 : LASreadFusedCompressed_v2::create(num_readers, items, readers_compressed));
+#ifdef LASZIP_INSTRUMENT
+    if (fused) fused->count(this, counters);
+#endif
+    if ((laszip->compressor == LASZIP_COMPRESSOR_POINTWISE_CHUNKED) || (laszip->compressor == LASZIP_COMPRESSOR_LAYERED_CHUNKED))
     {
       if (laszip->chunk_size) chunk_size = laszip->chunk_size;
       number_chunks = U32_MAX;
@@ -214,6 +412,47 @@ BOOL LASreadPoint::setup(U32 num_items, const LASitem* items, const LASzip* lasz
   return TRUE;
 }
 
+BOOL LASreadPoint::set_checkpoint_interval(const U32 interval)
+{
+  // only compressed items can be restored
+  if (interval && (dec == 0)) return FALSE;
+  checkpoint_interval = interval;
+  num_checkpoints = 0;
+  return TRUE;
+}
+
+BOOL LASreadPoint::set_interleave(const U32 num_chunks)
+{
+  U32 l;
+  // only independently compressed chunks that the fused reader decodes can be decoded side by side
+  if (dec == 0 || fused == 0 || number_chunks != U32_MAX || num_chunks < 2) return TRUE;
+  if (lanes || num_chunks > LASZIP_INTERLEAVE_CHUNKS_MAX) return FALSE;
+  num_lanes = num_chunks;
+  lanes = new LASreadPoint*[num_lanes];
+  lane_streams = new ByteStreamInArray*[num_lanes];
+  lane_buffers = new U8*[num_lanes];
+  lane_alloced = new U32[num_lanes];
+  for (l = 0; l < num_lanes; l++)
+  {
+    lanes[l] = new LASreadPoint();
+    if (IS_LITTLE_ENDIAN())
+      lane_streams[l] = new ByteStreamInArrayLE(0, 0);
+    else
+      lane_streams[l] = new ByteStreamInArrayBE(0, 0);
+    lane_buffers[l] = 0;
+    lane_alloced[l] = 0;
+  }
+  for (l = 0; l < num_lanes; l++)
+  {
+    // the fused reader means that no layer is skipped
+    if (!lanes[l]->setup(laszip->num_items, laszip->items, laszip)) return FALSE;
+    // a lane decodes single chunks without a chunk table
+    lanes[l]->number_chunks = 0;
+    lanes[l]->chunk_size = U32_MAX;
+  }
+  return TRUE;
+}
+
 BOOL LASreadPoint::init(ByteStreamIn* instream)
 {
   if (!instream) return FALSE;
@@ -274,7 +513,7 @@ BOOL LASreadPoint::seek(const U32 current, const U32 target)
       {
         if (current_chunk < (tabled_chunks-1))
         {
-          dec->done();
+          done_coders();
           current_chunk = (tabled_chunks-1);
           instream->seek(chunk_starts[current_chunk]);
           init(instream);
@@ -284,20 +523,27 @@ BOOL LASreadPoint::seek(const U32 current, const U32 target)
       }
       else if (current_chunk != target_chunk || current > target)
       {
-        dec->done();
-        current_chunk = target_chunk;
-        instream->seek(chunk_starts[current_chunk]);
-        init(instream);
-        chunk_count = 0;
+        if (current_chunk != target_chunk || !restore_checkpoint(delta))
+        {
+          done_coders();
+          current_chunk = target_chunk;
+          instream->seek(chunk_starts[current_chunk]);
+          init(instream);
+          chunk_count = 0;
+        }
+        delta -= chunk_count;
       }
       else
       {
-        delta = target - current;
+        // a checkpoint may be closer than the current point
+        delta = chunk_count + (target - current);
+        restore_checkpoint(delta);
+        delta -= chunk_count;
       }
     }
     else if (current > target)
     {
-      dec->done();
+      done_coders();
       instream->seek(point_start);
       init(instream);
       delta = target;
@@ -309,6 +555,7 @@ BOOL LASreadPoint::seek(const U32 current, const U32 target)
     while (delta)
     {
       read(seek_point);
+      if (checkpoint_interval && chunk_starts) save_checkpoint();
       delta--;
     }
   }
@@ -333,7 +580,7 @@ BOOL LASreadPoint::read(U8* const * point)
       if (chunk_count == chunk_size)
       {
         current_chunk++;
-        dec->done();
+        done_coders();
         init(instream);
         if (tabled_chunks == current_chunk) // no or incomplete chunk table?
         {
@@ -353,29 +600,33 @@ BOOL LASreadPoint::read(U8* const * point)
       }
       chunk_count++;
 
-      if (readers)
+      if (fused && readers)
+      {
+        fused->read(point);
+      }
+      else if (readers)
       {
         for (i = 0; i < num_readers; i++)
         {
-          readers[i]->read(point[i]);
+          LASZIP_COUNT_ITEM(i, readers[i]->read(point[i]));
         }
       }
       else
       {
         for (i = 0; i < num_readers; i++)
         {
-          readers_raw[i]->read(point[i]);
+          LASZIP_COUNT_ITEM(i, readers_raw[i]->read(point[i]));
           ((LASreadItemCompressed*)(readers_compressed[i]))->init(point[i]);
         }
         readers = readers_compressed;
-        dec->init(instream);
+        init_coders();
       }
     }
     else
     {
       for (i = 0; i < num_readers; i++)
       {
-        readers[i]->read(point[i]);
+        LASZIP_COUNT_ITEM(i, readers[i]->read(point[i]));
       }
     }
   }
@@ -386,15 +637,871 @@ BOOL LASreadPoint::read(U8* const * point)
   return TRUE;
 }
 
+U32 LASreadPoint::read_batch(U8* dest, const U32 count, const U32 stride)
+{
+  U32 i, run;
+  U32 number = 0;
+
+  if (dec == 0 && readers) return read_raw_batch(dest, count, stride);
+
+  while (number < count)
+  {
+    if (lanes && (readers == 0 || chunk_count == chunk_size))
+    {
+      // whole chunks are decoded side by side
+      run = read_interleaved(dest, count - number, stride);
+      dest += (size_t)run*stride;
+      number += run;
+      if (run) continue;
+    }
+    if (readers == 0 || (dec && chunk_count == chunk_size))
+    {
+      // the first point of a chunk switches or initializes the readers
+      for (i = 0; i < num_readers; i++)
+      {
+        batch_point[i] = dest + item_offsets[i];
+      }
+      if (!read(batch_point)) break;
+      dest += stride;
+      number++;
+      continue;
+    }
+
+    // the remaining points of the chunk need no checks between them
+    run = count - number;
+    if (dec && (chunk_size - chunk_count) < run) run = chunk_size - chunk_count;
+
+    try
+    {
+      if (fused)
+      {
+        // only the points that were read completely are counted
+        U32 complete = fused->read(dest, run, stride);
+        chunk_count += complete;
+        dest += complete*stride;
+        number += complete;
+        if (complete < run) break;
+        run = 0;
+      }
+      while (run)
+      {
+        if (dec) chunk_count++;
+        for (i = 0; i < num_readers; i++)
+        {
+          LASZIP_COUNT_ITEM(i, readers[i]->read(dest + item_offsets[i]));
+        }
+        dest += stride;
+        number++;
+        run--;
+      }
+    }
+    catch (...)
+    {
+      break;
+    }
+  }
+  return number;
+}
+
+U32 LASreadPoint::read_interleaved(U8* dest, const U32 count, const U32 stride)
+{
+  U32 l, first;
+  U32 lane_points[LASZIP_INTERLEAVE_CHUNKS_MAX];
+  U8* lane_dest[LASZIP_INTERLEAVE_CHUNKS_MAX];
+  LASreadFusedCompressed_v2* lane_fused[LASZIP_INTERLEAVE_CHUNKS_MAX];
+  U32 number = 0;
+
+  // the chunk that begins next and how many of the following ones the batch
+  // holds whole (the last chunk of fixed size may be shorter than it says)
+  U32 chunk = (readers ? current_chunk + 1 : current_chunk);
+  U32 last = (chunk_totals ? number_chunks : number_chunks - 1);
+  U32 used = 0;
+  while (used < num_lanes && (chunk + used < last) && get_chunk(chunk + used, &first, &lane_points[used]))
+  {
+    if (lane_points[used] == 0 || number + lane_points[used] > count) break;
+    lane_dest[used] = dest + (size_t)number*stride;
+    lane_fused[used] = lanes[used]->fused;
+    number += lane_points[used];
+    used++;
+  }
+  if (used < 2) return 0;
+
+  // the current chunk is finished before its stream is moved
+  if (readers == readers_compressed) done_coders();
+
+  BOOL failed = FALSE;
+  U32 started = 0;
+  try
+  {
+    U32 fewest = U32_MAX;
+    for (l = 0; l < used && !failed; l++)
+    {
+      // the bytes of the chunk are decoded in place if the stream holds them
+      const U8* bytes;
+      U32 num_bytes = (U32)(chunk_starts[chunk+l+1] - chunk_starts[chunk+l]);
+      if (!instream->seek(chunk_starts[chunk+l]))
+      {
+        failed = TRUE;
+        break;
+      }
+      if (!(instream->isWindowStable() && (instream->getWindow(&bytes) >= num_bytes)))
+      {
+        if (lane_alloced[l] < num_bytes)
+        {
+          if (lane_buffers[l]) delete [] lane_buffers[l];
+          lane_buffers[l] = new U8[num_bytes];
+          lane_alloced[l] = num_bytes;
+        }
+        instream->getBytes(lane_buffers[l], num_bytes);
+        bytes = lane_buffers[l];
+      }
+      lane_streams[l]->init(bytes, num_bytes);
+      lanes[l]->init(lane_streams[l]);
+      started++;
+      // the first point of the chunk starts the decoders of the lane
+      if (lanes[l]->read_batch(lane_dest[l], 1, stride) != 1) failed = TRUE;
+      lane_dest[l] += stride;
+      lane_points[l]--;
+      if (lane_points[l] < fewest) fewest = lane_points[l];
+    }
+    if (!failed)
+    {
+      // the points that every chunk has go through one loop over all lanes
+      lane_fused[0]->read(lane_fused, used, lane_dest, fewest, stride);
+      // and the rest of the longer chunks lane by lane
+      for (l = 0; l < used && !failed; l++)
+      {
+        U32 rest = lane_points[l] - fewest;
+        if (rest && lanes[l]->read_batch(lane_dest[l], rest, stride) != rest) failed = TRUE;
+      }
+    }
+  }
+  catch (...)
+  {
+    failed = TRUE;
+  }
+  for (l = 0; l < started; l++)
+  {
+    lanes[l]->done();
+#ifdef LASZIP_INSTRUMENT
+    for (U32 i = 0; i < num_readers; i++)
+    {
+      counters[i].add(lanes[l]->counters[i]);
+      lanes[l]->counters[i].reset();
+    }
+#endif
+  }
+
+  if (failed)
+  {
+    // the chunks are decoded again one after the other (where they will fail)
+    start_chunk(chunk);
+    return 0;
+  }
+  // and otherwise continue as if they had been
+  start_chunk(chunk + used);
+  return number;
+}
+
+void LASreadPoint::start_chunk(const U32 chunk)
+{
+  current_chunk = chunk;
+  if (chunk_totals && current_chunk < number_chunks)
+  {
+    chunk_size = chunk_totals[current_chunk+1]-chunk_totals[current_chunk];
+  }
+  instream->seek(chunk_starts[current_chunk]);
+  init(instream);
+  chunk_count = 0;
+}
+
+U32 LASreadPoint::read_raw_batch(U8* dest, const U32 count, const U32 stride)
+{
+  U32 i, j, run, bytes;
+  U32 number = 0;
+  U8* block;
+  I64 start;
+  BOOL ended = FALSE;
+
+  while (number < count)
+  {
+#ifdef LASZIP_INSTRUMENT
+    I64 cycles = LASZIP_CYCLES();
+#endif
+    run = count - number;
+    if (run > LASZIP_RAW_BLOCK_POINTS) run = LASZIP_RAW_BLOCK_POINTS;
+    bytes = run*point_size;
+
+    // one read for the whole block (straight into the points if possible)
+    if (raw_copy && stride == point_size)
+    {
+      block = dest;
+    }
+    else
+    {
+      if (raw_block == 0)
+      {
+        raw_block = new U8[LASZIP_RAW_BLOCK_POINTS*point_size];
+        if (IS_LITTLE_ENDIAN())
+          raw_stream = new ByteStreamInArrayLE(0, 0);
+        else
+          raw_stream = new ByteStreamInArrayBE(0, 0);
+      }
+      block = raw_block;
+    }
+    start = instream->tell();
+    try
+    {
+      instream->getBytes(block, bytes);
+    }
+    catch (...)
+    {
+      // keep the whole points that were read before the end of the stream
+      I64 available = instream->tell() - start;
+      if (available < 0) available = 0;
+      if (available > bytes) available = bytes;
+      run = (U32)available/point_size;
+      bytes = run*point_size;
+      ended = TRUE;
+    }
+
+    if (block == raw_block)
+    {
+      // the raw readers convert the points out of the block
+      raw_stream->init(raw_block, bytes);
+      for (i = 0; i < num_readers; i++)
+      {
+        ((LASreadItemRaw*)(readers_raw[i]))->init(raw_stream);
+      }
+      for (j = 0; j < run; j++)
+      {
+        for (i = 0; i < num_readers; i++)
+        {
+          readers_raw[i]->read(dest + item_offsets[i]);
+        }
+        dest += stride;
+      }
+      for (i = 0; i < num_readers; i++)
+      {
+        ((LASreadItemRaw*)(readers_raw[i]))->init(instream);
+      }
+    }
+    else
+    {
+      dest += bytes;
+    }
+#ifdef LASZIP_INSTRUMENT
+    count_raw_batch(run, LASZIP_CYCLES() - cycles);
+#endif
+    number += run;
+    if (ended) break;
+  }
+  return number;
+}
+
 BOOL LASreadPoint::done()
 {
   if (readers == readers_compressed)
   {
-    if (dec) dec->done();
+    if (dec) done_coders();
+  }
+  return TRUE;
+}
+
+void LASreadPoint::save_checkpoint()
+{
+  U32 i, l;
+  if (readers != readers_compressed) return;
+  if (checkpoint_chunk != current_chunk)
+  {
+    // the checkpoints are only kept for one chunk
+    checkpoint_chunk = current_chunk;
+    num_checkpoints = 0;
+  }
+  if (chunk_count != (num_checkpoints+1)*checkpoint_interval) return;
+  U32 size = 0;
+  if (layer_decs)
+  {
+    for (l = 0; l < num_layers; l++)
+    {
+      if (layer_decs[l]) size += layer_decs[l]->getStateSize();
+    }
+  }
+  else
+  {
+    size += dec->getStateSize();
+  }
+  for (i = 0; i < num_readers; i++)
+  {
+    U32 item_size = ((LASreadItemCompressed*)(readers_compressed[i]))->get_state_size();
+    if (item_size == U32_MAX)
+    {
+      // some item cannot save its context
+      checkpoint_interval = 0;
+      return;
+    }
+    size += item_size;
+  }
+  if (num_checkpoints == alloced_checkpoints)
+  {
+    alloced_checkpoints += 16;
+    checkpoints = (U8**)realloc(checkpoints, sizeof(U8*)*alloced_checkpoints);
+    checkpoint_sizes = (U32*)realloc(checkpoint_sizes, sizeof(U32)*alloced_checkpoints);
+    for (i = num_checkpoints; i < alloced_checkpoints; i++)
+    {
+      checkpoints[i] = 0;
+      checkpoint_sizes[i] = 0;
+    }
+  }
+  if (checkpoint_sizes[num_checkpoints] < size)
+  {
+    if (checkpoints[num_checkpoints]) free(checkpoints[num_checkpoints]);
+    checkpoints[num_checkpoints] = (U8*)malloc(size);
+    checkpoint_sizes[num_checkpoints] = (checkpoints[num_checkpoints] ? size : 0);
+    if (checkpoints[num_checkpoints] == 0) return;
+  }
+  U8* state = checkpoints[num_checkpoints];
+  if (layer_decs)
+  {
+    for (l = 0; l < num_layers; l++)
+    {
+      if (layer_decs[l]) state = layer_decs[l]->saveState(state);
+    }
+  }
+  else
+  {
+    state = dec->saveState(state);
+  }
+  for (i = 0; i < num_readers; i++)
+  {
+    state = ((LASreadItemCompressed*)(readers_compressed[i]))->save_state(state);
+  }
+  num_checkpoints++;
+}
+
+BOOL LASreadPoint::restore_checkpoint(const U32 index)
+{
+  U32 i, l;
+  if ((checkpoint_interval == 0) || (readers != readers_compressed) || (checkpoint_chunk != current_chunk)) return FALSE;
+  U32 c = index/checkpoint_interval;
+  if (c > num_checkpoints) c = num_checkpoints;
+  if (c == 0) return FALSE;
+  // only worth it if the checkpoint is ahead of us or we have to go back
+  if ((c*checkpoint_interval <= chunk_count) && (index >= chunk_count)) return FALSE;
+  const U8* state = checkpoints[c-1];
+  if (layer_decs)
+  {
+    for (l = 0; l < num_layers; l++)
+    {
+      if (layer_decs[l] && state) state = layer_decs[l]->restoreState(state);
+    }
+  }
+  else
+  {
+    state = dec->restoreState(state);
+  }
+  if (state == 0) return FALSE;
+  for (i = 0; i < num_readers; i++)
+  {
+    state = ((LASreadItemCompressed*)(readers_compressed[i]))->restore_state(state);
+  }
+  chunk_count = c*checkpoint_interval;
+  return TRUE;
+}
+
+void LASreadPoint::init_coders()
+{
+  U32 l;
+  if (layer_decs == 0)
+  {
+    dec->init(instream);
+    return;
+  }
+  // the sizes of all layers precede their bytes
+  for (l = 0; l < num_layers; l++)
+  {
+    instream->get32bitsLE((U8*)&layer_sizes[l]);
+  }
+  for (l = 0; l < num_layers; l++)
+  {
+    const U8* bytes;
+    U32 num_bytes = layer_sizes[l];
+    if (instream->isWindowStable() && (instream->getWindow(&bytes) >= num_bytes))
+    {
+      // layers of streams that are in memory are decoded in place
+      instream->skipWindow(num_bytes);
+    }
+    else if (layer_decs[l] == 0 && instream->isSeekable())
+    {
+      instream->seek(instream->tell() + num_bytes);
+    }
+    else
+    {
+      if (layer_alloced[l] < num_bytes)
+      {
+        if (layer_buffers[l]) delete [] layer_buffers[l];
+        layer_buffers[l] = new U8[num_bytes];
+        layer_alloced[l] = num_bytes;
+      }
+      instream->getBytes(layer_buffers[l], num_bytes);
+      bytes = layer_buffers[l];
+    }
+    if (layer_decs[l])
+    {
+      layer_streams[l]->init(bytes, num_bytes);
+      layer_decs[l]->init(layer_streams[l]);
+    }
+  }
+}
+
+void LASreadPoint::done_coders()
+{
+  U32 l;
+  if (layer_decs == 0)
+  {
+    dec->done();
+    return;
+  }
+  for (l = 0; l < num_layers; l++)
+  {
+    if (layer_decs[l]) layer_decs[l]->done();
+  }
+}
+
+#ifdef LASZIP_INSTRUMENT
+BOOL LASreadPoint::get_item_counters(const U32 item, I64* cycles, I64* points, I64* bytes) const
+{
+  if (item >= num_readers || counters == 0) return FALSE;
+  if (cycles) *cycles = counters[item].cycles;
+  if (points) *points = counters[item].points;
+  if (bytes) *bytes = counters[item].bytes;
+  return TRUE;
+}
+#else
+BOOL LASreadPoint::get_item_counters(const U32, I64*, I64*, I64*) const
+{
+  return FALSE;
+}
+#endif
+
+#ifdef LASZIP_INSTRUMENT
+I64 LASreadPoint::item_position(const U32 i) const
+{
+  // raw points come straight from the stream
+  if (readers != readers_compressed) return instream->tell();
+  if (layer_decs == 0) return dec->tell();
+  // the bytes of an item are spread over its layers
+  I64 position = 0;
+  for (U32 l = item_layers[i]; l < item_layers[i+1]; l++)
+  {
+    if (layer_decs[l]) position += layer_decs[l]->tell();
+  }
+  return position;
+}
+
+void LASreadPoint::count_raw_batch(const U32 run, const I64 cycles)
+{
+  // a block is read for all items at once so its cycles are shared by size
+  U32 i, size;
+  for (i = 0; i < num_readers; i++)
+  {
+    size = (i+1 < num_readers ? item_offsets[i+1] : point_size) - item_offsets[i];
+    counters[i].cycles += cycles*size/point_size;
+    counters[i].points += run;
+    counters[i].bytes += (I64)run*size;
+  }
+}
+#endif
+
+U32 LASreadPoint::get_number_chunks() const
+{
+  // only a completely read chunk table tells where every chunk starts
+  if (chunk_starts && (tabled_chunks == number_chunks+1)) return number_chunks;
+  return 0;
+}
+
+BOOL LASreadPoint::get_chunk(const U32 chunk, U32* first_point, U32* num_points) const
+{
+  if (chunk >= get_number_chunks()) return FALSE;
+  if (chunk_totals) // variable sized chunks?
+  {
+    *first_point = chunk_totals[chunk];
+    *num_points = chunk_totals[chunk+1]-chunk_totals[chunk];
+  }
+  else
+  {
+    // the last chunk may hold fewer points than chunk_size
+    *first_point = chunk*chunk_size;
+    *num_points = chunk_size;
+  }
+  return TRUE;
+}
+
+BOOL LASreadPoint::get_chunk_bounds(const U32 chunk, I32* min_xyz, I32* max_xyz)
+{
+  if (!(summary_contents & LASZIP_CHUNK_SUMMARY_XYZ_BOUNDS)) return FALSE;
+  if (chunk >= get_number_chunks()) return FALSE;
+  memcpy(min_xyz, chunk_bounds + 6*chunk, 3*sizeof(I32));
+  memcpy(max_xyz, chunk_bounds + 6*chunk + 3, 3*sizeof(I32));
+  return TRUE;
+}
+
+U32 LASreadPoint::get_chunks_in_box(const I32* min_xyz, const I32* max_xyz, const BOOL use_z, U32* chunks)
+{
+  U32 i, number = get_number_chunks();
+  U32 found = 0;
+  BOOL bounded = ((summary_contents & LASZIP_CHUNK_SUMMARY_XYZ_BOUNDS) != 0);
+  for (i = 0; i < number; i++)
+  {
+    if (bounded)
+    {
+      const I32* bounds = chunk_bounds + 6*i;
+      if ((bounds[3] < min_xyz[0]) || (bounds[0] > max_xyz[0])) continue;
+      if ((bounds[4] < min_xyz[1]) || (bounds[1] > max_xyz[1])) continue;
+      if (use_z && ((bounds[5] < min_xyz[2]) || (bounds[2] > max_xyz[2]))) continue;
+    }
+    chunks[found++] = i;
+  }
+  return found;
+}
+
+BOOL LASreadPoint::get_chunk_classifications(const U32 chunk, U32* counts)
+{
+  if (!(summary_contents & LASZIP_CHUNK_SUMMARY_CLASSIFICATIONS)) return FALSE;
+  if (chunk >= get_number_chunks()) return FALSE;
+  memcpy(counts, chunk_classifications + LASZIP_CHUNK_SUMMARY_NUM_CLASSIFICATIONS*chunk, LASZIP_CHUNK_SUMMARY_NUM_CLASSIFICATIONS*sizeof(U32));
+  return TRUE;
+}
+
+BOOL LASreadPoint::get_chunk_return_numbers(const U32 chunk, U32* counts)
+{
+  if (!(summary_contents & LASZIP_CHUNK_SUMMARY_RETURN_NUMBERS)) return FALSE;
+  if (chunk >= get_number_chunks()) return FALSE;
+  memcpy(counts, chunk_return_numbers + LASZIP_CHUNK_SUMMARY_NUM_RETURN_NUMBERS*chunk, LASZIP_CHUNK_SUMMARY_NUM_RETURN_NUMBERS*sizeof(U32));
+  return TRUE;
+}
+
+BOOL LASreadPoint::get_chunk_gps_time(const U32 chunk, F64* min_gps_time, F64* max_gps_time)
+{
+  if (!(summary_contents & LASZIP_CHUNK_SUMMARY_GPS_TIME)) return FALSE;
+  if (chunk >= get_number_chunks()) return FALSE;
+  *min_gps_time = chunk_gps_times[2*chunk];
+  *max_gps_time = chunk_gps_times[2*chunk+1];
+  return TRUE;
+}
+
+BOOL LASreadPoint::get_chunk_intensity(const U32 chunk, U16* min_intensity, U16* max_intensity)
+{
+  if (!(summary_contents & LASZIP_CHUNK_SUMMARY_INTENSITY)) return FALSE;
+  if (chunk >= get_number_chunks()) return FALSE;
+  *min_intensity = chunk_intensities[2*chunk];
+  *max_intensity = chunk_intensities[2*chunk+1];
+  return TRUE;
+}
+
+U32 LASreadPoint::get_chunks_with_classification(const U8 classification, U32* chunks)
+{
+  U32 i, number = get_number_chunks();
+  U32 found = 0;
+  BOOL counted = ((summary_contents & LASZIP_CHUNK_SUMMARY_CLASSIFICATIONS) != 0);
+  for (i = 0; i < number; i++)
+  {
+    if (counted && (chunk_classifications[LASZIP_CHUNK_SUMMARY_NUM_CLASSIFICATIONS*i + classification] == 0)) continue;
+    chunks[found++] = i;
+  }
+  return found;
+}
+
+U32 LASreadPoint::get_chunks_in_gps_time(const F64 min_gps_time, const F64 max_gps_time, U32* chunks)
+{
+  U32 i, number = get_number_chunks();
+  U32 found = 0;
+  BOOL timed = ((summary_contents & LASZIP_CHUNK_SUMMARY_GPS_TIME) != 0);
+  for (i = 0; i < number; i++)
+  {
+    if (timed && ((chunk_gps_times[2*i+1] < min_gps_time) || (chunk_gps_times[2*i] > max_gps_time))) continue;
+    chunks[found++] = i;
+  }
+  return found;
+}
+
+// the chunk summaries written by LASwritePoint lie between the last chunk and
+// the chunk table (see there) and are read right after the chunk table so that
+// the stream goes to the end of the file only once and before decoding starts
+
+BOOL LASreadPoint::read_chunk_summaries()
+{
+  U32 number = get_number_chunks();
+  if (number == 0) return FALSE;
+  BOOL read;
+  try
+  {
+    read = FALSE;
+    if (instream->seek(chunk_starts[number]))
+    {
+      U8 signature[4];
+      instream->getBytes(signature, 4);
+      U32 version, summary_chunks;
+      instream->get32bitsLE((U8*)&version);
+      instream->get32bitsLE((U8*)&summary_chunks);
+      if ((memcmp(signature, "LZCS", 4) == 0) && (version == 0) && (summary_chunks == number))
+      {
+        read = read_chunk_summaries(instream, number);
+      }
+    }
+  }
+  catch (...)
+  {
+    read = FALSE;
+  }
+  // no (or broken) chunk summaries
+  if (!read) free_chunk_summaries();
+  return (summary_contents != LASZIP_CHUNK_SUMMARY_NONE);
+}
+
+BOOL LASreadPoint::read_chunk_summaries(ByteStreamIn* stream, const U32 number)
+{
+  U32 s, i;
+  U32 number_sections;
+  stream->get32bitsLE((U8*)&number_sections);
+  for (s = 0; s < number_sections; s++)
+  {
+    U32 type, bytes;
+    stream->get32bitsLE((U8*)&type);
+    stream->get32bitsLE((U8*)&bytes);
+    if ((type == LASZIP_CHUNK_SUMMARY_XYZ_BOUNDS) && (bytes == number*6*sizeof(I32)) && (chunk_bounds == 0))
+    {
+      chunk_bounds = (I32*)malloc(bytes);
+      if (chunk_bounds == 0) return FALSE;
+      for (i = 0; i < 6*number; i++)
+      {
+        stream->get32bitsLE((U8*)&chunk_bounds[i]);
+      }
+      summary_contents |= type;
+    }
+    else if ((type == LASZIP_CHUNK_SUMMARY_CLASSIFICATIONS) && (bytes == number*LASZIP_CHUNK_SUMMARY_NUM_CLASSIFICATIONS*sizeof(U32)) && (chunk_classifications == 0))
+    {
+      chunk_classifications = (U32*)malloc(bytes);
+      if (chunk_classifications == 0) return FALSE;
+      for (i = 0; i < LASZIP_CHUNK_SUMMARY_NUM_CLASSIFICATIONS*number; i++)
+      {
+        stream->get32bitsLE((U8*)&chunk_classifications[i]);
+      }
+      summary_contents |= type;
+    }
+    else if ((type == LASZIP_CHUNK_SUMMARY_RETURN_NUMBERS) && (bytes == number*LASZIP_CHUNK_SUMMARY_NUM_RETURN_NUMBERS*sizeof(U32)) && (chunk_return_numbers == 0))
+    {
+      chunk_return_numbers = (U32*)malloc(bytes);
+      if (chunk_return_numbers == 0) return FALSE;
+      for (i = 0; i < LASZIP_CHUNK_SUMMARY_NUM_RETURN_NUMBERS*number; i++)
+      {
+        stream->get32bitsLE((U8*)&chunk_return_numbers[i]);
+      }
+      summary_contents |= type;
+    }
+    else if ((type == LASZIP_CHUNK_SUMMARY_GPS_TIME) && (bytes == number*2*sizeof(F64)) && (chunk_gps_times == 0))
+    {
+      chunk_gps_times = (F64*)malloc(bytes);
+      if (chunk_gps_times == 0) return FALSE;
+      for (i = 0; i < 2*number; i++)
+      {
+        stream->get64bitsLE((U8*)&chunk_gps_times[i]);
+      }
+      summary_contents |= type;
+    }
+    else if ((type == LASZIP_CHUNK_SUMMARY_INTENSITY) && (bytes == number*2*sizeof(U16)) && (chunk_intensities == 0))
+    {
+      chunk_intensities = (U16*)malloc(bytes);
+      if (chunk_intensities == 0) return FALSE;
+      for (i = 0; i < 2*number; i++)
+      {
+        stream->get16bitsLE((U8*)&chunk_intensities[i]);
+      }
+      summary_contents |= type;
+    }
+    else
+    {
+      // sections we do not know are skipped
+      if (!stream->seek(stream->tell() + bytes)) return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+// the sections of the chunk summaries in the same layout as in the file
+
+BOOL LASreadPoint::write_chunk_summaries(ByteStreamOut* stream) const
+{
+  U32 i, type;
+  U32 number = get_number_chunks();
+  U32 number_sections = 0;
+  for (type = 1; type & LASZIP_CHUNK_SUMMARY_ALL; type <<= 1)
+  {
+    if (summary_contents & type) number_sections++;
+  }
+  if (!stream->put32bitsLE((const U8*)&number_sections)) return FALSE;
+  if (summary_contents & LASZIP_CHUNK_SUMMARY_XYZ_BOUNDS)
+  {
+    type = LASZIP_CHUNK_SUMMARY_XYZ_BOUNDS;
+    U32 bytes = number*6*sizeof(I32);
+    if (!stream->put32bitsLE((const U8*)&type) || !stream->put32bitsLE((const U8*)&bytes)) return FALSE;
+    for (i = 0; i < 6*number; i++)
+    {
+      if (!stream->put32bitsLE((const U8*)&chunk_bounds[i])) return FALSE;
+    }
+  }
+  if (summary_contents & LASZIP_CHUNK_SUMMARY_CLASSIFICATIONS)
+  {
+    type = LASZIP_CHUNK_SUMMARY_CLASSIFICATIONS;
+    U32 bytes = number*LASZIP_CHUNK_SUMMARY_NUM_CLASSIFICATIONS*sizeof(U32);
+    if (!stream->put32bitsLE((const U8*)&type) || !stream->put32bitsLE((const U8*)&bytes)) return FALSE;
+    for (i = 0; i < LASZIP_CHUNK_SUMMARY_NUM_CLASSIFICATIONS*number; i++)
+    {
+      if (!stream->put32bitsLE((const U8*)&chunk_classifications[i])) return FALSE;
+    }
+  }
+  if (summary_contents & LASZIP_CHUNK_SUMMARY_RETURN_NUMBERS)
+  {
+    type = LASZIP_CHUNK_SUMMARY_RETURN_NUMBERS;
+    U32 bytes = number*LASZIP_CHUNK_SUMMARY_NUM_RETURN_NUMBERS*sizeof(U32);
+    if (!stream->put32bitsLE((const U8*)&type) || !stream->put32bitsLE((const U8*)&bytes)) return FALSE;
+    for (i = 0; i < LASZIP_CHUNK_SUMMARY_NUM_RETURN_NUMBERS*number; i++)
+    {
+      if (!stream->put32bitsLE((const U8*)&chunk_return_numbers[i])) return FALSE;
+    }
+  }
+  if (summary_contents & LASZIP_CHUNK_SUMMARY_GPS_TIME)
+  {
+    type = LASZIP_CHUNK_SUMMARY_GPS_TIME;
+    U32 bytes = number*2*sizeof(F64);
+    if (!stream->put32bitsLE((const U8*)&type) || !stream->put32bitsLE((const U8*)&bytes)) return FALSE;
+    for (i = 0; i < 2*number; i++)
+    {
+      if (!stream->put64bitsLE((const U8*)&chunk_gps_times[i])) return FALSE;
+    }
+  }
+  if (summary_contents & LASZIP_CHUNK_SUMMARY_INTENSITY)
+  {
+    type = LASZIP_CHUNK_SUMMARY_INTENSITY;
+    U32 bytes = number*2*sizeof(U16);
+    if (!stream->put32bitsLE((const U8*)&type) || !stream->put32bitsLE((const U8*)&bytes)) return FALSE;
+    for (i = 0; i < 2*number; i++)
+    {
+      if (!stream->put16bitsLE((const U8*)&chunk_intensities[i])) return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+void LASreadPoint::free_chunk_summaries()
+{
+  if (chunk_bounds) free(chunk_bounds);
+  chunk_bounds = 0;
+  if (chunk_classifications) free(chunk_classifications);
+  chunk_classifications = 0;
+  if (chunk_return_numbers) free(chunk_return_numbers);
+  chunk_return_numbers = 0;
+  if (chunk_gps_times) free(chunk_gps_times);
+  chunk_gps_times = 0;
+  if (chunk_intensities) free(chunk_intensities);
+  chunk_intensities = 0;
+  summary_contents = LASZIP_CHUNK_SUMMARY_NONE;
+}
+
+// the chunk index file starts with "LZCI" and the version (1), followed by
+// the size and time of the LAZ file, the number of chunks, whether chunks are
+// variable sized, number_chunks+1 chunk starts, (if variable) point totals and
+// the sections of the chunk summaries (none if the file has no summaries)
+
+BOOL LASreadPoint::read_chunk_index(ByteStreamIn* stream, const I64 file_size, const I64 file_time)
+{
+  // only for chunked data before init() has read its chunk table
+  if ((number_chunks != U32_MAX) || indexed_chunks) return FALSE;
+  U32 i;
+  I64* starts = 0;
+  U32* totals = 0;
+  try
+  {
+    U8 signature[4];
+    stream->getBytes(signature, 4);
+    if (memcmp(signature, "LZCI", 4) != 0) return FALSE;
+    U32 version;
+    stream->get32bitsLE((U8*)&version);
+    // an index of version 0 does not say whether there are summaries
+    if (version != 1) return FALSE;
+    I64 size, time;
+    stream->get64bitsLE((U8*)&size);
+    stream->get64bitsLE((U8*)&time);
+    if ((size != file_size) || (time != file_time)) return FALSE;
+    U32 number, variable;
+    stream->get32bitsLE((U8*)&number);
+    stream->get32bitsLE((U8*)&variable);
+    if ((number == 0) || (number >= U32_MAX-1)) return FALSE;
+    if ((variable != 0) != (chunk_size == U32_MAX)) return FALSE;
+    starts = (I64*)malloc(sizeof(I64)*(number+1));
+    if (starts == 0) return FALSE;
+    for (i = 0; i <= number; i++)
+    {
+      stream->get64bitsLE((U8*)&starts[i]);
+    }
+    if (variable)
+    {
+      totals = new U32[number+1];
+      for (i = 0; i <= number; i++)
+      {
+        stream->get32bitsLE((U8*)&totals[i]);
+      }
+    }
+    if (!read_chunk_summaries(stream, number))
+    {
+      free(starts);
+      if (totals) delete [] totals;
+      free_chunk_summaries();
+      return FALSE;
+    }
+    // the chunk table is used by init() once its position is confirmed
+    chunk_starts = starts;
+    chunk_totals = totals;
+    indexed_chunks = number;
+  }
+  catch (...)
+  {
+    // the index was truncated
+    if (starts) free(starts);
+    if (totals) delete [] totals;
+    free_chunk_summaries();
+    return FALSE;
   }
   return TRUE;
 }
 
+BOOL LASreadPoint::write_chunk_index(ByteStreamOut* stream, const I64 file_size, const I64 file_time) const
+{
+  U32 i;
+  U32 number = get_number_chunks();
+  if (number == 0) return FALSE;
+  U32 version = 1;
+  U32 variable = (chunk_totals ? 1 : 0);
+  if (!stream->putBytes((const U8*)"LZCI", 4)) return FALSE;
+  if (!stream->put32bitsLE((const U8*)&version)) return FALSE;
+  if (!stream->put64bitsLE((const U8*)&file_size)) return FALSE;
+  if (!stream->put64bitsLE((const U8*)&file_time)) return FALSE;
+  if (!stream->put32bitsLE((const U8*)&number)) return FALSE;
+  if (!stream->put32bitsLE((const U8*)&variable)) return FALSE;
+  for (i = 0; i <= number; i++)
+  {
+    if (!stream->put64bitsLE((const U8*)&chunk_starts[i])) return FALSE;
+  }
+  if (variable)
+  {
+    for (i = 0; i <= number; i++)
+    {
+      if (!stream->put32bitsLE((const U8*)&chunk_totals[i])) return FALSE;
+    }
+  }
+  return write_chunk_summaries(stream);
+}
+
 BOOL LASreadPoint::read_chunk_table()
 {
   // read the 8 bytes that store the location of the chunk table
@@ -407,6 +1514,23 @@ BOOL LASreadPoint::read_chunk_table()
   // this is where the chunks start
   I64 chunks_start = instream->tell();
 
+  if (indexed_chunks)
+  {
+    // use the chunk table of the chunk index if it belongs to these chunks
+    if ((chunk_starts[0] == chunks_start) && ((chunk_table_start_position == -1) || (chunk_starts[indexed_chunks] <= chunk_table_start_position)))
+    {
+      number_chunks = indexed_chunks;
+      tabled_chunks = number_chunks+1;
+      return TRUE;
+    }
+    free(chunk_starts);
+    chunk_starts = 0;
+    if (chunk_totals) delete [] chunk_totals;
+    chunk_totals = 0;
+    indexed_chunks = 0;
+    free_chunk_summaries();
+  }
+
   if ((chunk_table_start_position + 8) == chunks_start)
   {
     // then compressor was interrupted before getting a chance to write the chunk table
@@ -491,6 +1615,8 @@ BOOL LASreadPoint::read_chunk_table()
         if (chunk_size == U32_MAX) chunk_totals[i] += chunk_totals[i-1];
         chunk_starts[i] += chunk_starts[i-1];
       }
+      // the summaries lie right before the chunk table
+      read_chunk_summaries();
     }
   }
   catch (...)
@@ -560,17 +1686,69 @@ LASreadPoint::~LASreadPoint()
     delete [] readers_compressed;
   }
 
+  if (fused) delete fused;
+
   if (dec)
   {
     delete dec;
   }
 
+  if (layer_decs)
+  {
+    for (i = 0; i < num_layers; i++)
+    {
+      if (layer_decs[i]) delete layer_decs[i];
+      if (layer_streams[i]) delete layer_streams[i];
+      if (layer_buffers[i]) delete [] layer_buffers[i];
+    }
+    delete [] layer_decs;
+    delete [] layer_streams;
+    delete [] layer_buffers;
+    delete [] layer_alloced;
+    delete [] layer_sizes;
+  }
+
   if (chunk_totals) delete [] chunk_totals;
   if (chunk_starts) delete [] chunk_starts;
+  free_chunk_summaries();
 
   if (seek_point)
   {
     delete [] seek_point[0];
     delete [] seek_point;
   }
+
+  if (checkpoints)
+  {
+    for (i = 0; i < alloced_checkpoints; i++)
+    {
+      if (checkpoints[i]) free(checkpoints[i]);
+    }
+    free(checkpoints);
+    free(checkpoint_sizes);
+  }
+
+  if (item_offsets) delete [] item_offsets;
+  if (batch_point) delete [] batch_point;
+  if (raw_block) delete [] raw_block;
+  if (raw_stream) delete raw_stream;
+
+  if (lanes)
+  {
+    for (i = 0; i < num_lanes; i++)
+    {
+      delete lanes[i];
+      delete lane_streams[i];
+      if (lane_buffers[i]) delete [] lane_buffers[i];
+    }
+    delete [] lanes;
+    delete [] lane_streams;
+    delete [] lane_buffers;
+    delete [] lane_alloced;
+  }
+
+#ifdef LASZIP_INSTRUMENT
+  if (counters) delete [] counters;
+  if (item_layers) delete [] item_layers;
+#endif
 }
@@ -24,6 +24,22 @@
   
   CHANGE HISTORY:
   
+    17 October 2026 -- read_batch() can decode several whole chunks in lock-step
+    17 October 2026 -- chunk summaries are read with the chunk table or from the chunk index
+    17 October 2026 -- read_batch() counts every point it decoded before the stream ended
+    17 October 2026 -- the fused reader is counted item by item as well (LASZIP_INSTRUMENT)
+    17 October 2026 -- decoders for the rANS coder as well as the arithmetic one
+    17 October 2026 -- counts the cycles, points and bytes of every item (LASZIP_INSTRUMENT)
+    17 October 2026 -- layers are only decoded in place from stable stream windows
+    17 October 2026 -- uncompressed points are read in blocks of whole records
+    17 October 2026 -- finds the chunks with a classification or gps time from their summaries
+    17 October 2026 -- finds the chunks that intersect a box from their summaries
+    17 October 2026 -- the chunk table can come from a chunk index file
+    17 October 2026 -- seeking within a chunk resumes from in-memory checkpoints
+    17 October 2026 -- layered decompression that can skip unwanted layers
+    17 October 2026 -- decompresses POINT14 and RGBNIR14 items
+    17 October 2026 -- fused reader for the common point types
+    17 October 2026 -- read_batch() decodes many points into an interleaved buffer
     6 October 2011 -- large file support & reading with missing chunk table
     9 May 2011 -- the chunked compressor now allows variable chunk sizes
     25 April 2011 -- added chunked laszip for random access decompression
@@ -41,31 +57,83 @@
 #include "mydefs.hpp"
 #include "laszip.hpp"
 #include "bytestreamin.hpp"
+#include "bytestreamout.hpp"
+#include "lasinstrument.hpp"
 
 class LASreadItem;
+class LASreadFusedCompressed_v2;
 class EntropyDecoder;
+class ByteStreamInArray;
 
 class LASreadPoint
+#ifdef LASZIP_INSTRUMENT
+  : public LASitemPositions
+#endif
 {
 public:
   LASreadPoint();
   ~LASreadPoint();
 
-  // should only be called *once*
-  BOOL setup(const U32 num_items, const LASitem* items, const LASzip* laszip=0);
+  // should only be called *once* (layered data decompresses only the selected layers)
+  BOOL setup(const U32 num_items, const LASitem* items, const LASzip* laszip=0, const U32 decompress_selective=LASZIP_DECOMPRESS_SELECTIVE_ALL);
+
+  // keep the decoding state every interval points of the current chunk while
+  // seeking so that later seeks within that chunk resume from there (0 = off)
+  BOOL set_checkpoint_interval(const U32 interval);
+
+  // decode up to num_chunks whole chunks side by side on this thread when a
+  // batch holds them so that their serial decoding chains overlap (call after
+  // setup and before init, only for the point types of the fused reader,
+  // 0 or 1 = off)
+  BOOL set_interleave(const U32 num_chunks);
 
   BOOL init(ByteStreamIn* instream);
   BOOL seek(const U32 current, const U32 target);
   BOOL read(U8* const * point);
+  // decodes up to count points that are stride bytes apart and returns how many
+  U32 read_batch(U8* dest, const U32 count, const U32 stride);
   BOOL done();
 
+  // chunk table (available after init) for decoding chunks independently
+  U32 get_number_chunks() const;
+  BOOL get_chunk(const U32 chunk, U32* first_point, U32* num_points) const;
+
+  // a chunk index holds the chunk table and the chunk summaries of a file with
+  // this size and time so that neither need be read from the end of the file
+  // (read it after setup and before init)
+  BOOL read_chunk_index(ByteStreamIn* stream, const I64 file_size, const I64 file_time);
+  BOOL write_chunk_index(ByteStreamOut* stream, const I64 file_size, const I64 file_time) const;
+
+  // the quantized bounds of a chunk (if the file has LASZIP_CHUNK_SUMMARY_XYZ_BOUNDS)
+  BOOL get_chunk_bounds(const U32 chunk, I32* min_xyz, I32* max_xyz);
+  // stores the chunks whose bounds intersect the box (in x and y only unless
+  // use_z) and returns how many there are (all chunks if there are no bounds)
+  U32 get_chunks_in_box(const I32* min_xyz, const I32* max_xyz, const BOOL use_z, U32* chunks);
+  // the attribute statistics of a chunk (if the file has the LASZIP_CHUNK_SUMMARY_* for them)
+  BOOL get_chunk_classifications(const U32 chunk, U32* counts);
+  BOOL get_chunk_return_numbers(const U32 chunk, U32* counts);
+  BOOL get_chunk_gps_time(const U32 chunk, F64* min_gps_time, F64* max_gps_time);
+  BOOL get_chunk_intensity(const U32 chunk, U16* min_intensity, U16* max_intensity);
+  // stores the chunks that have points of this classification or whose gps
+  // times overlap the window and returns how many there are (all chunks if
+  // there are no such summaries)
+  U32 get_chunks_with_classification(const U8 classification, U32* chunks);
+  U32 get_chunks_in_gps_time(const F64 min_gps_time, const F64 max_gps_time, U32* chunks);
+
+  // the processor cycles, points and compressed bytes that an item has cost
+  // since setup (fails unless the build defines LASZIP_INSTRUMENT)
+  BOOL get_item_counters(const U32 item, I64* cycles, I64* points, I64* bytes) const;
+
 private:
   ByteStreamIn* instream;
   U32 num_readers;
   LASreadItem** readers;
   LASreadItem** readers_raw;
   LASreadItem** readers_compressed;
+  LASreadFusedCompressed_v2* fused;
   EntropyDecoder* dec;
+  EntropyDecoder* create_decoder() const;
+  const LASzip* laszip;
   // used for chunking
   U32 chunk_size;
   U32 chunk_count;
@@ -74,12 +142,67 @@ private:
   U32 tabled_chunks;
   I64* chunk_starts;
   U32* chunk_totals;
+  U32 indexed_chunks;
   BOOL read_chunk_table();
+  // used for chunk summaries (read with the chunk table)
+  U32 summary_contents;
+  I32* chunk_bounds;
+  U32* chunk_classifications;
+  U32* chunk_return_numbers;
+  F64* chunk_gps_times;
+  U16* chunk_intensities;
+  BOOL read_chunk_summaries();
+  BOOL read_chunk_summaries(ByteStreamIn* stream, const U32 number);
+  BOOL write_chunk_summaries(ByteStreamOut* stream) const;
+  void free_chunk_summaries();
   U32 search_chunk_table(const U32 index, const U32 lower, const U32 upper);
   // used for seeking
   I64 point_start;
   U32 point_size;
   U8** seek_point;
+  // used for seeking with checkpoints
+  U32 checkpoint_interval;
+  U32 checkpoint_chunk;
+  U32 num_checkpoints;
+  U32 alloced_checkpoints;
+  U8** checkpoints;
+  U32* checkpoint_sizes;
+  void save_checkpoint();
+  BOOL restore_checkpoint(const U32 index);
+  // used for batch reading
+  U32* item_offsets;
+  U8** batch_point;
+  // used for block reading of uncompressed points (records that are stored
+  // as they are in memory need no conversion and go straight to the caller)
+  BOOL raw_copy;
+  U8* raw_block;
+  ByteStreamInArray* raw_stream;
+  U32 read_raw_batch(U8* dest, const U32 count, const U32 stride);
+  // used for layered decompression (skipped layers have no decoder)
+  U32 num_layers;
+  EntropyDecoder** layer_decs;
+  ByteStreamInArray** layer_streams;
+  U8** layer_buffers;
+  U32* layer_alloced;
+  U32* layer_sizes;
+  void init_coders();
+  void done_coders();
+  // used for interleaved decoding (every lane decodes one whole chunk with its
+  // own decoders and items and the fused readers of all lanes share one loop)
+  U32 num_lanes;
+  LASreadPoint** lanes;
+  ByteStreamInArray** lane_streams;
+  U8** lane_buffers;
+  U32* lane_alloced;
+  U32 read_interleaved(U8* dest, const U32 count, const U32 stride);
+  void start_chunk(const U32 chunk);
+#ifdef LASZIP_INSTRUMENT
+  // used for counting what each item costs (also inside the fused reader)
+  LASitemCounters* counters;
+  U32* item_layers;
+  I64 item_position(const U32 i) const;
+  void count_raw_batch(const U32 run, const I64 cycles);
+#endif
 };
 
 #endif
@@ -33,10 +33,16 @@
 #include <string.h>
 #include <stdlib.h>
 
+#include "bytestreamin_array.hpp"
+#include "bytestreamin_async.hpp"
 #include "bytestreamin_file.hpp"
 #include "bytestreamin_istream.hpp"
+#include "bytestreamout_file.hpp"
 #include "lasreadpoint.hpp"
 
+#include <sys/types.h>
+#include <sys/stat.h>
+
 bool LASunzipper::open(FILE* infile, const LASzip* laszip)
 {
   if (!infile) return return_error("FILE* infile pointer is NULL");
@@ -45,14 +51,28 @@ bool LASunzipper::open(FILE* infile, const LASzip* laszip)
   if (reader) delete reader;
   reader = new LASreadPoint();
   if (!reader) return return_error("alloc of LASreadPoint failed");
-  if (!reader->setup(laszip->num_items, laszip->items, laszip)) return return_error("setup() of LASreadPoint failed");
+  if (!reader->setup(laszip->num_items, laszip->items, laszip, decompress_selective)) return return_error("setup() of LASreadPoint failed");
+  if (!reader->set_interleave(interleave)) return return_error("set_interleave() of LASreadPoint failed");
   if (stream) delete stream;
-  if (IS_LITTLE_ENDIAN())
-    stream = new ByteStreamInFileLE(infile);
+  if (read_ahead_buffers)
+  {
+    if (IS_LITTLE_ENDIAN())
+      stream = new ByteStreamInFileAsyncLE(infile, read_ahead_buffers, read_ahead_buffer_size);
+    else
+      stream = new ByteStreamInFileAsyncBE(infile, read_ahead_buffers, read_ahead_buffer_size);
+  }
   else
-    stream = new ByteStreamInFileBE(infile);
+  {
+    if (IS_LITTLE_ENDIAN())
+      stream = new ByteStreamInFileLE(infile);
+    else
+      stream = new ByteStreamInFileBE(infile);
+  }
   if (!stream) return return_error("alloc of ByteStreamInFile failed");
+  bool indexed = read_chunk_index();
   if (!reader->init(stream)) return return_error("init() of LASreadPoint failed");
+  if (!indexed) write_chunk_index();
+  if (checkpoint_interval) reader->set_checkpoint_interval(checkpoint_interval);
   return true;
 }
 
@@ -63,17 +83,142 @@ bool LASunzipper::open(istream& instream, const LASzip* laszip)
   if (reader) delete reader;
   reader = new LASreadPoint();
   if (!reader) return return_error("alloc of LASreadPoint failed");
-  if (!reader->setup(laszip->num_items, laszip->items, laszip)) return return_error("setup() of LASreadPoint failed");
+  if (!reader->setup(laszip->num_items, laszip->items, laszip, decompress_selective)) return return_error("setup() of LASreadPoint failed");
+  if (!reader->set_interleave(interleave)) return return_error("set_interleave() of LASreadPoint failed");
   if (stream) delete stream;
   if (IS_LITTLE_ENDIAN())
     stream = new ByteStreamInIstreamLE(instream);
   else
     stream = new ByteStreamInIstreamBE(instream);
   if (!stream) return return_error("alloc of ByteStreamInStream failed");
+  bool indexed = read_chunk_index();
   if (!reader->init(stream)) return return_error("init() of LASreadPoint failed");
+  if (!indexed) write_chunk_index();
+  if (checkpoint_interval) reader->set_checkpoint_interval(checkpoint_interval);
+  return true;
+}
+
+bool LASunzipper::open(const unsigned char* data, const SIGNED_INT64 size, const SIGNED_INT64 position, const LASzip* laszip)
+{
+  if (!data) return return_error("const unsigned char* data pointer is NULL");
+  if (!laszip) return return_error("const LASzip* laszip pointer is NULL");
+  count = 0;
+  if (reader) delete reader;
+  reader = new LASreadPoint();
+  if (!reader) return return_error("alloc of LASreadPoint failed");
+  if (!reader->setup(laszip->num_items, laszip->items, laszip, decompress_selective)) return return_error("setup() of LASreadPoint failed");
+  if (!reader->set_interleave(interleave)) return return_error("set_interleave() of LASreadPoint failed");
+  if (stream) delete stream;
+  if (IS_LITTLE_ENDIAN())
+    stream = new ByteStreamInArrayLE(data, size);
+  else
+    stream = new ByteStreamInArrayBE(data, size);
+  if (!stream) return return_error("alloc of ByteStreamInArray failed");
+  if (!stream->seek(position)) return return_error("seek() of ByteStreamInArray failed");
+  bool indexed = read_chunk_index();
+  if (!reader->init(stream)) return return_error("init() of LASreadPoint failed");
+  if (!indexed) write_chunk_index();
+  if (checkpoint_interval) reader->set_checkpoint_interval(checkpoint_interval);
+  return true;
+}
+
+bool LASunzipper::set_decompress_selective(const unsigned int decompress_selective)
+{
+  if (reader) return return_error("call set_decompress_selective() before open()");
+  this->decompress_selective = decompress_selective;
   return true;
 }
 
+bool LASunzipper::set_checkpoint_interval(const unsigned int interval)
+{
+  // points that are not compressed are found without checkpoints
+  if (reader && !reader->set_checkpoint_interval(interval)) return return_error("points are not compressed");
+  checkpoint_interval = interval;
+  return true;
+}
+
+bool LASunzipper::set_interleave(const unsigned int num_chunks)
+{
+  if (reader) return return_error("call set_interleave() before open()");
+  if (num_chunks > LASZIP_INTERLEAVE_CHUNKS_MAX) return return_error("cannot interleave that many chunks");
+  interleave = num_chunks;
+  return true;
+}
+
+bool LASunzipper::set_read_ahead(const unsigned int num_buffers, const unsigned int buffer_size)
+{
+  if (reader) return return_error("call set_read_ahead() before open()");
+  if (num_buffers && buffer_size == 0) return return_error("buffer_size is zero");
+  read_ahead_buffers = num_buffers;
+  read_ahead_buffer_size = buffer_size;
+  return true;
+}
+
+bool LASunzipper::set_chunk_index(const char* file_name)
+{
+  if (reader) return return_error("call set_chunk_index() before open()");
+  if (chunk_index) free(chunk_index);
+  chunk_index = (file_name ? LASCopyString(file_name) : 0);
+  return true;
+}
+
+// the size and time of the LAZ file tell whether its chunk index is current
+static bool get_size_and_time(const char* file_name, I64* size, I64* time)
+{
+#if defined _WIN32 && ! defined (__MINGW32__)
+  struct _stat64 info;
+  if (_stat64(file_name, &info) != 0) return false;
+#else
+  struct stat info;
+  if (stat(file_name, &info) != 0) return false;
+#endif
+  *size = (I64)info.st_size;
+  *time = (I64)info.st_mtime;
+  return true;
+}
+
+bool LASunzipper::read_chunk_index()
+{
+  I64 size, time;
+  if ((chunk_index == 0) || !get_size_and_time(chunk_index, &size, &time)) return false;
+  char* file_name = (char*)malloc(strlen(chunk_index) + 5);
+  sprintf(file_name, "%s.lzi", chunk_index);
+  FILE* file = fopen(file_name, "rb");
+  free(file_name);
+  if (file == 0) return false;
+  ByteStreamIn* index;
+  if (IS_LITTLE_ENDIAN())
+    index = new ByteStreamInFileLE(file);
+  else
+    index = new ByteStreamInFileBE(file);
+  BOOL read = reader->read_chunk_index(index, size, time);
+  delete index;
+  fclose(file);
+  return (read == TRUE);
+}
+
+void LASunzipper::write_chunk_index()
+{
+  I64 size, time;
+  if ((chunk_index == 0) || (reader->get_number_chunks() == 0) || !get_size_and_time(chunk_index, &size, &time)) return;
+  char* file_name = (char*)malloc(strlen(chunk_index) + 5);
+  sprintf(file_name, "%s.lzi", chunk_index);
+  // the LAZ file may well be somewhere we cannot write to
+  FILE* file = fopen(file_name, "wb");
+  if (file)
+  {
+    ByteStreamOut* index;
+    if (IS_LITTLE_ENDIAN())
+      index = new ByteStreamOutFileLE(file);
+    else
+      index = new ByteStreamOutFileBE(file);
+    BOOL written = reader->write_chunk_index(index, size, time);
+    delete index;
+    if ((fclose(file) != 0) || !written) remove(file_name);
+  }
+  free(file_name);
+}
+
 bool LASunzipper::seek(const unsigned int position)
 {
   if (!reader->seek(count, position)) return return_error("seek() of LASreadPoint failed");
@@ -92,6 +237,13 @@ bool LASunzipper::read(unsigned char * const * point)
   return (reader->read(point) == TRUE);
 }
 
+unsigned int LASunzipper::read_batch(unsigned char* dest, const unsigned int count, const unsigned int stride)
+{
+  unsigned int number = reader->read_batch(dest, count, stride);
+  this->count += number;
+  return number;
+}
+
 bool LASunzipper::close()
 {
   BOOL done = TRUE;
@@ -110,6 +262,72 @@ bool LASunzipper::close()
   return true;
 }
 
+unsigned int LASunzipper::get_number_chunks() const
+{
+  if (!reader) return 0;
+  return reader->get_number_chunks();
+}
+
+bool LASunzipper::get_chunk(const unsigned int chunk, unsigned int* first_point, unsigned int* num_points) const
+{
+  if (!reader) return false;
+  return (reader->get_chunk(chunk, first_point, num_points) == TRUE);
+}
+
+bool LASunzipper::get_chunk_bounds(const unsigned int chunk, int* min_xyz, int* max_xyz) const
+{
+  if (!reader) return false;
+  return (reader->get_chunk_bounds(chunk, (I32*)min_xyz, (I32*)max_xyz) == TRUE);
+}
+
+unsigned int LASunzipper::get_chunks_in_box(const int* min_xyz, const int* max_xyz, const bool use_z, unsigned int* chunks) const
+{
+  if (!reader) return 0;
+  return reader->get_chunks_in_box((const I32*)min_xyz, (const I32*)max_xyz, (use_z ? TRUE : FALSE), (U32*)chunks);
+}
+
+bool LASunzipper::get_chunk_classifications(const unsigned int chunk, unsigned int* counts) const
+{
+  if (!reader) return false;
+  return (reader->get_chunk_classifications(chunk, (U32*)counts) == TRUE);
+}
+
+bool LASunzipper::get_chunk_return_numbers(const unsigned int chunk, unsigned int* counts) const
+{
+  if (!reader) return false;
+  return (reader->get_chunk_return_numbers(chunk, (U32*)counts) == TRUE);
+}
+
+bool LASunzipper::get_chunk_gps_time(const unsigned int chunk, double* min_gps_time, double* max_gps_time) const
+{
+  if (!reader) return false;
+  return (reader->get_chunk_gps_time(chunk, min_gps_time, max_gps_time) == TRUE);
+}
+
+bool LASunzipper::get_chunk_intensity(const unsigned int chunk, unsigned short* min_intensity, unsigned short* max_intensity) const
+{
+  if (!reader) return false;
+  return (reader->get_chunk_intensity(chunk, min_intensity, max_intensity) == TRUE);
+}
+
+unsigned int LASunzipper::get_chunks_with_classification(const unsigned char classification, unsigned int* chunks) const
+{
+  if (!reader) return 0;
+  return reader->get_chunks_with_classification(classification, (U32*)chunks);
+}
+
+unsigned int LASunzipper::get_chunks_in_gps_time(const double min_gps_time, const double max_gps_time, unsigned int* chunks) const
+{
+  if (!reader) return 0;
+  return reader->get_chunks_in_gps_time(min_gps_time, max_gps_time, (U32*)chunks);
+}
+
+bool LASunzipper::get_item_counters(const unsigned int item, SIGNED_INT64* cycles, SIGNED_INT64* points, SIGNED_INT64* bytes) const
+{
+  if (!reader) return false;
+  return (reader->get_item_counters(item, (I64*)cycles, (I64*)points, (I64*)bytes) == TRUE);
+}
+
 const char* LASunzipper::get_error() const
 {
   return error_string;
@@ -128,6 +346,12 @@ LASunzipper::LASunzipper()
 {
   error_string = 0;
   count = 0;
+  decompress_selective = LASZIP_DECOMPRESS_SELECTIVE_ALL;
+  checkpoint_interval = 0;
+  read_ahead_buffers = 0;
+  interleave = 0;
+  read_ahead_buffer_size = 0;
+  chunk_index = 0;
   stream = 0;
   reader = 0;
 }
@@ -135,5 +359,6 @@ LASunzipper::LASunzipper()
 LASunzipper::~LASunzipper()
 {
   if (error_string) free(error_string);
+  if (chunk_index) free(chunk_index);
   if (reader || stream) close();
 }
@@ -0,0 +1,260 @@
+/*
+===============================================================================
+
+  FILE:  laswritechunkpool.cpp
+
+  CONTENTS:
+
+    see corresponding header file
+
+  PROGRAMMERS:
+
+    agent@local
+
+  COPYRIGHT:
+
+    (c) 2026, agent@local
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the COPYING file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    see corresponding header file
+
+===============================================================================
+*/
+
+#include "laswritechunkpool.hpp"
+
+#include "laswritepoint.hpp"
+#include "bytestreamout_array.hpp"
+
+#include <string.h>
+#include <stdlib.h>
+
+LASwriteChunkPool::LASwriteChunkPool()
+{
+  laszip = 0;
+  point_size = 0;
+  item_offsets = 0;
+  next_fill = 0;
+  next_compress = 0;
+  next_retire = 0;
+  stop = FALSE;
+#ifdef LASZIP_INSTRUMENT
+  counters = 0;
+#endif
+}
+
+BOOL LASwriteChunkPool::setup(const U32 num_items, const LASitem* items, const LASzip* laszip, const U32 num_threads)
+{
+  U32 i;
+
+  if (num_threads < 2) return FALSE;
+
+  // every worker compresses exactly one chunk at a time without a chunk table
+  this->laszip = new LASzip();
+  if (!this->laszip->setup((U16)num_items, items, laszip->compressor, laszip->coder)) return FALSE;
+
+  item_offsets = new U32[num_items];
+  point_size = 0;
+  for (i = 0; i < num_items; i++)
+  {
+    item_offsets[i] = point_size;
+    point_size += items[i].size;
+  }
+#ifdef LASZIP_INSTRUMENT
+  counters = new LASitemCounters[num_items];
+#endif
+
+  // two slots per worker keep them busy while the oldest chunk is written
+  slots.resize(2*num_threads);
+  for (i = 0; i < slots.size(); i++)
+  {
+    slots[i].points = 0;
+    slots[i].num_points = 0;
+    slots[i].alloced_points = 0;
+    if (IS_LITTLE_ENDIAN())
+      slots[i].stream = new ByteStreamOutArrayLE();
+    else
+      slots[i].stream = new ByteStreamOutArrayBE();
+    slots[i].compressed = FALSE;
+    slots[i].failed = FALSE;
+  }
+
+  for (i = 0; i < num_threads; i++)
+  {
+    threads.push_back(std::thread(&LASwriteChunkPool::work, this));
+  }
+  return TRUE;
+}
+
+BOOL LASwriteChunkPool::add(const U8 * const * point)
+{
+  U32 i;
+  // the caller owns the slot being filled so no locking is needed
+  Slot* slot = &slots[(size_t)(next_fill % slots.size())];
+  if (slot->num_points == slot->alloced_points)
+  {
+    U32 alloced_points = (slot->alloced_points ? 2*slot->alloced_points : 1024);
+    U8* points = (U8*)realloc(slot->points, (size_t)alloced_points*point_size);
+    if (points == 0) return FALSE;
+    slot->points = points;
+    slot->alloced_points = alloced_points;
+  }
+  U8* current = slot->points + (size_t)slot->num_points*point_size;
+  for (i = 0; i < laszip->num_items; i++)
+  {
+    memcpy(current + item_offsets[i], point[i], laszip->items[i].size);
+  }
+  slot->num_points++;
+  return TRUE;
+}
+
+BOOL LASwriteChunkPool::submit()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  if ((next_fill - next_retire) == slots.size()) return FALSE;
+  next_fill++;
+  changed.notify_all();
+  return TRUE;
+}
+
+BOOL LASwriteChunkPool::full()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return ((next_fill - next_retire) == slots.size());
+}
+
+BOOL LASwriteChunkPool::retire(const BOOL wait, const U8** bytes, U32* num_bytes, U32* num_points)
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  if (next_retire == next_fill) return FALSE;
+  Slot* slot = &slots[(size_t)(next_retire % slots.size())];
+  if (wait)
+  {
+    changed.wait(lock, [slot] { return slot->compressed; });
+  }
+  else if (!slot->compressed)
+  {
+    return FALSE;
+  }
+  // a failed chunk is reported with a null pointer
+  *bytes = (slot->failed ? 0 : slot->stream->getData());
+  *num_bytes = (U32)slot->stream->getSize();
+  *num_points = slot->num_points;
+  return TRUE;
+}
+
+void LASwriteChunkPool::release()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  Slot* slot = &slots[(size_t)(next_retire % slots.size())];
+  slot->num_points = 0;
+  slot->compressed = FALSE;
+  slot->failed = FALSE;
+  next_retire++;
+}
+
+BOOL LASwriteChunkPool::compress(LASwritePoint* writer, U8** point, Slot* slot)
+{
+  U32 i, p;
+  slot->stream->reset();
+  if (!writer->init(slot->stream)) return FALSE;
+  U8* current = slot->points;
+  for (p = 0; p < slot->num_points; p++)
+  {
+    for (i = 0; i < laszip->num_items; i++)
+    {
+      point[i] = current + item_offsets[i];
+    }
+    if (!writer->write(point)) return FALSE;
+    current += point_size;
+  }
+  return writer->done();
+}
+
+void LASwriteChunkPool::work()
+{
+  LASwritePoint* writer = new LASwritePoint();
+  if (!writer->setup(laszip->num_items, laszip->items, laszip, TRUE))
+  {
+    delete writer;
+    writer = 0;
+  }
+  U8** point = new U8*[laszip->num_items];
+
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true)
+  {
+    changed.wait(lock, [this] { return stop || (next_compress < next_fill); });
+    if (stop) break;
+
+    Slot* slot = &slots[(size_t)(next_compress % slots.size())];
+    next_compress++;
+
+    lock.unlock();
+    BOOL compressed = (writer != 0) && compress(writer, point, slot);
+    lock.lock();
+
+    slot->failed = !compressed;
+    slot->compressed = TRUE;
+#ifdef LASZIP_INSTRUMENT
+    if (writer)
+    {
+      // the counts of each chunk move to the pool while the lock is held anyway
+      for (U32 i = 0; i < laszip->num_items; i++)
+      {
+        counters[i].add(writer->counters[i]);
+        writer->counters[i].reset();
+      }
+    }
+#endif
+    changed.notify_all();
+  }
+  lock.unlock();
+
+  if (writer) delete writer;
+  delete [] point;
+}
+
+#ifdef LASZIP_INSTRUMENT
+void LASwriteChunkPool::add_item_counters(const U32 item, LASitemCounters* sum)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  if (counters && item < laszip->num_items) sum->add(counters[item]);
+}
+#endif
+
+LASwriteChunkPool::~LASwriteChunkPool()
+{
+  U32 i;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stop = TRUE;
+    changed.notify_all();
+  }
+
+  for (i = 0; i < threads.size(); i++)
+  {
+    threads[i].join();
+  }
+
+  for (i = 0; i < slots.size(); i++)
+  {
+    if (slots[i].points) free(slots[i].points);
+    delete slots[i].stream;
+  }
+
+  if (item_offsets) delete [] item_offsets;
+  if (laszip) delete laszip;
+#ifdef LASZIP_INSTRUMENT
+  if (counters) delete [] counters;
+#endif
+}
@@ -0,0 +1,110 @@
+/*
+===============================================================================
+
+  FILE:  laswritechunkpool.hpp
+
+  CONTENTS:
+
+    Compresses whole chunks of points on a pool of worker threads. Each
+    worker owns its own entropy encoder and item writers and compresses
+    into its own memory buffer. The buffers are handed back strictly in
+    the order the chunks were submitted so that a single writer can append
+    them to the output and build the usual chunk table from their sizes.
+
+  PROGRAMMERS:
+
+    agent@local
+
+  COPYRIGHT:
+
+    (c) 2026, agent@local
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the COPYING file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    17 October 2026 -- workers set up their writers for a single chunk without a table
+    17 October 2026 -- sums up what the workers counted for every item (LASZIP_INSTRUMENT)
+    17 October 2026 -- workers write layered chunks for the layered compressor
+    17 October 2026 -- created for multi-threaded chunked compression
+
+===============================================================================
+*/
+#ifndef LAS_WRITE_CHUNK_POOL_H
+#define LAS_WRITE_CHUNK_POOL_H
+
+#include "mydefs.hpp"
+#include "laszip.hpp"
+#include "lasinstrument.hpp"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ByteStreamOutArray;
+class LASwritePoint;
+
+class LASwriteChunkPool
+{
+public:
+  LASwriteChunkPool();
+  ~LASwriteChunkPool();
+
+  // should only be called *once*
+  BOOL setup(const U32 num_items, const LASitem* items, const LASzip* laszip, const U32 num_threads);
+
+  // copy one point into the chunk that is currently being filled
+  BOOL add(const U8 * const * point);
+  // hand the current chunk to the workers (requires a free slot, see full())
+  BOOL submit();
+  // no slot is free until the oldest chunk was retired
+  BOOL full();
+  // the oldest submitted chunk once it is compressed (waits if requested)
+  BOOL retire(const BOOL wait, const U8** bytes, U32* num_bytes, U32* num_points);
+  // give the slot of the chunk returned by retire() back to the pool
+  void release();
+
+#ifdef LASZIP_INSTRUMENT
+  // adds what the workers have counted for this item so far to sum
+  void add_item_counters(const U32 item, LASitemCounters* sum);
+#endif
+
+private:
+  struct Slot
+  {
+    U8* points;
+    U32 num_points;
+    U32 alloced_points;
+    ByteStreamOutArray* stream;
+    BOOL compressed;
+    BOOL failed;
+  };
+  void work();
+  BOOL compress(LASwritePoint* writer, U8** point, Slot* slot);
+
+  LASzip* laszip;
+  U32 point_size;
+  U32* item_offsets;
+
+  std::vector<Slot> slots;
+  std::vector<std::thread> threads;
+  std::mutex mutex;
+  std::condition_variable changed;
+
+  U64 next_fill;     // the chunk being filled by the caller
+  U64 next_compress; // the next submitted chunk a worker picks up
+  U64 next_retire;   // the oldest chunk not yet retired
+  BOOL stop;
+
+#ifdef LASZIP_INSTRUMENT
+  LASitemCounters* counters;
+#endif
+};
+
+#endif
@@ -24,6 +24,7 @@
   
   CHANGE HISTORY:
   
+    17 October 2026 -- compressed items tell which integer compressors they use
     10 January 2011 -- licensing change for LGPL release and liblas integration
     12 December 2010 -- refactored after watching two movies with silke
   
@@ -35,6 +36,10 @@
 #include "mydefs.hpp"
 
 class ByteStreamOut;
+class IntegerCompressor;
+
+// the most integer compressors that a compressed item uses
+#define LASZIP_ITEM_COMPRESSORS_MAX 8
 
 class LASwriteItem
 {
@@ -67,6 +72,10 @@ class LASwriteItemCompressed : public LASwriteItem
 public:
   virtual BOOL init(const U8* item)=0;
 
+  // stores the integer compressors of the item (at most LASZIP_ITEM_COMPRESSORS_MAX)
+  // and the names of the fields they compress and returns how many there are
+  virtual U32 get_integer_compressors(IntegerCompressor**, const char**) const { return 0; };
+
   virtual ~LASwriteItemCompressed(){};
 };
 
@@ -97,6 +97,17 @@ LASwriteItemCompressed_POINT10_v1::~LASwriteItemCompressed_POINT10_v1()
     if (m_user_data[i]) enc->destroySymbolModel(m_user_data[i]);
   }
 }
+
+U32 LASwriteItemCompressed_POINT10_v1::get_integer_compressors(IntegerCompressor** ics, const char** fields) const
+{
+  ics[0] = ic_dx; fields[0] = "dx";
+  ics[1] = ic_dy; fields[1] = "dy";
+  ics[2] = ic_z; fields[2] = "z";
+  ics[3] = ic_intensity; fields[3] = "intensity";
+  ics[4] = ic_scan_angle_rank; fields[4] = "scan_angle_rank";
+  ics[5] = ic_point_source_ID; fields[5] = "point_source_ID";
+  return 6;
+}
 
 BOOL LASwriteItemCompressed_POINT10_v1::init(const U8* item)
 {
@@ -280,6 +291,12 @@ LASwriteItemCompressed_GPSTIME11_v1::~LASwriteItemCompressed_GPSTIME11_v1()
   delete ic_gpstime;
 }
 
+U32 LASwriteItemCompressed_GPSTIME11_v1::get_integer_compressors(IntegerCompressor** ics, const char** fields) const
+{
+  ics[0] = ic_gpstime; fields[0] = "gpstime";
+  return 1;
+}
+
 BOOL LASwriteItemCompressed_GPSTIME11_v1::init(const U8* item)
 {
   /* init state */
@@ -437,6 +454,12 @@ LASwriteItemCompressed_RGB12_v1::~LASwriteItemCompressed_RGB12_v1()
   delete [] last_item;
 }
 
+U32 LASwriteItemCompressed_RGB12_v1::get_integer_compressors(IntegerCompressor** ics, const char** fields) const
+{
+  ics[0] = ic_rgb; fields[0] = "rgb";
+  return 1;
+}
+
 BOOL LASwriteItemCompressed_RGB12_v1::init(const U8* item)
 {
   /* init state */
@@ -520,6 +543,15 @@ LASwriteItemCompressed_WAVEPACKET13_v1::~LASwriteItemCompressed_WAVEPACKET13_v1(
   delete [] last_item;
 }
 
+U32 LASwriteItemCompressed_WAVEPACKET13_v1::get_integer_compressors(IntegerCompressor** ics, const char** fields) const
+{
+  ics[0] = ic_offset_diff; fields[0] = "offset_diff";
+  ics[1] = ic_packet_size; fields[1] = "packet_size";
+  ics[2] = ic_return_point; fields[2] = "return_point";
+  ics[3] = ic_xyz; fields[3] = "xyz";
+  return 4;
+}
+
 BOOL LASwriteItemCompressed_WAVEPACKET13_v1::init(const U8* item)
 {
   /* init state */
@@ -614,6 +646,12 @@ LASwriteItemCompressed_BYTE_v1::~LASwriteItemCompressed_BYTE_v1()
   delete [] last_item;
 }
 
+U32 LASwriteItemCompressed_BYTE_v1::get_integer_compressors(IntegerCompressor** ics, const char** fields) const
+{
+  ics[0] = ic_byte; fields[0] = "byte";
+  return 1;
+}
+
 BOOL LASwriteItemCompressed_BYTE_v1::init(const U8* item)
 {
   /* init state */
@@ -24,6 +24,7 @@
   
   CHANGE HISTORY:
   
+    17 October 2026 -- items list their integer compressors for statistics
     10 January 2011 -- licensing change for LGPL release and liblas integration
     12 December 2010 -- refactored after watching two movies with silke
   
@@ -45,6 +46,8 @@ public:
   BOOL init(const U8* item);
   BOOL write(const U8* item);
 
+  U32 get_integer_compressors(IntegerCompressor** ics, const char** fields) const;
+
   ~LASwriteItemCompressed_POINT10_v1();
 
 private:
@@ -75,6 +78,8 @@ public:
   BOOL init(const U8* item);
   BOOL write(const U8* item);
 
+  U32 get_integer_compressors(IntegerCompressor** ics, const char** fields) const;
+
   ~LASwriteItemCompressed_GPSTIME11_v1();
 
 private:
@@ -97,6 +102,8 @@ public:
   BOOL init(const U8* item);
   BOOL write(const U8* item);
 
+  U32 get_integer_compressors(IntegerCompressor** ics, const char** fields) const;
+
   ~LASwriteItemCompressed_RGB12_v1();
 
 private:
@@ -116,6 +123,8 @@ public:
   BOOL init(const U8* item);
   BOOL write(const U8* item);
 
+  U32 get_integer_compressors(IntegerCompressor** ics, const char** fields) const;
+
   ~LASwriteItemCompressed_WAVEPACKET13_v1();
 
 private:
@@ -141,6 +150,8 @@ public:
   BOOL init(const U8* item);
   BOOL write(const U8* item);
 
+  U32 get_integer_compressors(IntegerCompressor** ics, const char** fields) const;
+
   ~LASwriteItemCompressed_BYTE_v1();
 
 private:
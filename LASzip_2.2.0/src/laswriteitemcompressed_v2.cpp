@@ -56,20 +56,22 @@ struct LASpoint10
   U16 point_source_ID;
 };
 
-LASwriteItemCompressed_POINT10_v2::LASwriteItemCompressed_POINT10_v2(EntropyEncoder* enc)
+LASwriteItemCompressed_POINT10_v2::LASwriteItemCompressed_POINT10_v2(EntropyEncoder* enc, EntropyEncoder* enc_attributes)
 {
   U32 i;
 
-  /* set encoder */
+  /* set encoders */
   assert(enc);
   this->enc = enc;
+  assert(enc_attributes);
+  this->enc_attributes = enc_attributes;
 
   /* create models and integer compressors */
   m_changed_values = enc->createSymbolModel(64);
-  ic_intensity = new IntegerCompressor(enc, 16, 4);
-  m_scan_angle_rank[0] = enc->createSymbolModel(256);
-  m_scan_angle_rank[1] = enc->createSymbolModel(256);
-  ic_point_source_ID = new IntegerCompressor(enc, 16);
+  ic_intensity = new IntegerCompressor(enc_attributes, 16, 4);
+  m_scan_angle_rank[0] = enc_attributes->createSymbolModel(256);
+  m_scan_angle_rank[1] = enc_attributes->createSymbolModel(256);
+  ic_point_source_ID = new IntegerCompressor(enc_attributes, 16);
   for (i = 0; i < 256; i++)
   {
     m_bit_byte[i] = 0;
@@ -87,20 +89,30 @@ LASwriteItemCompressed_POINT10_v2::~LASwriteItemCompressed_POINT10_v2()
 
   enc->destroySymbolModel(m_changed_values);
   delete ic_intensity;
-  enc->destroySymbolModel(m_scan_angle_rank[0]);
-  enc->destroySymbolModel(m_scan_angle_rank[1]);
+  enc_attributes->destroySymbolModel(m_scan_angle_rank[0]);
+  enc_attributes->destroySymbolModel(m_scan_angle_rank[1]);
   delete ic_point_source_ID;
   for (i = 0; i < 256; i++)
   {
     if (m_bit_byte[i]) enc->destroySymbolModel(m_bit_byte[i]);
-    if (m_classification[i]) enc->destroySymbolModel(m_classification[i]);
-    if (m_user_data[i]) enc->destroySymbolModel(m_user_data[i]);
+    if (m_classification[i]) enc_attributes->destroySymbolModel(m_classification[i]);
+    if (m_user_data[i]) enc_attributes->destroySymbolModel(m_user_data[i]);
   }
   delete ic_dx;
   delete ic_dy;
   delete ic_z;
 }
 
+U32 LASwriteItemCompressed_POINT10_v2::get_integer_compressors(IntegerCompressor** ics, const char** fields) const
+{
+  ics[0] = ic_dx; fields[0] = "dx";
+  ics[1] = ic_dy; fields[1] = "dy";
+  ics[2] = ic_z; fields[2] = "z";
+  ics[3] = ic_intensity; fields[3] = "intensity";
+  ics[4] = ic_point_source_ID; fields[4] = "point_source_ID";
+  return 5;
+}
+
 BOOL LASwriteItemCompressed_POINT10_v2::init(const U8* item)
 {
   U32 i;
@@ -117,14 +129,14 @@ BOOL LASwriteItemCompressed_POINT10_v2::init(const U8* item)
   /* init models and integer compressors */
   enc->initSymbolModel(m_changed_values);
   ic_intensity->initCompressor();
-  enc->initSymbolModel(m_scan_angle_rank[0]);
-  enc->initSymbolModel(m_scan_angle_rank[1]);
+  enc_attributes->initSymbolModel(m_scan_angle_rank[0]);
+  enc_attributes->initSymbolModel(m_scan_angle_rank[1]);
   ic_point_source_ID->initCompressor();
   for (i = 0; i < 256; i++)
   {
     if (m_bit_byte[i]) enc->initSymbolModel(m_bit_byte[i]);
-    if (m_classification[i]) enc->initSymbolModel(m_classification[i]);
-    if (m_user_data[i]) enc->initSymbolModel(m_user_data[i]);
+    if (m_classification[i]) enc_attributes->initSymbolModel(m_classification[i]);
+    if (m_user_data[i]) enc_attributes->initSymbolModel(m_user_data[i]);
   }
   ic_dx->initCompressor();
   ic_dy->initCompressor();
@@ -178,16 +190,16 @@ inline BOOL LASwriteItemCompressed_POINT10_v2::write(const U8* item)
   {
     if (m_classification[last_item[15]] == 0)
     {
-      m_classification[last_item[15]] = enc->createSymbolModel(256);
-      enc->initSymbolModel(m_classification[last_item[15]]);
+      m_classification[last_item[15]] = enc_attributes->createSymbolModel(256);
+      enc_attributes->initSymbolModel(m_classification[last_item[15]]);
     }
-    enc->encodeSymbol(m_classification[last_item[15]], item[15]);
+    enc_attributes->encodeSymbol(m_classification[last_item[15]], item[15]);
   }
   
   // compress the scan_angle_rank ... if it has changed
   if (changed_values & 4)
   {
-    enc->encodeSymbol(m_scan_angle_rank[((LASpoint10*)item)->scan_direction_flag], U8_FOLD(item[16]-last_item[16]));
+    enc_attributes->encodeSymbol(m_scan_angle_rank[((LASpoint10*)item)->scan_direction_flag], U8_FOLD(item[16]-last_item[16]));
   }
 
   // compress the user_data ... if it has changed
@@ -195,10 +207,10 @@ inline BOOL LASwriteItemCompressed_POINT10_v2::write(const U8* item)
   {
     if (m_user_data[last_item[17]] == 0)
     {
-      m_user_data[last_item[17]] = enc->createSymbolModel(256);
-      enc->initSymbolModel(m_user_data[last_item[17]]);
+      m_user_data[last_item[17]] = enc_attributes->createSymbolModel(256);
+      enc_attributes->initSymbolModel(m_user_data[last_item[17]]);
     }
-    enc->encodeSymbol(m_user_data[last_item[17]], item[17]);
+    enc_attributes->encodeSymbol(m_user_data[last_item[17]], item[17]);
   }
 
   // compress the point_source_ID ... if it has changed
@@ -261,6 +273,12 @@ LASwriteItemCompressed_GPSTIME11_v2::~LASwriteItemCompressed_GPSTIME11_v2()
   delete ic_gpstime;
 }
 
+U32 LASwriteItemCompressed_GPSTIME11_v2::get_integer_compressors(IntegerCompressor** ics, const char** fields) const
+{
+  ics[0] = ic_gpstime; fields[0] = "gpstime";
+  return 1;
+}
+
 BOOL LASwriteItemCompressed_GPSTIME11_v2::init(const U8* item)
 {
   /* init state */
@@ -552,6 +570,301 @@ inline BOOL LASwriteItemCompressed_RGB12_v2::write(const U8* item)
   return TRUE;
 }
 
+/*
+===============================================================================
+                       LASwriteItemCompressed_POINT14_v2
+===============================================================================
+*/
+
+struct LASpoint14
+{
+  I32 x;
+  I32 y;
+  I32 z;
+  U16 intensity;
+  U8 return_number : 4;
+  U8 number_of_returns_of_given_pulse : 4;
+  U8 classification_flags : 4;
+  U8 scanner_channel : 2;
+  U8 scan_direction_flag : 1;
+  U8 edge_of_flight_line : 1;
+  U8 classification;
+  U8 user_data;
+  I16 scan_angle;
+  U16 point_source_ID;
+};
+
+LASwriteItemCompressed_POINT14_v2::LASwriteItemCompressed_POINT14_v2(EntropyEncoder* enc, EntropyEncoder* enc_attributes, EntropyEncoder* enc_gpstime)
+{
+  U32 i;
+
+  /* set encoders */
+  assert(enc);
+  this->enc = enc;
+  assert(enc_attributes);
+  this->enc_attributes = enc_attributes;
+
+  /* create models and integer compressors */
+  m_changed_values = enc->createSymbolModel(128);
+  ic_intensity = new IntegerCompressor(enc_attributes, 16, 4);
+  ic_scan_angle = new IntegerCompressor(enc_attributes, 16, 2);
+  ic_point_source_ID = new IntegerCompressor(enc_attributes, 16);
+  for (i = 0; i < 256; i++)
+  {
+    m_return_byte[i] = 0;
+    m_flag_byte[i] = 0;
+    m_classification[i] = 0;
+    m_user_data[i] = 0;
+  }
+  ic_dx = new IntegerCompressor(enc, 32, 2);  // 32 bits, 2 context
+  ic_dy = new IntegerCompressor(enc, 32, 22); // 32 bits, 22 contexts
+  ic_z = new IntegerCompressor(enc, 32, 20);  // 32 bits, 20 contexts
+
+  /* the gps time is compressed exactly like a GPSTIME11 item */
+  gpstime = new LASwriteItemCompressed_GPSTIME11_v2(enc_gpstime);
+}
+
+LASwriteItemCompressed_POINT14_v2::~LASwriteItemCompressed_POINT14_v2()
+{
+  U32 i;
+
+  enc->destroySymbolModel(m_changed_values);
+  delete ic_intensity;
+  delete ic_scan_angle;
+  delete ic_point_source_ID;
+  for (i = 0; i < 256; i++)
+  {
+    if (m_return_byte[i]) enc->destroySymbolModel(m_return_byte[i]);
+    if (m_flag_byte[i]) enc_attributes->destroySymbolModel(m_flag_byte[i]);
+    if (m_classification[i]) enc_attributes->destroySymbolModel(m_classification[i]);
+    if (m_user_data[i]) enc_attributes->destroySymbolModel(m_user_data[i]);
+  }
+  delete ic_dx;
+  delete ic_dy;
+  delete ic_z;
+  delete gpstime;
+}
+
+U32 LASwriteItemCompressed_POINT14_v2::get_integer_compressors(IntegerCompressor** ics, const char** fields) const
+{
+  ics[0] = ic_dx; fields[0] = "dx";
+  ics[1] = ic_dy; fields[1] = "dy";
+  ics[2] = ic_z; fields[2] = "z";
+  ics[3] = ic_intensity; fields[3] = "intensity";
+  ics[4] = ic_scan_angle; fields[4] = "scan_angle";
+  ics[5] = ic_point_source_ID; fields[5] = "point_source_ID";
+  // the gps time has its own writer
+  return 6 + gpstime->get_integer_compressors(ics + 6, fields + 6);
+}
+
+BOOL LASwriteItemCompressed_POINT14_v2::init(const U8* item)
+{
+  U32 i;
+
+  /* init state */
+  for (i=0; i < 16; i++)
+  {
+    last_x_diff_median5[i].init();
+    last_y_diff_median5[i].init();
+    last_intensity[i] = 0;
+    last_height[i/2] = 0;
+  }
+
+  /* init models and integer compressors */
+  enc->initSymbolModel(m_changed_values);
+  ic_intensity->initCompressor();
+  ic_scan_angle->initCompressor();
+  ic_point_source_ID->initCompressor();
+  for (i = 0; i < 256; i++)
+  {
+    if (m_return_byte[i]) enc->initSymbolModel(m_return_byte[i]);
+    if (m_flag_byte[i]) enc_attributes->initSymbolModel(m_flag_byte[i]);
+    if (m_classification[i]) enc_attributes->initSymbolModel(m_classification[i]);
+    if (m_user_data[i]) enc_attributes->initSymbolModel(m_user_data[i]);
+  }
+  ic_dx->initCompressor();
+  ic_dy->initCompressor();
+  ic_z->initCompressor();
+  if (!gpstime->init(item + 22)) return FALSE;
+
+  /* init last item */
+  memcpy(last_item, item, 22);
+
+  return TRUE;
+}
+
+inline BOOL LASwriteItemCompressed_POINT14_v2::write(const U8* item)
+{
+  // up to 15 returns share the contexts of the first 7
+  U32 r = ((LASpoint14*)item)->return_number;
+  U32 n = ((LASpoint14*)item)->number_of_returns_of_given_pulse;
+  U32 m = number_return_map[n < 8 ? n : 7][r < 8 ? r : 7];
+  U32 l = number_return_level[n < 8 ? n : 7][r < 8 ? r : 7];
+  U32 k_bits;
+  I32 median, diff;
+
+  // compress which other values have changed
+  I32 changed_values = (((last_item[14] != item[14]) << 6) | // return byte
+                        ((last_item[15] != item[15]) << 5) | // flag byte
+                        ((last_intensity[m] != ((LASpoint14*)item)->intensity) << 4) |
+                        ((last_item[16] != item[16]) << 3) | // classification
+                        ((((LASpoint14*)last_item)->scan_angle != ((LASpoint14*)item)->scan_angle) << 2) |
+                        ((last_item[17] != item[17]) << 1) | // user_data
+                        (((LASpoint14*)last_item)->point_source_ID != ((LASpoint14*)item)->point_source_ID));
+
+  enc->encodeSymbol(m_changed_values, changed_values);
+
+  // compress the return_number and number_of_returns_of_given_pulse if they have changed
+  if (changed_values & 64)
+  {
+    if (m_return_byte[last_item[14]] == 0)
+    {
+      m_return_byte[last_item[14]] = enc->createSymbolModel(256);
+      enc->initSymbolModel(m_return_byte[last_item[14]]);
+    }
+    enc->encodeSymbol(m_return_byte[last_item[14]], item[14]);
+  }
+
+  // compress the classification_flags, scanner_channel, scan_direction_flag, ... if they have changed
+  if (changed_values & 32)
+  {
+    if (m_flag_byte[last_item[15]] == 0)
+    {
+      m_flag_byte[last_item[15]] = enc_attributes->createSymbolModel(256);
+      enc_attributes->initSymbolModel(m_flag_byte[last_item[15]]);
+    }
+    enc_attributes->encodeSymbol(m_flag_byte[last_item[15]], item[15]);
+  }
+
+  // compress the intensity if it has changed
+  if (changed_values & 16)
+  {
+    ic_intensity->compress(last_intensity[m], ((LASpoint14*)item)->intensity, (m < 3 ? m : 3));
+    last_intensity[m] = ((LASpoint14*)item)->intensity;
+  }
+
+  // compress the classification ... if it has changed
+  if (changed_values & 8)
+  {
+    if (m_classification[last_item[16]] == 0)
+    {
+      m_classification[last_item[16]] = enc_attributes->createSymbolModel(256);
+      enc_attributes->initSymbolModel(m_classification[last_item[16]]);
+    }
+    enc_attributes->encodeSymbol(m_classification[last_item[16]], item[16]);
+  }
+
+  // compress the scan_angle ... if it has changed
+  if (changed_values & 4)
+  {
+    ic_scan_angle->compress((U16)((LASpoint14*)last_item)->scan_angle, (U16)((LASpoint14*)item)->scan_angle, ((LASpoint14*)item)->scan_direction_flag);
+  }
+
+  // compress the user_data ... if it has changed
+  if (changed_values & 2)
+  {
+    if (m_user_data[last_item[17]] == 0)
+    {
+      m_user_data[last_item[17]] = enc_attributes->createSymbolModel(256);
+      enc_attributes->initSymbolModel(m_user_data[last_item[17]]);
+    }
+    enc_attributes->encodeSymbol(m_user_data[last_item[17]], item[17]);
+  }
+
+  // compress the point_source_ID ... if it has changed
+  if (changed_values & 1)
+  {
+    ic_point_source_ID->compress(((LASpoint14*)last_item)->point_source_ID, ((LASpoint14*)item)->point_source_ID);
+  }
+
+  // compress x coordinate
+  median = last_x_diff_median5[m].get();
+  diff = ((LASpoint14*)item)->x - ((LASpoint14*)last_item)->x;
+  ic_dx->compress(median, diff, n==1);
+  last_x_diff_median5[m].add(diff);
+
+  // compress y coordinate
+  k_bits = ic_dx->getK();
+  median = last_y_diff_median5[m].get();
+  diff = ((LASpoint14*)item)->y - ((LASpoint14*)last_item)->y;
+  ic_dy->compress(median, diff, (n==1) + ( k_bits < 20 ? U32_ZERO_BIT_0(k_bits) : 20 ));
+  last_y_diff_median5[m].add(diff);
+
+  // compress z coordinate
+  k_bits = (ic_dx->getK() + ic_dy->getK()) / 2;
+  ic_z->compress(last_height[l], ((LASpoint14*)item)->z, (n==1) + (k_bits < 18 ? U32_ZERO_BIT_0(k_bits) : 18));
+  last_height[l] = ((LASpoint14*)item)->z;
+
+  // copy the last item
+  memcpy(last_item, item, 22);
+
+  // compress the gps_time
+  return gpstime->LASwriteItemCompressed_GPSTIME11_v2::write(item + 22);
+}
+
+/*
+===============================================================================
+                       LASwriteItemCompressed_RGBNIR14_v2
+===============================================================================
+*/
+
+LASwriteItemCompressed_RGBNIR14_v2::LASwriteItemCompressed_RGBNIR14_v2(EntropyEncoder* enc)
+{
+  /* set encoder */
+  assert(enc);
+  this->enc = enc;
+
+  /* the RGB part is compressed exactly like a RGB12 item */
+  rgb = new LASwriteItemCompressed_RGB12_v2(enc);
+
+  /* create models and integer compressors */
+  m_nir_byte_used = enc->createSymbolModel(4);
+  m_nir_diff_0 = enc->createSymbolModel(256);
+  m_nir_diff_1 = enc->createSymbolModel(256);
+}
+
+LASwriteItemCompressed_RGBNIR14_v2::~LASwriteItemCompressed_RGBNIR14_v2()
+{
+  delete rgb;
+  enc->destroySymbolModel(m_nir_byte_used);
+  enc->destroySymbolModel(m_nir_diff_0);
+  enc->destroySymbolModel(m_nir_diff_1);
+}
+
+BOOL LASwriteItemCompressed_RGBNIR14_v2::init(const U8* item)
+{
+  /* init state */
+  if (!rgb->init(item)) return FALSE;
+
+  /* init models and integer compressors */
+  enc->initSymbolModel(m_nir_byte_used);
+  enc->initSymbolModel(m_nir_diff_0);
+  enc->initSymbolModel(m_nir_diff_1);
+
+  /* init last item */
+  last_nir = ((U16*)item)[3];
+  return TRUE;
+}
+
+inline BOOL LASwriteItemCompressed_RGBNIR14_v2::write(const U8* item)
+{
+  U16 nir = ((U16*)item)[3];
+  if (!rgb->LASwriteItemCompressed_RGB12_v2::write(item)) return FALSE;
+  U32 sym = ((last_nir&0x00FF) != (nir&0x00FF)) << 0;
+  sym |= ((last_nir&0xFF00) != (nir&0xFF00)) << 1;
+  enc->encodeSymbol(m_nir_byte_used, sym);
+  if (sym & (1 << 0))
+  {
+    enc->encodeSymbol(m_nir_diff_0, U8_FOLD((nir&255) - (last_nir&255)));
+  }
+  if (sym & (1 << 1))
+  {
+    enc->encodeSymbol(m_nir_diff_1, U8_FOLD((nir>>8) - (last_nir>>8)));
+  }
+  last_nir = nir;
+  return TRUE;
+}
+
 /*
 ===============================================================================
                        LASwriteItemCompressed_BYTE_v2
@@ -619,3 +932,72 @@ inline BOOL LASwriteItemCompressed_BYTE_v2::write(const U8* item)
   return TRUE;
 }
 
+
+#ifdef LASZIP_INSTRUMENT
+#define LASZIP_COUNT_FUSED(i, write_item) LASZIP_COUNT(positions, counters, i, write_item)
+#else
+#define LASZIP_COUNT_FUSED(i, write_item) write_item
+#endif
+
+// the item writers are called directly so that they can be inlined
+template <BOOL GPSTIME, BOOL RGB>
+class LASwriteFusedCompressed_POINT10_v2 : public LASwriteFusedCompressed_v2
+{
+public:
+
+  LASwriteFusedCompressed_POINT10_v2(LASwriteItem** writers)
+  {
+    point10 = (LASwriteItemCompressed_POINT10_v2*)writers[0];
+    gpstime11 = (GPSTIME ? (LASwriteItemCompressed_GPSTIME11_v2*)writers[1] : 0);
+    rgb12 = (RGB ? (LASwriteItemCompressed_RGB12_v2*)writers[GPSTIME ? 2 : 1] : 0);
+  }
+
+  BOOL write(const U8 * const * point)
+  {
+    LASZIP_COUNT_FUSED(0, point10->LASwriteItemCompressed_POINT10_v2::write(point[0]));
+    if (GPSTIME) LASZIP_COUNT_FUSED(1, gpstime11->LASwriteItemCompressed_GPSTIME11_v2::write(point[1]));
+    if (RGB) LASZIP_COUNT_FUSED((GPSTIME ? 2 : 1), rgb12->LASwriteItemCompressed_RGB12_v2::write(point[GPSTIME ? 2 : 1]));
+    return TRUE;
+  }
+
+private:
+  LASwriteItemCompressed_POINT10_v2* point10;
+  LASwriteItemCompressed_GPSTIME11_v2* gpstime11;
+  LASwriteItemCompressed_RGB12_v2* rgb12;
+};
+
+LASwriteFusedCompressed_v2* LASwriteFusedCompressed_v2::create(const U32 num_items, const LASitem* items, LASwriteItem** writers)
+{
+  U32 i = 0;
+  BOOL gpstime = FALSE;
+  BOOL rgb = FALSE;
+
+  if (num_items == 0 || items[0].type != LASitem::POINT10 || items[0].version != 2) return 0;
+  i++;
+  if (i < num_items && items[i].type == LASitem::GPSTIME11 && items[i].version == 2)
+  {
+    gpstime = TRUE;
+    i++;
+  }
+  if (i < num_items && items[i].type == LASitem::RGB12 && items[i].version == 2)
+  {
+    rgb = TRUE;
+    i++;
+  }
+  if (i != num_items) return 0;
+
+  if (gpstime)
+  {
+    if (rgb)
+      return new LASwriteFusedCompressed_POINT10_v2<TRUE, TRUE>(writers);
+    else
+      return new LASwriteFusedCompressed_POINT10_v2<TRUE, FALSE>(writers);
+  }
+  else
+  {
+    if (rgb)
+      return new LASwriteFusedCompressed_POINT10_v2<FALSE, TRUE>(writers);
+    else
+      return new LASwriteFusedCompressed_POINT10_v2<FALSE, FALSE>(writers);
+  }
+}
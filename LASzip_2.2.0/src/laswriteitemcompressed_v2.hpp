@@ -24,6 +24,11 @@
   
   CHANGE HISTORY:
   
+    17 October 2026 -- the fused writer can count each of its items (LASZIP_INSTRUMENT)
+    17 October 2026 -- items list their integer compressors for statistics
+    17 October 2026 -- attributes (and POINT14 gps time) may use their own encoders
+    17 October 2026 -- compressed POINT14 and RGBNIR14 for LAS 1.4 point types
+    17 October 2026 -- fused writer for POINT10 with GPSTIME11 and/or RGB12
     5 March 2011 -- created first night in ibiza to improve the RGB compressor
 
 ===============================================================================
@@ -36,20 +41,26 @@
 #include "integercompressor.hpp"
 
 #include "laszip_common_v2.hpp"
+#include "laszip.hpp"
+#include "lasinstrument.hpp"
 
 class LASwriteItemCompressed_POINT10_v2 : public LASwriteItemCompressed
 {
 public:
 
-  LASwriteItemCompressed_POINT10_v2(EntropyEncoder* enc);
+  // the attributes are encoded with their own encoder (which may be the same)
+  LASwriteItemCompressed_POINT10_v2(EntropyEncoder* enc, EntropyEncoder* enc_attributes);
 
   BOOL init(const U8* item);
   BOOL write(const U8* item);
 
+  U32 get_integer_compressors(IntegerCompressor** ics, const char** fields) const;
+
   ~LASwriteItemCompressed_POINT10_v2();
 
 private:
   EntropyEncoder* enc;
+  EntropyEncoder* enc_attributes;
   U8 last_item[20];
   U16 last_intensity[16];
   StreamingMedian5 last_x_diff_median5[16];
@@ -77,6 +88,8 @@ public:
   BOOL init(const U8* item);
   BOOL write(const U8* item);
 
+  U32 get_integer_compressors(IntegerCompressor** ics, const char** fields) const;
+
   ~LASwriteItemCompressed_GPSTIME11_v2();
 
 private:
@@ -115,6 +128,64 @@ private:
   EntropyModel* m_rgb_diff_5;
 };
 
+class LASwriteItemCompressed_POINT14_v2 : public LASwriteItemCompressed
+{
+public:
+
+  // the attributes and the gps time are encoded with their own encoders (which may be the same)
+  LASwriteItemCompressed_POINT14_v2(EntropyEncoder* enc, EntropyEncoder* enc_attributes, EntropyEncoder* enc_gpstime);
+
+  BOOL init(const U8* item);
+  BOOL write(const U8* item);
+
+  U32 get_integer_compressors(IntegerCompressor** ics, const char** fields) const;
+
+  ~LASwriteItemCompressed_POINT14_v2();
+
+private:
+  EntropyEncoder* enc;
+  EntropyEncoder* enc_attributes;
+  U8 last_item[22];
+  U16 last_intensity[16];
+  StreamingMedian5 last_x_diff_median5[16];
+  StreamingMedian5 last_y_diff_median5[16];
+  I32 last_height[8];
+
+  EntropyModel* m_changed_values;
+  IntegerCompressor* ic_intensity;
+  IntegerCompressor* ic_scan_angle;
+  IntegerCompressor* ic_point_source_ID;
+  EntropyModel* m_return_byte[256];
+  EntropyModel* m_flag_byte[256];
+  EntropyModel* m_classification[256];
+  EntropyModel* m_user_data[256];
+  IntegerCompressor* ic_dx;
+  IntegerCompressor* ic_dy;
+  IntegerCompressor* ic_z;
+  LASwriteItemCompressed_GPSTIME11_v2* gpstime;
+};
+
+class LASwriteItemCompressed_RGBNIR14_v2 : public LASwriteItemCompressed
+{
+public:
+
+  LASwriteItemCompressed_RGBNIR14_v2(EntropyEncoder* enc);
+
+  BOOL init(const U8* item);
+  BOOL write(const U8* item);
+
+  ~LASwriteItemCompressed_RGBNIR14_v2();
+
+private:
+  EntropyEncoder* enc;
+  U16 last_nir;
+
+  EntropyModel* m_nir_byte_used;
+  EntropyModel* m_nir_diff_0;
+  EntropyModel* m_nir_diff_1;
+  LASwriteItemCompressed_RGB12_v2* rgb;
+};
+
 class LASwriteItemCompressed_BYTE_v2 : public LASwriteItemCompressed
 {
 public:
@@ -134,4 +205,24 @@ private:
   EntropyModel** m_byte;
 };
 
+class LASwriteFusedCompressed_v2
+{
+public:
+
+  // returns 0 unless the items are POINT10 followed by GPSTIME11 and/or RGB12 (all version 2)
+  static LASwriteFusedCompressed_v2* create(const U32 num_items, const LASitem* items, LASwriteItem** writers);
+
+  virtual BOOL write(const U8 * const * point)=0;
+
+  virtual ~LASwriteFusedCompressed_v2(){};
+
+#ifdef LASZIP_INSTRUMENT
+  // every item is still counted on its own
+  void count(const LASitemPositions* positions, LASitemCounters* counters) { this->positions = positions; this->counters = counters; };
+protected:
+  const LASitemPositions* positions;
+  LASitemCounters* counters;
+#endif
+};
+
 #endif
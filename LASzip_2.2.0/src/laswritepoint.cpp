@@ -32,13 +32,24 @@
 #include "laswritepoint.hpp"
 
 #include "arithmeticencoder.hpp"
+#include "ransencoder.hpp"
+#include "integercompressor.hpp"
 #include "laswriteitemraw.hpp"
 #include "laswriteitemcompressed_v1.hpp"
 #include "laswriteitemcompressed_v2.hpp"
+#include "laswritechunkpool.hpp"
+#include "bytestreamout_array.hpp"
 
 #include <string.h>
 #include <stdlib.h>
 
+#ifdef LASZIP_INSTRUMENT
+// writes an item and counts its cycles and bytes
+#define LASZIP_COUNT_ITEM(i, write_item) LASZIP_COUNT(this, counters, i, write_item)
+#else
+#define LASZIP_COUNT_ITEM(i, write_item) write_item
+#endif
+
 LASwritePoint::LASwritePoint()
 {
   outstream = 0;
@@ -46,7 +57,19 @@ LASwritePoint::LASwritePoint()
   writers = 0;
   writers_raw = 0;
   writers_compressed = 0;
+  fused = 0;
   enc = 0;
+  laszip = 0;
+  pool = 0;
+  // used for layered compression
+  num_layers = 0;
+  layer_encs = 0;
+  layer_streams = 0;
+  item_layers = 0;
+  // used for statistics
+  statistics = FALSE;
+  item_points = 0;
+  item_bits = 0;
   // used for chunking
   chunk_size = U32_MAX;
   chunk_count = 0;
@@ -56,9 +79,38 @@ LASwritePoint::LASwritePoint()
   chunk_bytes = 0;
   chunk_table_start_position = 0;
   chunk_start_position = 0;
+  chunk_stream = 0;
+  // used for chunk summaries
+  summary_contents = LASZIP_CHUNK_SUMMARY_NONE;
+  summary_chunks = 0;
+  alloced_summaries = 0;
+  chunk_bounds = 0;
+  chunk_classifications = 0;
+  chunk_return_numbers = 0;
+  chunk_gps_times = 0;
+  chunk_intensities = 0;
+  summary_point14 = FALSE;
+  summary_gps_time_item = -1;
+  summary_gps_time_offset = 0;
+#ifdef LASZIP_INSTRUMENT
+  counters = 0;
+#endif
 }
 
-BOOL LASwritePoint::setup(const U32 num_items, const LASitem* items, const LASzip* laszip)
+EntropyEncoder* LASwritePoint::create_encoder() const
+{
+  switch (laszip->coder)
+  {
+  case LASZIP_CODER_ARITHMETIC:
+    return new ArithmeticEncoder();
+  case LASZIP_CODER_RANS:
+    return new RANSEncoder();
+  }
+  // entropy encoder not supported
+  return 0;
+}
+
+BOOL LASwritePoint::setup(const U32 num_items, const LASitem* items, const LASzip* laszip, const BOOL single_chunk)
 {
   U32 i;
 
@@ -69,19 +121,14 @@ BOOL LASwritePoint::setup(const U32 num_items, const LASitem* items, const LASzi
     if (items != laszip->items) return FALSE;
   }
 
+  this->laszip = laszip;
+
   // create entropy encoder (if requested)
   enc = 0;
   if (laszip && laszip->compressor)
   {
-    switch (laszip->coder)
-    {
-    case LASZIP_CODER_ARITHMETIC:
-      enc = new ArithmeticEncoder();
-      break;
-    default:
-      // entropy decoder not supported
-      return FALSE;
-    }
+    enc = create_encoder();
+    if (enc == 0) return FALSE;
   }
 
   // initizalize the writers
@@ -91,6 +138,11 @@ BOOL LASwritePoint::setup(const U32 num_items, const LASitem* items, const LASzi
   // disable chunking
   chunk_size = U32_MAX;
 
+#ifdef LASZIP_INSTRUMENT
+  if (counters) delete [] counters;
+  counters = new LASitemCounters[num_writers];
+#endif
+
   // always create the raw writers
   writers_raw = new LASwriteItem*[num_writers];
   memset(writers_raw, 0, num_writers*sizeof(LASwriteItem*));
@@ -127,7 +179,13 @@ BOOL LASwritePoint::setup(const U32 num_items, const LASitem* items, const LASzi
       break;
     case LASitem::POINT14:
       if (IS_LITTLE_ENDIAN())
-        writers_raw[i] = new LASwriteItemRaw_POINT14_LE();
+      {
+        // our own compressor works on the plain LAS 1.4 record
+        if (items[i].version == LASZIP_ITEM14_VERSION)
+          writers_raw[i] = new LASwriteItemRaw_BYTE(30);
+        else
+          writers_raw[i] = new LASwriteItemRaw_POINT14_LE();
+      }
       else
         return FALSE;
       break;
@@ -142,6 +200,30 @@ BOOL LASwritePoint::setup(const U32 num_items, const LASitem* items, const LASzi
     }
   }
 
+  // the layered compressor gives each layer its own encoder and buffer
+  U32 l, layer = 0;
+  U32 selective[LASZIP_LAYERS_PER_ITEM_MAX];
+  if (enc && laszip->compressor == LASZIP_COMPRESSOR_LAYERED_CHUNKED)
+  {
+    num_layers = 0;
+    for (i = 0; i < num_writers; i++)
+    {
+      if (items[i].version < 2 && items[i].type != LASitem::WAVEPACKET13) return FALSE;
+      num_layers += get_layers_v2(&items[i], selective);
+    }
+    layer_encs = new EntropyEncoder*[num_layers];
+    layer_streams = new ByteStreamOutArray*[num_layers];
+    item_layers = new U32[num_writers+1];
+    for (l = 0; l < num_layers; l++)
+    {
+      layer_encs[l] = create_encoder();
+      if (IS_LITTLE_ENDIAN())
+        layer_streams[l] = new ByteStreamOutArrayLE();
+      else
+        layer_streams[l] = new ByteStreamOutArrayBE();
+    }
+  }
+
   // if needed create the compressed writers and set versions
   if (enc)
   {
@@ -149,43 +231,64 @@ BOOL LASwritePoint::setup(const U32 num_items, const LASitem* items, const LASzi
     memset(writers_compressed, 0, num_writers*sizeof(LASwriteItem*));
     for (i = 0; i < num_writers; i++)
     {
+      // every layer of the item has its own encoder unless it is pointwise
+      EntropyEncoder* encs[LASZIP_LAYERS_PER_ITEM_MAX] = { enc, enc, enc };
+      if (layer_encs)
+      {
+        U32 number = get_layers_v2(&items[i], selective);
+        item_layers[i] = layer;
+        item_layers[i+1] = layer + number;
+        for (l = 0; l < number; l++) encs[l] = layer_encs[layer++];
+      }
       switch (items[i].type)
       {
       case LASitem::POINT10:
         if (items[i].version == 1)
-          writers_compressed[i] = new LASwriteItemCompressed_POINT10_v1(enc);
+          writers_compressed[i] = new LASwriteItemCompressed_POINT10_v1(encs[0]);
         else if (items[i].version == 2)
-          writers_compressed[i] = new LASwriteItemCompressed_POINT10_v2(enc);
+          writers_compressed[i] = new LASwriteItemCompressed_POINT10_v2(encs[0], encs[1]);
         else
           return FALSE;
         break;
       case LASitem::GPSTIME11:
         if (items[i].version == 1)
-          writers_compressed[i] = new LASwriteItemCompressed_GPSTIME11_v1(enc);
+          writers_compressed[i] = new LASwriteItemCompressed_GPSTIME11_v1(encs[0]);
         else if (items[i].version == 2)
-          writers_compressed[i] = new LASwriteItemCompressed_GPSTIME11_v2(enc);
+          writers_compressed[i] = new LASwriteItemCompressed_GPSTIME11_v2(encs[0]);
         else
           return FALSE;
         break;
       case LASitem::RGB12:
         if (items[i].version == 1)
-          writers_compressed[i] = new LASwriteItemCompressed_RGB12_v1(enc);
+          writers_compressed[i] = new LASwriteItemCompressed_RGB12_v1(encs[0]);
         else if (items[i].version == 2)
-          writers_compressed[i] = new LASwriteItemCompressed_RGB12_v2(enc);
+          writers_compressed[i] = new LASwriteItemCompressed_RGB12_v2(encs[0]);
         else
           return FALSE;
         break;
       case LASitem::WAVEPACKET13:
         if (items[i].version == 1)
-         writers_compressed[i] = new LASwriteItemCompressed_WAVEPACKET13_v1(enc);
+         writers_compressed[i] = new LASwriteItemCompressed_WAVEPACKET13_v1(encs[0]);
         else
           return FALSE;
         break;
       case LASitem::BYTE:
         if (items[i].version == 1)
-         writers_compressed[i] = new LASwriteItemCompressed_BYTE_v1(enc, items[i].size);
+         writers_compressed[i] = new LASwriteItemCompressed_BYTE_v1(encs[0], items[i].size);
         else if (items[i].version == 2)
-          writers_compressed[i] = new LASwriteItemCompressed_BYTE_v2(enc, items[i].size);
+          writers_compressed[i] = new LASwriteItemCompressed_BYTE_v2(encs[0], items[i].size);
+        else
+          return FALSE;
+        break;
+      case LASitem::POINT14:
+        if (items[i].version == LASZIP_ITEM14_VERSION)
+          writers_compressed[i] = new LASwriteItemCompressed_POINT14_v2(encs[0], encs[1], encs[2]);
+        else
+          return FALSE;
+        break;
+      case LASitem::RGBNIR14:
+        if (items[i].version == LASZIP_ITEM14_VERSION)
+          writers_compressed[i] = new LASwriteItemCompressed_RGBNIR14_v2(encs[0]);
         else
           return FALSE;
         break;
@@ -193,7 +296,13 @@ BOOL LASwritePoint::setup(const U32 num_items, const LASitem* items, const LASzi
         return FALSE;
       }
     }
-    if (laszip->compressor == LASZIP_COMPRESSOR_POINTWISE_CHUNKED)
+    // the common point types are encoded by one fused writer
+    if (fused) delete fused;
+    fused = LASwriteFusedCompressed_v2::create(num_writers, items, writers_compressed);
+#ifdef LASZIP_INSTRUMENT
+    if (fused) fused->count(this, counters);
+#endif
+    if (((laszip->compressor == LASZIP_COMPRESSOR_POINTWISE_CHUNKED) || (laszip->compressor == LASZIP_COMPRESSOR_LAYERED_CHUNKED)) && !single_chunk)
     {
       if (laszip->chunk_size) chunk_size = laszip->chunk_size;
       chunk_count = 0;
@@ -203,6 +312,87 @@ BOOL LASwritePoint::setup(const U32 num_items, const LASitem* items, const LASzi
   return TRUE;
 }
 
+BOOL LASwritePoint::set_threads(const U32 num_threads)
+{
+  // only independently compressed chunks can be handed to other threads
+  if (enc == 0 || number_chunks != U32_MAX || num_threads < 2) return TRUE;
+  // the statistics are kept by the integer compressors of this thread
+  if (pool || statistics) return FALSE;
+  pool = new LASwriteChunkPool();
+  if (!pool->setup(num_writers, laszip->items, laszip, num_threads))
+  {
+    delete pool;
+    pool = 0;
+    return FALSE;
+  }
+  return TRUE;
+}
+
+BOOL LASwritePoint::set_chunk_summary(const U32 contents)
+{
+  U32 i;
+  if (contents == LASZIP_CHUNK_SUMMARY_NONE) return TRUE;
+  if (number_chunks != U32_MAX || (contents & ~LASZIP_CHUNK_SUMMARY_ALL)) return FALSE;
+  // the coordinates are the first 12 bytes of the first item
+  if (laszip->items[0].type != LASitem::POINT10 && laszip->items[0].type != LASitem::POINT14) return FALSE;
+  summary_point14 = (laszip->items[0].type == LASitem::POINT14);
+  if (contents & LASZIP_CHUNK_SUMMARY_GPS_TIME)
+  {
+    // the gps time is part of POINT14 or a GPSTIME11 item of its own
+    if (summary_point14)
+    {
+      summary_gps_time_item = 0;
+      summary_gps_time_offset = 22;
+    }
+    else
+    {
+      for (i = 1; i < num_writers; i++)
+      {
+        if (laszip->items[i].type == LASitem::GPSTIME11)
+        {
+          summary_gps_time_item = i;
+          summary_gps_time_offset = 0;
+          break;
+        }
+      }
+      if (summary_gps_time_item == -1) return FALSE;
+    }
+  }
+  summary_contents = contents;
+  summary_chunks = 0;
+  return init_chunk_summary();
+}
+
+BOOL LASwritePoint::set_statistics(const BOOL statistics)
+{
+  U32 i, j;
+  if (pool || writers_raw == 0 || laszip == 0) return FALSE;
+  if (this->statistics == statistics) return TRUE;
+  this->statistics = statistics;
+  if (statistics)
+  {
+    item_points = new I64[num_writers];
+    item_bits = new F64[num_writers];
+    memset(item_points, 0, num_writers*sizeof(I64));
+    memset(item_bits, 0, num_writers*sizeof(F64));
+  }
+  else
+  {
+    delete [] item_points;
+    delete [] item_bits;
+    item_points = 0;
+    item_bits = 0;
+  }
+  IntegerCompressor* ics[LASZIP_ITEM_COMPRESSORS_MAX];
+  const char* fields[LASZIP_ITEM_COMPRESSORS_MAX];
+  for (i = 0; i < num_writers; i++)
+  {
+    U32 number = get_integer_compressors(i, ics, fields);
+    for (j = 0; j < number; j++) ics[j]->setStatistics(statistics);
+  }
+  return TRUE;
+}
+
 BOOL LASwritePoint::init(ByteStreamOut* outstream)
 {
   if (!outstream) return FALSE;
@@ -222,12 +412,20 @@ BOOL LASwritePoint::init(ByteStreamOut* outstream)
     }
     outstream->put64bitsLE((U8*)&chunk_table_start_position);
     chunk_start_position = outstream->tell();
+    // every chunk is compressed into memory and then written with one call
+    if (chunk_stream == 0 && pool == 0)
+    {
+      if (IS_LITTLE_ENDIAN())
+        chunk_stream = new ByteStreamOutArrayLE(LASZIP_CHUNK_STREAM_SIZE);
+      else
+        chunk_stream = new ByteStreamOutArrayBE(LASZIP_CHUNK_STREAM_SIZE);
+    }
   }
 
   U32 i;
   for (i = 0; i < num_writers; i++)
   {
-    ((LASwriteItemRaw*)(writers_raw[i]))->init(outstream);
+    ((LASwriteItemRaw*)(writers_raw[i]))->init(chunk_stream ? chunk_stream : outstream);
   }
 
   if (enc)
@@ -246,31 +444,72 @@ BOOL LASwritePoint::write(const U8 * const * point)
 {
   U32 i;
 
+  if (pool)
+  {
+    if (chunk_count == chunk_size)
+    {
+      if (!pool->submit()) return FALSE;
+      if (summary_contents && !add_chunk_summary()) return FALSE;
+      if (!write_chunks(FALSE)) return FALSE;
+      chunk_count = 0;
+    }
+    chunk_count++;
+    if (summary_contents) add_to_summary(point);
+    return pool->add(point);
+  }
+
   if (chunk_count == chunk_size)
   {
-    enc->done();
-    add_chunk_to_table();
+    if (!done_coders()) return FALSE;
+    add_chunk_to_table(chunk_count);
+    if (summary_contents && !add_chunk_summary()) return FALSE;
     init(outstream);
     chunk_count = 0;
   }
   chunk_count++;
+  if (summary_contents) add_to_summary(point);
 
-  if (writers)
+  if (fused && writers == writers_compressed && !statistics)
+  {
+    fused->write(point);
+  }
+  else if (statistics)
+  {
+    // the first point of a chunk is written raw by the compressed writers
+    LASwriteItem** stat_writers = (writers ? writers : writers_raw);
+    for (i = 0; i < num_writers; i++)
+    {
+      F64 bits = item_tell_bits(i);
+      stat_writers[i]->write(point[i]);
+      if (writers == writers_compressed)
+        item_bits[i] += item_tell_bits(i) - bits;
+      else
+        item_bits[i] += 8.0*laszip->items[i].size;
+      item_points[i]++;
+      if (writers == 0) ((LASwriteItemCompressed*)(writers_compressed[i]))->init(point[i]);
+    }
+    if (writers == 0)
+    {
+      writers = writers_compressed;
+      init_coders();
+    }
+  }
+  else if (writers)
   {
     for (i = 0; i < num_writers; i++)
     {
-      writers[i]->write(point[i]);
+      LASZIP_COUNT_ITEM(i, writers[i]->write(point[i]));
     }
   }
   else
   {
     for (i = 0; i < num_writers; i++)
     {
-      writers_raw[i]->write(point[i]);
+      LASZIP_COUNT_ITEM(i, writers_raw[i]->write(point[i]));
       ((LASwriteItemCompressed*)(writers_compressed[i]))->init(point[i]);
     }
     writers = writers_compressed;
-    enc->init(outstream);
+    init_coders();
   }
   return TRUE;
 }
@@ -281,8 +520,19 @@ BOOL LASwritePoint::chunk()
   {
     return FALSE;
   }
-  enc->done();
-  add_chunk_to_table();
+  // an empty chunk would only add an empty entry to the table
+  if (chunk_count == 0) return TRUE;
+  if (pool)
+  {
+    if (!pool->submit()) return FALSE;
+    if (summary_contents && !add_chunk_summary()) return FALSE;
+    if (!write_chunks(FALSE)) return FALSE;
+    chunk_count = 0;
+    return TRUE;
+  }
+  if (!done_coders()) return FALSE;
+  add_chunk_to_table(chunk_count);
+  if (summary_contents && !add_chunk_summary()) return FALSE;
   init(outstream);
   chunk_count = 0;
   return TRUE;
@@ -290,12 +540,28 @@ BOOL LASwritePoint::chunk()
 
 BOOL LASwritePoint::done()
 {
+  if (pool)
+  {
+    if (chunk_count)
+    {
+      if (!pool->submit()) return FALSE;
+      if (summary_contents && !add_chunk_summary()) return FALSE;
+      chunk_count = 0;
+    }
+    if (!write_chunks(TRUE)) return FALSE;
+    return write_chunk_table();
+  }
+
   if (writers == writers_compressed)
   {
-    enc->done();
+    if (!done_coders()) return FALSE;
     if (chunk_start_position)
     {
-      if (chunk_count) add_chunk_to_table();
+      if (chunk_count)
+      {
+        add_chunk_to_table(chunk_count);
+        if (summary_contents && !add_chunk_summary()) return FALSE;
+      }
       return write_chunk_table();
     }
   }
@@ -310,7 +576,136 @@ BOOL LASwritePoint::done()
   return TRUE;
 }
 
-BOOL LASwritePoint::add_chunk_to_table()
+void LASwritePoint::init_coders()
+{
+  U32 l;
+  if (layer_encs)
+  {
+    for (l = 0; l < num_layers; l++)
+    {
+      layer_streams[l]->reset();
+      layer_encs[l]->init(layer_streams[l]);
+    }
+  }
+  else
+  {
+    enc->init(chunk_stream ? chunk_stream : outstream);
+  }
+}
+
+BOOL LASwritePoint::done_coders()
+{
+  U32 l;
+  if (layer_encs == 0)
+  {
+    if (!enc->done()) return FALSE;
+    return flush_chunk();
+  }
+  // nothing was encoded since the chunk began
+  if (writers != writers_compressed) return TRUE;
+  // the sizes of all layers precede their bytes so readers can skip them
+  ByteStreamOut* stream = (chunk_stream ? chunk_stream : outstream);
+  for (l = 0; l < num_layers; l++)
+  {
+    if (!layer_encs[l]->done()) return FALSE;
+    U32 num_bytes = (U32)layer_streams[l]->getSize();
+    if (!stream->put32bitsLE((U8*)&num_bytes)) return FALSE;
+  }
+  for (l = 0; l < num_layers; l++)
+  {
+    if (!stream->putBytes(layer_streams[l]->getData(), (U32)layer_streams[l]->getSize())) return FALSE;
+  }
+  return flush_chunk();
+}
+
+BOOL LASwritePoint::flush_chunk()
+{
+  if (chunk_stream == 0) return TRUE;
+  // the memory is kept for the next chunk
+  BOOL put = outstream->putBytes(chunk_stream->getData(), (U32)chunk_stream->getSize());
+  chunk_stream->reset();
+  return put;
+}
+
+#ifdef LASZIP_INSTRUMENT
+BOOL LASwritePoint::get_item_counters(const U32 item, I64* cycles, I64* points, I64* bytes) const
+{
+  if (item >= num_writers || counters == 0) return FALSE;
+  // chunks that were compressed by the pool are counted by its workers
+  LASitemCounters sum = counters[item];
+  if (pool) pool->add_item_counters(item, &sum);
+  if (cycles) *cycles = sum.cycles;
+  if (points) *points = sum.points;
+  if (bytes) *bytes = sum.bytes;
+  return TRUE;
+}
+#else
+BOOL LASwritePoint::get_item_counters(const U32, I64*, I64*, I64*) const
+{
+  return FALSE;
+}
+#endif
+
+BOOL LASwritePoint::get_item_statistics(const U32 item, I64* points, F64* bits) const
+{
+  if (item >= num_writers || !statistics) return FALSE;
+  if (points) *points = item_points[item];
+  if (bits) *bits = item_bits[item];
+  return TRUE;
+}
+
+U32 LASwritePoint::get_integer_compressors(const U32 item, IntegerCompressor** ics, const char** fields) const
+{
+  if (item >= num_writers || writers_compressed == 0) return 0;
+  return ((LASwriteItemCompressed*)(writers_compressed[item]))->get_integer_compressors(ics, fields);
+}
+
+F64 LASwritePoint::item_tell_bits(const U32 i) const
+{
+  if (writers != writers_compressed) return 0.0;
+  if (layer_encs == 0) return enc->tellBits();
+  // the bits of an item are spread over its layers
+  F64 bits = 0.0;
+  for (U32 l = item_layers[i]; l < item_layers[i+1]; l++)
+  {
+    bits += layer_encs[l]->tellBits();
+  }
+  return bits;
+}
+
+#ifdef LASZIP_INSTRUMENT
+I64 LASwritePoint::item_position(const U32 i) const
+{
+  // raw points go straight to the stream
+  if (writers != writers_compressed) return (chunk_stream ? chunk_stream : outstream)->tell();
+  if (layer_encs == 0) return enc->tell();
+  // the bytes of an item are spread over its layers
+  I64 position = 0;
+  for (U32 l = item_layers[i]; l < item_layers[i+1]; l++)
+  {
+    position += layer_encs[l]->tell();
+  }
+  return position;
+}
+#endif
+
+BOOL LASwritePoint::write_chunks(const BOOL all)
+{
+  const U8* bytes;
+  U32 num_bytes;
+  U32 points;
+  // append compressed chunks in order (waiting for them if all are needed or no slot is free)
+  while (pool->retire(all || pool->full(), &bytes, &num_bytes, &points))
+  {
+    if (bytes == 0) return FALSE;
+    if (!outstream->putBytes(bytes, num_bytes)) return FALSE;
+    pool->release();
+    if (!add_chunk_to_table(points)) return FALSE;
+  }
+  return TRUE;
+}
+
+BOOL LASwritePoint::add_chunk_to_table(const U32 points)
 {
   if (number_chunks == alloced_chunks)
   {
@@ -330,16 +725,196 @@ BOOL LASwritePoint::add_chunk_to_table()
     if (chunk_bytes == 0) return FALSE;
   }
   I64 position = outstream->tell();
-  if (chunk_size == U32_MAX) chunk_sizes[number_chunks] = chunk_count;
+  if (chunk_size == U32_MAX) chunk_sizes[number_chunks] = points;
   chunk_bytes[number_chunks] = (U32)(position - chunk_start_position);
   chunk_start_position = position;
   number_chunks++;
   return TRUE;
 }
 
+inline void LASwritePoint::add_to_summary(const U8 * const * point)
+{
+  // the bounds of the chunk being written
+  I32* bounds = chunk_bounds + 6*summary_chunks;
+  const I32* xyz = (const I32*)point[0];
+  if (xyz[0] < bounds[0]) bounds[0] = xyz[0];
+  if (xyz[1] < bounds[1]) bounds[1] = xyz[1];
+  if (xyz[2] < bounds[2]) bounds[2] = xyz[2];
+  if (xyz[0] > bounds[3]) bounds[3] = xyz[0];
+  if (xyz[1] > bounds[4]) bounds[4] = xyz[1];
+  if (xyz[2] > bounds[5]) bounds[5] = xyz[2];
+  if (summary_contents == LASZIP_CHUNK_SUMMARY_XYZ_BOUNDS) return;
+  // the attributes of the chunk being written
+  const U8* item = point[0];
+  if (summary_contents & LASZIP_CHUNK_SUMMARY_CLASSIFICATIONS)
+  {
+    U32 classification = (summary_point14 ? item[16] : (item[15] & 0x1F));
+    chunk_classifications[LASZIP_CHUNK_SUMMARY_NUM_CLASSIFICATIONS*summary_chunks + classification]++;
+  }
+  if (summary_contents & LASZIP_CHUNK_SUMMARY_RETURN_NUMBERS)
+  {
+    U32 return_number = (summary_point14 ? (item[14] & 0x0F) : (item[14] & 0x07));
+    chunk_return_numbers[LASZIP_CHUNK_SUMMARY_NUM_RETURN_NUMBERS*summary_chunks + return_number]++;
+  }
+  if (summary_contents & LASZIP_CHUNK_SUMMARY_GPS_TIME)
+  {
+    F64 gps_time;
+    memcpy(&gps_time, point[summary_gps_time_item] + summary_gps_time_offset, sizeof(F64));
+    F64* gps_times = chunk_gps_times + 2*summary_chunks;
+    if (gps_time < gps_times[0]) gps_times[0] = gps_time;
+    if (gps_time > gps_times[1]) gps_times[1] = gps_time;
+  }
+  if (summary_contents & LASZIP_CHUNK_SUMMARY_INTENSITY)
+  {
+    U16 intensity = ((const U16*)item)[6];
+    U16* intensities = chunk_intensities + 2*summary_chunks;
+    if (intensity < intensities[0]) intensities[0] = intensity;
+    if (intensity > intensities[1]) intensities[1] = intensity;
+  }
+}
+
+BOOL LASwritePoint::add_chunk_summary()
+{
+  // the chunk that was just completed keeps its summary
+  summary_chunks++;
+  return init_chunk_summary();
+}
+
+BOOL LASwritePoint::init_chunk_summary()
+{
+  if (summary_chunks == alloced_summaries)
+  {
+    alloced_summaries = (alloced_summaries ? 2*alloced_summaries : 1024);
+    chunk_bounds = (I32*)realloc(chunk_bounds, sizeof(I32)*6*alloced_summaries);
+    if (chunk_bounds == 0) return FALSE;
+    if (summary_contents & LASZIP_CHUNK_SUMMARY_CLASSIFICATIONS)
+    {
+      chunk_classifications = (U32*)realloc(chunk_classifications, sizeof(U32)*LASZIP_CHUNK_SUMMARY_NUM_CLASSIFICATIONS*alloced_summaries);
+      if (chunk_classifications == 0) return FALSE;
+    }
+    if (summary_contents & LASZIP_CHUNK_SUMMARY_RETURN_NUMBERS)
+    {
+      chunk_return_numbers = (U32*)realloc(chunk_return_numbers, sizeof(U32)*LASZIP_CHUNK_SUMMARY_NUM_RETURN_NUMBERS*alloced_summaries);
+      if (chunk_return_numbers == 0) return FALSE;
+    }
+    if (summary_contents & LASZIP_CHUNK_SUMMARY_GPS_TIME)
+    {
+      chunk_gps_times = (F64*)realloc(chunk_gps_times, sizeof(F64)*2*alloced_summaries);
+      if (chunk_gps_times == 0) return FALSE;
+    }
+    if (summary_contents & LASZIP_CHUNK_SUMMARY_INTENSITY)
+    {
+      chunk_intensities = (U16*)realloc(chunk_intensities, sizeof(U16)*2*alloced_summaries);
+      if (chunk_intensities == 0) return FALSE;
+    }
+  }
+  I32* bounds = chunk_bounds + 6*summary_chunks;
+  bounds[0] = bounds[1] = bounds[2] = I32_MAX;
+  bounds[3] = bounds[4] = bounds[5] = I32_MIN;
+  if (summary_contents & LASZIP_CHUNK_SUMMARY_CLASSIFICATIONS)
+  {
+    memset(chunk_classifications + LASZIP_CHUNK_SUMMARY_NUM_CLASSIFICATIONS*summary_chunks, 0, sizeof(U32)*LASZIP_CHUNK_SUMMARY_NUM_CLASSIFICATIONS);
+  }
+  if (summary_contents & LASZIP_CHUNK_SUMMARY_RETURN_NUMBERS)
+  {
+    memset(chunk_return_numbers + LASZIP_CHUNK_SUMMARY_NUM_RETURN_NUMBERS*summary_chunks, 0, sizeof(U32)*LASZIP_CHUNK_SUMMARY_NUM_RETURN_NUMBERS);
+  }
+  if (summary_contents & LASZIP_CHUNK_SUMMARY_GPS_TIME)
+  {
+    chunk_gps_times[2*summary_chunks] = F64_MAX;
+    chunk_gps_times[2*summary_chunks+1] = F64_MIN;
+  }
+  if (summary_contents & LASZIP_CHUNK_SUMMARY_INTENSITY)
+  {
+    chunk_intensities[2*summary_chunks] = U16_MAX;
+    chunk_intensities[2*summary_chunks+1] = 0;
+  }
+  return TRUE;
+}
+
+// the chunk summaries are stored between the last chunk and the chunk table
+// where other readers never look: "LZCS", the version (0), the number of
+// chunks and of sections, and then every section as its LASZIP_CHUNK_SUMMARY_*
+// type, its size in bytes and the values for all chunks
+
+BOOL LASwritePoint::write_chunk_summaries()
+{
+  U32 i, type;
+  // the summaries must match the chunk table
+  if (summary_chunks != number_chunks) return TRUE;
+  U32 version = 0;
+  U32 number_sections = 0;
+  for (type = 1; type & LASZIP_CHUNK_SUMMARY_ALL; type <<= 1)
+  {
+    if (summary_contents & type) number_sections++;
+  }
+  if (!outstream->putBytes((const U8*)"LZCS", 4)) return FALSE;
+  if (!outstream->put32bitsLE((U8*)&version)) return FALSE;
+  if (!outstream->put32bitsLE((U8*)&number_chunks)) return FALSE;
+  if (!outstream->put32bitsLE((U8*)&number_sections)) return FALSE;
+  for (type = 1; type & LASZIP_CHUNK_SUMMARY_ALL; type <<= 1)
+  {
+    if (!(summary_contents & type)) continue;
+    U32 number, bytes;
+    switch (type)
+    {
+    case LASZIP_CHUNK_SUMMARY_XYZ_BOUNDS:
+      number = 6*number_chunks;
+      bytes = number*sizeof(I32);
+      break;
+    case LASZIP_CHUNK_SUMMARY_CLASSIFICATIONS:
+      number = LASZIP_CHUNK_SUMMARY_NUM_CLASSIFICATIONS*number_chunks;
+      bytes = number*sizeof(U32);
+      break;
+    case LASZIP_CHUNK_SUMMARY_RETURN_NUMBERS:
+      number = LASZIP_CHUNK_SUMMARY_NUM_RETURN_NUMBERS*number_chunks;
+      bytes = number*sizeof(U32);
+      break;
+    case LASZIP_CHUNK_SUMMARY_GPS_TIME:
+      number = 2*number_chunks;
+      bytes = number*sizeof(F64);
+      break;
+    default: // LASZIP_CHUNK_SUMMARY_INTENSITY
+      number = 2*number_chunks;
+      bytes = number*sizeof(U16);
+      break;
+    }
+    if (!outstream->put32bitsLE((U8*)&type)) return FALSE;
+    if (!outstream->put32bitsLE((U8*)&bytes)) return FALSE;
+    for (i = 0; i < number; i++)
+    {
+      BOOL put;
+      switch (type)
+      {
+      case LASZIP_CHUNK_SUMMARY_XYZ_BOUNDS:
+        put = outstream->put32bitsLE((U8*)&chunk_bounds[i]);
+        break;
+      case LASZIP_CHUNK_SUMMARY_CLASSIFICATIONS:
+        put = outstream->put32bitsLE((U8*)&chunk_classifications[i]);
+        break;
+      case LASZIP_CHUNK_SUMMARY_RETURN_NUMBERS:
+        put = outstream->put32bitsLE((U8*)&chunk_return_numbers[i]);
+        break;
+      case LASZIP_CHUNK_SUMMARY_GPS_TIME:
+        put = outstream->put64bitsLE((U8*)&chunk_gps_times[i]);
+        break;
+      default:
+        put = outstream->put16bitsLE((U8*)&chunk_intensities[i]);
+        break;
+      }
+      if (!put) return FALSE;
+    }
+  }
+  return TRUE;
+}
+
 BOOL LASwritePoint::write_chunk_table()
 {
   U32 i;
+  if (summary_contents && number_chunks)
+  {
+    if (!write_chunk_summaries()) return FALSE;
+  }
   I64 position = outstream->tell();
   if (chunk_table_start_position != -1) // stream is seekable
   {
@@ -375,7 +950,7 @@ BOOL LASwritePoint::write_chunk_table()
       if (chunk_size == U32_MAX) ic.compress((i ? chunk_sizes[i-1] : 0), chunk_sizes[i], 0);
       ic.compress((i ? chunk_bytes[i-1] : 0), chunk_bytes[i], 1);
     }
-    enc->done();
+    if (!enc->done()) return FALSE;
   }
   if (chunk_table_start_position == -1) // stream is not-seekable
   {
@@ -391,6 +966,8 @@ LASwritePoint::~LASwritePoint()
 {
   U32 i;
 
+  if (pool) delete pool;
+
   if (writers_raw)
   {
     for (i = 0; i < num_writers; i++)
@@ -407,10 +984,37 @@ LASwritePoint::~LASwritePoint()
     }
     delete [] writers_compressed;
   }
+
+  if (fused) delete fused;
   if (enc)
   {
     delete enc;
   }
 
+  if (layer_encs)
+  {
+    for (i = 0; i < num_layers; i++)
+    {
+      delete layer_encs[i];
+      delete layer_streams[i];
+    }
+    delete [] layer_encs;
+    delete [] layer_streams;
+  }
+  if (item_layers) delete [] item_layers;
+
+  if (item_points) delete [] item_points;
+  if (item_bits) delete [] item_bits;
+
   if (chunk_bytes) free(chunk_bytes);
+  if (chunk_stream) delete chunk_stream;
+  if (chunk_bounds) free(chunk_bounds);
+  if (chunk_classifications) free(chunk_classifications);
+  if (chunk_return_numbers) free(chunk_return_numbers);
+  if (chunk_gps_times) free(chunk_gps_times);
+  if (chunk_intensities) free(chunk_intensities);
+
+#ifdef LASZIP_INSTRUMENT
+  if (counters) delete [] counters;
+#endif
 }
@@ -24,6 +24,18 @@
   
   CHANGE HISTORY:
   
+    17 October 2026 -- setup() can write the points as one chunk without a chunk table
+    17 October 2026 -- the fused writer is counted item by item as well (LASZIP_INSTRUMENT)
+    17 October 2026 -- encoders for the rANS coder as well as the arithmetic one
+    17 October 2026 -- chunks are compressed into memory and written at once
+    17 October 2026 -- optional statistics of the bits of every item and integer compressor context
+    17 October 2026 -- counts the cycles, points and bytes of every item (LASZIP_INSTRUMENT)
+    17 October 2026 -- chunk summaries can also hold attribute statistics
+    17 October 2026 -- optional chunk summaries with the bounds of each chunk
+    17 October 2026 -- layered compression with one encoder per layer
+    17 October 2026 -- compresses POINT14 and RGBNIR14 items
+    17 October 2026 -- fused writer for the common point types
+    17 October 2026 -- optionally compress whole chunks on worker threads
     6 October 2011 -- large file support & reading with missing chunk table
     9 May 2011 -- the chunked compressor now allows variable chunk sizes
     25 April 2011 -- added chunked laszip for random access decompression
@@ -41,31 +53,66 @@
 #include "mydefs.hpp"
 #include "laszip.hpp"
 #include "bytestreamout.hpp"
+#include "lasinstrument.hpp"
+
+// the memory that each chunk is compressed into (grows when a chunk needs more)
+#define LASZIP_CHUNK_STREAM_SIZE 1048576
 
 class LASwriteItem;
+class LASwriteFusedCompressed_v2;
 class EntropyEncoder;
+class LASwriteChunkPool;
+class ByteStreamOutArray;
+class IntegerCompressor;
 
 class LASwritePoint
+#ifdef LASZIP_INSTRUMENT
+  : public LASitemPositions
+#endif
 {
 public:
   LASwritePoint();
   ~LASwritePoint();
 
-  // should only be called *once*
-  BOOL setup(const U32 num_items, const LASitem* items, const LASzip* laszip=0);
+  // should only be called *once* (a single chunk compresses all points as one
+  // chunk without a chunk table the way the workers of the pool do)
+  BOOL setup(const U32 num_items, const LASitem* items, const LASzip* laszip=0, const BOOL single_chunk=FALSE);
+  // compress chunks on this many threads (call after setup, chunked only)
+  BOOL set_threads(const U32 num_threads);
+  // summarize every chunk with LASZIP_CHUNK_SUMMARY_* (call after setup, chunked only)
+  BOOL set_chunk_summary(const U32 contents);
+  // keep statistics of the bits that each item and each context of the integer
+  // compressors of its fields cost (call after setup, not with threads)
+  BOOL set_statistics(const BOOL statistics);
 
   BOOL init(ByteStreamOut* outstream);
   BOOL write(const U8 * const * point);
   BOOL chunk();
   BOOL done();
 
+  // the processor cycles, points and compressed bytes that an item has cost
+  // since setup (fails unless the build defines LASZIP_INSTRUMENT)
+  BOOL get_item_counters(const U32 item, I64* cycles, I64* points, I64* bytes) const;
+
+  // the points of an item written so far and the bits spent on them (without
+  // what finishing the chunks costs) if statistics are kept
+  BOOL get_item_statistics(const U32 item, I64* points, F64* bits) const;
+  // stores the integer compressors of an item (at most LASZIP_ITEM_COMPRESSORS_MAX)
+  // and the names of their fields and returns how many there are (their contexts
+  // have statistics while they are kept)
+  U32 get_integer_compressors(const U32 item, IntegerCompressor** ics, const char** fields) const;
+
 private:
   ByteStreamOut* outstream;
   U32 num_writers;
   LASwriteItem** writers;
   LASwriteItem** writers_raw;
   LASwriteItem** writers_compressed;
+  LASwriteFusedCompressed_v2* fused;
   EntropyEncoder* enc;
+  EntropyEncoder* create_encoder() const;
+  const LASzip* laszip;
+  LASwriteChunkPool* pool;
   // used for chunking
   U32 chunk_size;
   U32 chunk_count;
@@ -75,8 +122,47 @@ private:
   U32* chunk_bytes;
   I64 chunk_start_position;
   I64 chunk_table_start_position;
-  BOOL add_chunk_to_table();
+  ByteStreamOutArray* chunk_stream;
+  BOOL flush_chunk();
+  BOOL add_chunk_to_table(const U32 points);
+  BOOL write_chunks(const BOOL all);
   BOOL write_chunk_table();
+  // used for chunk summaries (of all chunks up to the one being written)
+  U32 summary_contents;
+  U32 summary_chunks;
+  U32 alloced_summaries;
+  I32* chunk_bounds;
+  U32* chunk_classifications;
+  U32* chunk_return_numbers;
+  F64* chunk_gps_times;
+  U16* chunk_intensities;
+  BOOL summary_point14;
+  I32 summary_gps_time_item;
+  U32 summary_gps_time_offset;
+  void add_to_summary(const U8 * const * point);
+  BOOL init_chunk_summary();
+  BOOL add_chunk_summary();
+  BOOL write_chunk_summaries();
+  // used for layered compression
+  U32 num_layers;
+  EntropyEncoder** layer_encs;
+  ByteStreamOutArray** layer_streams;
+  U32* item_layers; // the first layer of each item (and one past the last)
+  void init_coders();
+  BOOL done_coders();
+  // used for statistics (the fused writer is not used because it encodes all
+  // items at once)
+  BOOL statistics;
+  I64* item_points;
+  F64* item_bits;
+  F64 item_tell_bits(const U32 i) const;
+#ifdef LASZIP_INSTRUMENT
+  // used for counting what each item costs (also inside the fused writer)
+  LASitemCounters* counters;
+  I64 item_position(const U32 i) const;
+  // the pool sums up what the writers of its workers counted
+  friend class LASwriteChunkPool;
+#endif
 };
 
 #endif
@@ -196,6 +196,7 @@ bool LASzip::return_error(const char* error)
 bool LASzip::check_compressor(const U16 compressor)
 {
   if (compressor < LASZIP_COMPRESSOR_TOTAL_NUMBER_OF) return true;
+  if (compressor == LASZIP_COMPRESSOR_LAYERED_CHUNKED) return true;
   char error[64];
   sprintf(error, "compressor %d not supported", compressor);
   return return_error(error);
@@ -209,6 +210,18 @@ bool LASzip::check_coder(const U16 coder)
   return return_error(error);
 }
 
+bool LASzip::check_coder(const U16 coder, const U16 compressor)
+{
+  if (!check_coder(coder)) return false;
+  // the rANS encoder keeps every symbol until its chunk ends (which without
+  // chunks is at the end of the file)
+  if ((coder == LASZIP_CODER_RANS) && (compressor != LASZIP_COMPRESSOR_POINTWISE_CHUNKED) && (compressor != LASZIP_COMPRESSOR_LAYERED_CHUNKED))
+  {
+    return return_error("rANS coder needs a chunked or layered compressor");
+  }
+  return true;
+}
+
 bool LASzip::check_item(const LASitem* item)
 {
   switch (item->type)
@@ -235,11 +248,11 @@ bool LASzip::check_item(const LASitem* item)
     break;
   case LASitem::POINT14:
     if (item->size != 30) return return_error("POINT14 has size != 30");
-    if (item->version > 0) return return_error("POINT14 has version > 0");
+    if ((item->version != 0) && (item->version != LASZIP_ITEM14_VERSION)) return return_error("POINT14 has version != 0 and is not our own");
     break;
   case LASitem::RGBNIR14:
     if (item->size != 8) return return_error("RGBNIR14 has size != 8");
-    if (item->version > 0) return return_error("RGBNIR14 has version > 0");
+    if ((item->version != 0) && (item->version != LASZIP_ITEM14_VERSION)) return return_error("RGBNIR14 has version != 0 and is not our own");
     break;
   default:
     if (1)
@@ -267,35 +280,39 @@ bool LASzip::check_items(const U16 num_items, const LASitem* items)
 bool LASzip::check()
 {
   if (!check_compressor(compressor)) return false;
-  if (!check_coder(coder)) return false;
+  if (!check_coder(coder, compressor)) return false;
   if (!check_items(num_items, items)) return false;
   return true;
 }
 
-bool LASzip::setup(const U8 point_type, const U16 point_size, const U16 compressor)
+bool LASzip::setup(const U8 point_type, const U16 point_size, const U16 compressor, const U16 coder)
 {
   if (!check_compressor(compressor)) return false;
+  if (!check_coder(coder, compressor)) return false;
   this->num_items = 0;
   if (this->items) delete [] this->items;
   this->items = 0;
   if (!setup(&num_items, &items, point_type, point_size, compressor)) return false;
   this->compressor = compressor;
-  if (this->compressor == LASZIP_COMPRESSOR_POINTWISE_CHUNKED)
+  this->coder = coder;
+  if ((this->compressor == LASZIP_COMPRESSOR_POINTWISE_CHUNKED) || (this->compressor == LASZIP_COMPRESSOR_LAYERED_CHUNKED))
   {
     if (chunk_size == 0) chunk_size = LASZIP_CHUNK_SIZE_DEFAULT;
   }
   return true;
 }
 
-bool LASzip::setup(const U16 num_items, const LASitem* items, const U16 compressor)
+bool LASzip::setup(const U16 num_items, const LASitem* items, const U16 compressor, const U16 coder)
 {
   // check input
   if (!check_compressor(compressor)) return false;
+  if (!check_coder(coder, compressor)) return false;
   if (!check_items(num_items, items)) return false;
 
-  // setup compressor
+  // setup compressor and coder
   this->compressor = compressor;
-  if (this->compressor == LASZIP_COMPRESSOR_POINTWISE_CHUNKED)
+  this->coder = coder;
+  if ((this->compressor == LASZIP_COMPRESSOR_POINTWISE_CHUNKED) || (this->compressor == LASZIP_COMPRESSOR_LAYERED_CHUNKED))
   {
     if (chunk_size == 0) chunk_size = LASZIP_CHUNK_SIZE_DEFAULT;
   }
@@ -462,7 +479,7 @@ bool LASzip::setup(U16* num_items, LASitem** items, const U8 point_type, const U
 bool LASzip::set_chunk_size(const U32 chunk_size)
 {
   if (num_items == 0) return return_error("call setup() before setting chunk size");
-  if (this->compressor == LASZIP_COMPRESSOR_POINTWISE_CHUNKED)
+  if ((this->compressor == LASZIP_COMPRESSOR_POINTWISE_CHUNKED) || (this->compressor == LASZIP_COMPRESSOR_LAYERED_CHUNKED))
   {
     this->chunk_size = chunk_size;
     return true;
@@ -481,6 +498,7 @@ bool LASzip::request_version(const U16 requested_version)
   {
     if (requested_version < 1) return return_error("with compression version is at least 1");
     if (requested_version > 2) return return_error("version larger than 2 not supported");
+    if ((compressor == LASZIP_COMPRESSOR_LAYERED_CHUNKED) && (requested_version < 2)) return return_error("layered compression needs version 2");
   }
   U16 i;
   for (i = 0; i < num_items; i++)
@@ -496,6 +514,10 @@ bool LASzip::request_version(const U16 requested_version)
     case LASitem::WAVEPACKET13:
         items[i].version = 1; // no version 2
         break;
+    case LASitem::POINT14:
+    case LASitem::RGBNIR14:
+        items[i].version = (requested_version ? LASZIP_ITEM14_VERSION : 0); // only our own codec
+        break;
     default:
         return return_error("itrm type not supported");
     }
@@ -814,6 +836,12 @@ const char* LASitem::get_name() const
   case BYTE:
       return "BYTE";
       break;
+  case POINT14:
+      return "POINT14";
+      break;
+  case RGBNIR14:
+      return "RGBNIR14";
+      break;
   default:
       break;
   }
@@ -25,6 +25,7 @@
   
   CHANGE HISTORY:
   
+    17 October 2026 -- which layers the layered compressor splits an item into
     16 March 2011 -- created after designing the "streaming median" algorithm
 
 ===============================================================================
@@ -32,6 +33,8 @@
 #ifndef LASZIP_COMMON_V2_HPP
 #define LASZIP_COMMON_V2_HPP
 
+#include "laszip.hpp"
+
 class StreamingMedian5
 {
 public:
@@ -183,4 +186,42 @@ const U8 number_return_level[8][8] =
   {  7,  6,  5,  4,  3,  2,  1,  0 }
 };
 
+// the layered compressor splits an item into at most this many layers
+#define LASZIP_LAYERS_PER_ITEM_MAX 3
+
+// returns how many layers the layered compressor splits an item into and
+// for each layer the LASZIP_DECOMPRESS_SELECTIVE_* flag that selects it
+inline U32 get_layers_v2(const LASitem* item, U32* selective)
+{
+  switch (item->type)
+  {
+  case LASitem::POINT10:
+    // x, y, z with the return counts, then all other fields
+    selective[0] = LASZIP_DECOMPRESS_SELECTIVE_XYZ;
+    selective[1] = LASZIP_DECOMPRESS_SELECTIVE_ATTRIBUTES;
+    return 2;
+  case LASitem::POINT14:
+    // as above but with the gps time as a third layer
+    selective[0] = LASZIP_DECOMPRESS_SELECTIVE_XYZ;
+    selective[1] = LASZIP_DECOMPRESS_SELECTIVE_ATTRIBUTES;
+    selective[2] = LASZIP_DECOMPRESS_SELECTIVE_GPS_TIME;
+    return 3;
+  case LASitem::GPSTIME11:
+    selective[0] = LASZIP_DECOMPRESS_SELECTIVE_GPS_TIME;
+    return 1;
+  case LASitem::RGB12:
+  case LASitem::RGBNIR14:
+    selective[0] = LASZIP_DECOMPRESS_SELECTIVE_RGB;
+    return 1;
+  case LASitem::WAVEPACKET13:
+    selective[0] = LASZIP_DECOMPRESS_SELECTIVE_WAVEPACKET;
+    return 1;
+  case LASitem::BYTE:
+    selective[0] = LASZIP_DECOMPRESS_SELECTIVE_EXTRA_BYTES;
+    return 1;
+  default:
+    return 0;
+  }
+}
+
 #endif
@@ -35,7 +35,10 @@
 
 #include "bytestreamout_file.hpp"
 #include "bytestreamout_ostream.hpp"
+#include "bytestreamout_array.hpp"
 #include "laswritepoint.hpp"
+#include "laswriteitem.hpp"
+#include "integercompressor.hpp"
 
 bool LASzipper::open(FILE* outfile, const LASzip* laszip)
 {
@@ -46,6 +49,16 @@ bool LASzipper::open(FILE* outfile, const LASzip* laszip)
   writer = new LASwritePoint();
   if (!writer) return return_error("alloc of LASwritePoint failed");
   if (!writer->setup(laszip->num_items, laszip->items, laszip)) return return_error("setup() of LASwritePoint failed");
+  if (num_threads > 1 && !writer->set_threads(num_threads)) return return_error("set_threads() of LASwritePoint failed");
+  if (!writer->set_chunk_summary(chunk_summary)) return return_error("set_chunk_summary() of LASwritePoint failed");
+  if (statistics && !writer->set_statistics(TRUE)) return return_error("set_statistics() of LASwritePoint failed");
+  if (memory)
+  {
+    // the bytes of an earlier open() into memory are gone
+    if (stream == memory) stream = 0;
+    delete memory;
+    memory = 0;
+  }
   if (stream) delete stream;
   if (IS_LITTLE_ENDIAN())
     stream = new ByteStreamOutFileLE(outfile);
@@ -64,6 +77,16 @@ bool LASzipper::open(ostream& outstream, const LASzip* laszip)
   writer = new LASwritePoint();
   if (!writer) return return_error("alloc of LASwritePoint failed");
   if (!writer->setup(laszip->num_items, laszip->items, laszip)) return return_error("setup() of LASwritePoint failed");
+  if (num_threads > 1 && !writer->set_threads(num_threads)) return return_error("set_threads() of LASwritePoint failed");
+  if (!writer->set_chunk_summary(chunk_summary)) return return_error("set_chunk_summary() of LASwritePoint failed");
+  if (statistics && !writer->set_statistics(TRUE)) return return_error("set_statistics() of LASwritePoint failed");
+  if (memory)
+  {
+    // the bytes of an earlier open() into memory are gone
+    if (stream == memory) stream = 0;
+    delete memory;
+    memory = 0;
+  }
   if (stream) delete stream;
   if (IS_LITTLE_ENDIAN())
     stream = new ByteStreamOutOstreamLE(outstream);
@@ -74,6 +97,72 @@ bool LASzipper::open(ostream& outstream, const LASzip* laszip)
   return true;
 }
 
+bool LASzipper::open(const LASzip* laszip, const unsigned int offset)
+{
+  if (!laszip) return return_error("const LASzip* laszip pointer is NULL");
+  count = 0;
+  if (writer) delete writer;
+  writer = new LASwritePoint();
+  if (!writer) return return_error("alloc of LASwritePoint failed");
+  if (!writer->setup(laszip->num_items, laszip->items, laszip)) return return_error("setup() of LASwritePoint failed");
+  if (num_threads > 1 && !writer->set_threads(num_threads)) return return_error("set_threads() of LASwritePoint failed");
+  if (!writer->set_chunk_summary(chunk_summary)) return return_error("set_chunk_summary() of LASwritePoint failed");
+  if (statistics && !writer->set_statistics(TRUE)) return return_error("set_statistics() of LASwritePoint failed");
+  if (stream && stream != memory) delete stream;
+  // the memory of an earlier open() into memory is reused
+  if (memory)
+  {
+    memory->reset();
+  }
+  else
+  {
+    if (IS_LITTLE_ENDIAN())
+      memory = new ByteStreamOutArrayLE(LASZIP_CHUNK_STREAM_SIZE);
+    else
+      memory = new ByteStreamOutArrayBE(LASZIP_CHUNK_STREAM_SIZE);
+    if (!memory) return return_error("alloc of ByteStreamOutArray failed");
+  }
+  stream = memory;
+  // the chunk table points to where the chunks are in the whole file
+  for (unsigned int i = 0; i < offset; i++)
+  {
+    if (!stream->putByte(0)) return return_error("alloc of ByteStreamOutArray failed");
+  }
+  if (!writer->init(stream)) return return_error("init() of LASwritePoint failed");
+  return true;
+}
+
+bool LASzipper::get_data(unsigned char** data, SIGNED_INT64* size)
+{
+  if (!memory) return return_error("get_data() needs an open() into memory");
+  if (data) *data = (unsigned char*)memory->getData();
+  if (size) *size = memory->getSize();
+  return true;
+}
+
+bool LASzipper::set_threads(const unsigned int num_threads)
+{
+  if (writer) return return_error("set_threads() must be called before open()");
+  if (statistics && num_threads > 1) return return_error("set_threads() does not work with set_statistics()");
+  this->num_threads = num_threads;
+  return true;
+}
+
+bool LASzipper::set_chunk_summary(const unsigned int contents)
+{
+  if (writer) return return_error("set_chunk_summary() must be called before open()");
+  this->chunk_summary = contents;
+  return true;
+}
+
+bool LASzipper::set_statistics(const bool statistics)
+{
+  if (writer) return return_error("set_statistics() must be called before open()");
+  if (statistics && num_threads > 1) return return_error("set_statistics() does not work with set_threads()");
+  this->statistics = statistics;
+  return true;
+}
+
 bool LASzipper::write(const unsigned char * const * point)
 {
   count++;
@@ -97,13 +186,54 @@ bool LASzipper::close()
   }
   if (stream)
   {
-    delete stream;
+    // the bytes written into memory stay for get_data()
+    if (stream != memory) delete stream;
     stream = 0;
   }
   if (!done) return return_error("done() of LASwritePoint failed");
   return true;
 }
 
+bool LASzipper::get_item_statistics(const unsigned int item, SIGNED_INT64* points, double* bits)
+{
+  if (writer == 0) return return_error("get_item_statistics() must be called before close()");
+  I64 number;
+  F64 sum;
+  if (!writer->get_item_statistics(item, &number, &sum)) return return_error("no statistics for this item");
+  if (points) *points = number;
+  if (bits) *bits = sum;
+  return true;
+}
+
+bool LASzipper::get_field_statistics(const unsigned int item, const unsigned int field, const char** name, unsigned int* contexts)
+{
+  if (writer == 0) return return_error("get_field_statistics() must be called before close()");
+  IntegerCompressor* ics[LASZIP_ITEM_COMPRESSORS_MAX];
+  const char* fields[LASZIP_ITEM_COMPRESSORS_MAX];
+  if (field >= writer->get_integer_compressors(item, ics, fields)) return return_error("no such compressed field");
+  if (name) *name = fields[field];
+  if (contexts) *contexts = ics[field]->getContexts();
+  return true;
+}
+
+bool LASzipper::get_context_statistics(const unsigned int item, const unsigned int field, const unsigned int context, SIGNED_INT64* number, double* bits, double* entropy, SIGNED_INT64* k_counts)
+{
+  if (writer == 0) return return_error("get_context_statistics() must be called before close()");
+  IntegerCompressor* ics[LASZIP_ITEM_COMPRESSORS_MAX];
+  const char* fields[LASZIP_ITEM_COMPRESSORS_MAX];
+  if (field >= writer->get_integer_compressors(item, ics, fields)) return return_error("no such compressed field");
+  U64 values;
+  U64 counts[33];
+  if (!ics[field]->getStatistics(context, &values, bits, counts, entropy)) return return_error("no statistics for this context");
+  if (number) *number = (SIGNED_INT64)values;
+  if (k_counts)
+  {
+    U32 k;
+    for (k = 0; k < 33; k++) k_counts[k] = (k <= ics[field]->getCorrBits() ? (SIGNED_INT64)counts[k] : 0);
+  }
+  return true;
+}
+
 const char* LASzipper::get_error() const
 {
   return error_string;
@@ -122,7 +252,11 @@ LASzipper::LASzipper()
 {
   error_string = 0;
   count = 0;
+  num_threads = 1;
+  chunk_summary = LASZIP_CHUNK_SUMMARY_NONE;
+  statistics = false;
   stream = 0;
+  memory = 0;
   writer = 0;
 }
 
@@ -130,4 +264,5 @@ LASzipper::~LASzipper()
 {
   if (error_string) free(error_string);
   if (writer || stream) close();
+  if (memory) delete memory;
 }
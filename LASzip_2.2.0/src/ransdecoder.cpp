@@ -0,0 +1,344 @@
+/*
+===============================================================================
+
+  FILE:  ransdecoder.cpp
+
+  CONTENTS:
+
+    see corresponding header file
+
+  PROGRAMMERS:
+
+    agent@local
+
+  COPYRIGHT:
+
+    (c) 2026, agent@local
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the COPYING file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    see header file
+
+===============================================================================
+*/
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+//                                                                           -
+// The byte-wise rANS of Fabian Giesen's "ryg_rans" with the probabilities   -
+// of the adaptive arithmetic coding models. Every symbol has a start and a  -
+// frequency out of 1 << DM__LengthShift. Decoding takes a slot of the       -
+// state, finds the symbol whose interval holds it and sets                  -
+//                                                                           -
+//   state = freq * (state >> DM__LengthShift) + slot - start                -
+//                                                                           -
+// before reading bytes until the state is back above RANS__MinState.        -
+//                                                                           -
+// J. Duda, Asymmetric numeral systems: entropy coding combining speed of    -
+// Huffman coding with compression rate of arithmetic coding, arXiv 2013     -
+//                                                                           -
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+#include "ransdecoder.hpp"
+
+#include <string.h>
+#include <assert.h>
+
+#include "arithmeticmodel.hpp"
+
+RANSDecoder::RANSDecoder()
+{
+  instream = 0;
+  arena = new ArithmeticModelArena();
+  window_start = 0;
+  window_curr = 0;
+  window_end = 0;
+  state[0] = state[1] = RANS__MinState;
+  turn = 0;
+}
+
+inline U32 RANSDecoder::getByte()
+{
+  // buffered streams are read without a virtual call or an exception check
+  if (window_curr < window_end) return *window_curr++;
+  return getByteRefill();
+}
+
+U32 RANSDecoder::getByteRefill()
+{
+  if (window_start)
+  {
+    syncWindow();
+    U32 num_bytes = instream->getWindow(&window_start);
+    if (num_bytes)
+    {
+      window_curr = window_start;
+      window_end = window_start + num_bytes;
+      return *window_curr++;
+    }
+    window_start = 0;
+  }
+  // the stream throws at its end
+  return instream->getByte();
+}
+
+void RANSDecoder::syncWindow()
+{
+  // tell the stream how far we have read so it can be used again
+  instream->skipWindow((U32)(window_curr - window_start));
+  window_start = 0;
+  window_curr = 0;
+  window_end = 0;
+}
+
+BOOL RANSDecoder::init(ByteStreamIn* instream)
+{
+  if (instream == 0) return FALSE;
+  if (window_start) syncWindow();
+  this->instream = instream;
+  U32 num_bytes = instream->getWindow(&window_start);
+  window_curr = window_start;
+  window_end = window_start + num_bytes;
+  if (num_bytes == 0) window_start = 0;
+  // the encoder flushed both states in little endian
+  for (U32 s = 0; s < 2; s++)
+  {
+    state[s] = getByte();
+    state[s] |= (getByte() << 8);
+    state[s] |= (getByte() << 16);
+    state[s] |= (getByte() << 24);
+  }
+  turn = 0;
+  return TRUE;
+}
+
+void RANSDecoder::done()
+{
+  if (window_start) syncWindow();
+  instream = 0;
+}
+
+I64 RANSDecoder::tell() const
+{
+  // the stream only moves past its window once the window is skipped
+  if (window_start) return instream->tell() + (window_curr - window_start);
+  return instream->tell();
+}
+
+U32 RANSDecoder::getStateSize() const
+{
+  return 3*sizeof(U32) + sizeof(I64) + arena->getStateSize();
+}
+
+U8* RANSDecoder::saveState(U8* state) const
+{
+  // the position in the stream of the next byte to be read
+  I64 position = instream->tell();
+  if (window_start) position += (window_curr - window_start);
+  memcpy(state, this->state, 2*sizeof(U32)); state += 2*sizeof(U32);
+  memcpy(state, &turn, sizeof(U32)); state += sizeof(U32);
+  memcpy(state, &position, sizeof(I64)); state += sizeof(I64);
+  return arena->saveState(state);
+}
+
+const U8* RANSDecoder::restoreState(const U8* state)
+{
+  I64 position;
+  memcpy(this->state, state, 2*sizeof(U32)); state += 2*sizeof(U32);
+  memcpy(&turn, state, sizeof(U32)); state += sizeof(U32);
+  memcpy(&position, state, sizeof(I64)); state += sizeof(I64);
+  // the window is dropped without syncing as the stream is repositioned
+  window_start = 0;
+  window_curr = 0;
+  window_end = 0;
+  if (!instream->seek(position)) return 0;
+  U32 num_bytes = instream->getWindow(&window_start);
+  window_curr = window_start;
+  window_end = window_start + num_bytes;
+  if (num_bytes == 0) window_start = 0;
+  return arena->restoreState(state);
+}
+
+EntropyModel* RANSDecoder::createBitModel()
+{
+  ArithmeticBitModel* m = arena->createBitModel();
+  return (EntropyModel*)m;
+}
+
+void RANSDecoder::initBitModel(EntropyModel* model)
+{
+  ArithmeticBitModel* m = (ArithmeticBitModel*)model;
+  m->init();
+}
+
+void RANSDecoder::destroyBitModel(EntropyModel* model)
+{
+  ArithmeticBitModel* m = (ArithmeticBitModel*)model;
+  arena->destroyBitModel(m);
+}
+
+EntropyModel* RANSDecoder::createSymbolModel(U32 n)
+{
+  ArithmeticModel* m = arena->createSymbolModel(n, false);
+  return (EntropyModel*)m;
+}
+
+void RANSDecoder::initSymbolModel(EntropyModel* model, U32 *table)
+{
+  ArithmeticModel* m = (ArithmeticModel*)model;
+  m->init(table);
+}
+
+void RANSDecoder::destroySymbolModel(EntropyModel* model)
+{
+  ArithmeticModel* m = (ArithmeticModel*)model;
+  arena->destroySymbolModel(m);
+}
+
+U32 RANSDecoder::renormalize(U32 x)
+{
+  do {                                                  // read another byte
+    x = (x << 8) | getByte();
+  } while (x < RANS__MinState);
+  return x;
+}
+
+inline void RANSDecoder::advance(const U32 slot, const U32 start, const U32 freq)
+{
+  U32 x = freq * (state[turn] >> DM__LengthShift) + slot - start;
+  if (x < RANS__MinState) x = renormalize(x);  // kept out of the common path
+  state[turn] = x;
+  turn ^= 1;                                     // the other state is next
+}
+
+U32 RANSDecoder::decodeBit(EntropyModel* model)
+{
+  ArithmeticBitModel* m = (ArithmeticBitModel*)model;
+  U32 slot = state[turn] & (DM__MaxCount - 1);
+  U32 x = m->bit_0_prob << (DM__LengthShift - BM__LengthShift);  // scaled p0
+  U32 sym = (slot >= x);                                           // decision
+                                                  // interval without branches
+  advance(slot, (sym ? x : 0), (sym ? DM__MaxCount - x : x));
+  m->bit_0_count += (sym ^ 1);
+
+  if (--m->bits_until_update == 0) m->update();       // periodic model update
+
+  return sym;                                         // return data bit value
+}
+
+U32 RANSDecoder::decodeSymbol(EntropyModel* model)
+{
+  ArithmeticModel* m = (ArithmeticModel*)model;
+  U32 slot = state[turn] & (DM__MaxCount - 1);
+  U32 n, sym;
+
+  if (m->decoder_table) {             // use table look-up for faster decoding
+
+    U32 t = slot >> m->table_shift;
+
+    sym = m->decoder_table[t];      // initial decision based on table look-up
+    n = m->decoder_table[t+1] + 1;
+  }
+  else {
+    sym = 0;
+    n = m->symbols;
+  }
+
+  while (n > sym + 8) {                  // narrow wide ranges by bisection
+    U32 k = (sym + n) >> 1;
+    if (m->entries[k].distribution > slot) n = k; else sym = k;
+  }
+
+  U32 first = sym;                   // and count the rest without branching
+  for (U32 k = first + 1; k < n; k++) sym += (m->entries[k].distribution <= slot);
+
+  U32 start = m->entries[sym].distribution;
+  U32 end = (sym != m->last_symbol ? m->entries[sym+1].distribution : DM__MaxCount);
+  advance(slot, start, end - start);
+
+  ++m->entries[sym].symbol_count;
+  if (--m->symbols_until_update == 0) m->update();    // periodic model update
+
+  return sym;
+}
+
+U32 RANSDecoder::readBit()
+{
+  return readBits(1);
+}
+
+U32 RANSDecoder::readBits(U32 bits)
+{
+  assert(bits && (bits <= 32));
+
+  if (bits > 16)
+  {
+    U32 tmp = readShort();
+    bits = bits - 16;
+    U32 tmp1 = readBits(bits) << 16;
+    return (tmp1|tmp);
+  }
+  else if (bits == 16)
+  {
+    return readShort();
+  }
+
+  // equiprobable symbols of 1 << (DM__LengthShift - bits) slots each
+  U32 shift = DM__LengthShift - bits;
+  U32 slot = state[turn] & (DM__MaxCount - 1);
+  U32 sym = slot >> shift;
+  advance(slot, sym << shift, 1 << shift);
+
+  return sym;
+}
+
+U8 RANSDecoder::readByte()
+{
+  return (U8)readBits(8);
+}
+
+U16 RANSDecoder::readShort()
+{
+  U32 lowerByte = readByte();
+  U32 upperByte = readByte();
+  return (U16)((upperByte<<8)|lowerByte);
+}
+
+U32 RANSDecoder::readInt()
+{
+  U32 lowerInt = readShort();
+  U32 upperInt = readShort();
+  return (upperInt<<16)|lowerInt;
+}
+
+F32 RANSDecoder::readFloat() /* danger in float reinterpretation */
+{
+  U32I32F32 u32i32f32;
+  u32i32f32.u32 = readInt();
+  return u32i32f32.f32;
+}
+
+U64 RANSDecoder::readInt64()
+{
+  U64 lowerInt = readInt();
+  U64 upperInt = readInt();
+  return (upperInt<<32)|lowerInt;
+}
+
+F64 RANSDecoder::readDouble() /* danger in float reinterpretation */
+{
+  U64I64F64 u64i64f64;
+  u64i64f64.u64 = readInt64();
+  return u64i64f64.f64;
+}
+
+RANSDecoder::~RANSDecoder()
+{
+  delete arena;
+}
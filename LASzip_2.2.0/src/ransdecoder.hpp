@@ -0,0 +1,123 @@
+/*
+===============================================================================
+
+  FILE:  ransdecoder.hpp
+
+  CONTENTS:
+
+    A range asymmetric numeral system (rANS) decoder with two interleaved
+    states that decodes with the same adaptive models as the arithmetic
+    decoder. It is a drop-in replacement that trades a little compression
+    for decoding with a multiply, a mask and a shift per symbol instead of
+    a division. Two states that take turns halve the chain of dependencies
+    from one symbol to the next.
+
+  PROGRAMMERS:
+
+    agent@local
+
+  COPYRIGHT:
+
+    (c) 2026, agent@local
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the COPYING file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    17 October 2026 -- created as the second entropy coder of LASzip
+
+===============================================================================
+*/
+#ifndef RANS_DECODER_H
+#define RANS_DECODER_H
+
+#include "entropydecoder.hpp"
+
+class ArithmeticModelArena;
+
+class RANSDecoder : public EntropyDecoder
+{
+public:
+
+/* Constructor & Destructor                                  */
+  RANSDecoder();
+  ~RANSDecoder();
+
+/* Manage decoding                                           */
+  BOOL init(ByteStreamIn* instream);
+  void done();
+
+/* Position in the stream of the next byte to be decoded     */
+  I64 tell() const;
+
+/* Save and restore the decoding state including all models  */
+  U32 getStateSize() const;
+  U8* saveState(U8* state) const;
+  const U8* restoreState(const U8* state);
+
+/* Manage an entropy model for a single bit                  */
+  EntropyModel* createBitModel();
+  void initBitModel(EntropyModel* model);
+  void destroyBitModel(EntropyModel* model);
+
+/* Manage an entropy model for n symbols (table optional)    */
+  EntropyModel* createSymbolModel(U32 n);
+  void initSymbolModel(EntropyModel* model, U32* table=0);
+  void destroySymbolModel(EntropyModel* model);
+
+/* Decode a bit with modelling                               */
+  U32 decodeBit(EntropyModel* model);
+
+/* Decode a symbol with modelling                            */
+  U32 decodeSymbol(EntropyModel* model);
+
+/* Decode a bit without modelling                            */
+  U32 readBit();
+
+/* Decode bits without modelling                             */
+  U32 readBits(U32 bits);
+
+/* Decode an unsigned char without modelling                 */
+  U8 readByte();
+
+/* Decode an unsigned short without modelling                */
+  U16 readShort();
+
+/* Decode an unsigned int without modelling                  */
+  U32 readInt();
+
+/* Decode a float without modelling                          */
+  F32 readFloat();
+
+/* Decode an unsigned 64 bit int without modelling           */
+  U64 readInt64();
+
+/* Decode a double without modelling                         */
+  F64 readDouble();
+
+private:
+
+  ByteStreamIn* instream;
+  ArithmeticModelArena* arena;
+
+  // bytes of the stream's window not yet consumed (if it has one)
+  const U8* window_start;
+  const U8* window_curr;
+  const U8* window_end;
+  U32 getByte();
+  U32 getByteRefill();
+  void syncWindow();
+
+  // the two states take turns symbol by symbol
+  void advance(const U32 slot, const U32 start, const U32 freq);
+  U32 renormalize(U32 x);
+  U32 state[2];
+  U32 turn;
+};
+
+#endif
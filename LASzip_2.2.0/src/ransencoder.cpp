@@ -0,0 +1,321 @@
+/*
+===============================================================================
+
+  FILE:  ransencoder.cpp
+
+  CONTENTS:
+
+    see corresponding header file
+
+  PROGRAMMERS:
+
+    agent@local
+
+  COPYRIGHT:
+
+    (c) 2026, agent@local
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the COPYING file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    see header file
+
+===============================================================================
+*/
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+//                                                                           -
+// The byte-wise rANS of Fabian Giesen's "ryg_rans" with the probabilities   -
+// of the adaptive arithmetic coding models (see ransdecoder.cpp). Encoding  -
+// a symbol first writes bytes until the state is small enough and then sets -
+//                                                                           -
+//   state = ((state / freq) << DM__LengthShift) + (state % freq) + start    -
+//                                                                           -
+// Symbol i belongs to state i % 2, which the decoder takes turns with.      -
+//                                                                           -
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+#include "ransencoder.hpp"
+
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+
+#include "arithmeticmodel.hpp"
+
+// the intervals of a chunk of 50000 points take a few hundred KB per layer
+#define RANS_INITIAL_INTERVALS 65536
+// so that done() can count the two bytes every interval may need in a U32
+#define RANS_MAX_INTERVALS (1U << 30)
+
+RANSEncoder::RANSEncoder()
+{
+  outstream = 0;
+  arena = new ArithmeticModelArena();
+  intervals = 0;
+  num_intervals = 0;
+  alloced_intervals = 0;
+  failed = FALSE;
+  outbuffer = 0;
+  alloced_outbuffer = 0;
+  tallied_bits = 0.0;
+  tallied_intervals = 0;
+}
+
+RANSEncoder::~RANSEncoder()
+{
+  if (intervals) free(intervals);
+  if (outbuffer) free(outbuffer);
+  delete arena;
+}
+
+BOOL RANSEncoder::init(ByteStreamOut* outstream)
+{
+  if (outstream == 0) return FALSE;
+  this->outstream = outstream;
+  num_intervals = 0;
+  failed = FALSE;
+  tallied_bits = 0.0;
+  tallied_intervals = 0;
+  return TRUE;
+}
+
+I64 RANSEncoder::tell() const
+{
+  // nothing is written before done() so the position is an estimate
+  return outstream->tell() + (I64)(tellBits() / 8.0);
+}
+
+F64 RANSEncoder::tellBits() const
+{
+  // each interval costs the bits its frequency is short of the full range
+  while (tallied_intervals < num_intervals)
+  {
+    U32 freq = intervals[tallied_intervals++] >> 16;
+    tallied_bits += DM__LengthShift - log((F64)freq) / log(2.0);
+  }
+  // plus the two states that are flushed at the end
+  return 64.0 + tallied_bits;
+}
+
+BOOL RANSEncoder::done()
+{
+  if (failed)
+  {
+    outstream = 0;
+    return FALSE;
+  }
+  // every interval writes at most two bytes
+  U32 needed = 2*num_intervals + 2*sizeof(U32);
+  if (alloced_outbuffer < needed)
+  {
+    if (outbuffer) free(outbuffer);
+    alloced_outbuffer = needed + (needed >> 2);
+    outbuffer = (U8*)malloc(alloced_outbuffer);
+    if (outbuffer == 0)
+    {
+      alloced_outbuffer = 0;
+      outstream = 0;
+      return FALSE;
+    }
+  }
+
+  // encode backwards so that the decoder goes forwards
+  U8* outbyte = outbuffer + alloced_outbuffer;
+  U32 state[2] = { RANS__MinState, RANS__MinState };
+  U32 i = num_intervals;
+  while (i)
+  {
+    i--;
+    U32 start = intervals[i] & 0xFFFF;
+    U32 freq = intervals[i] >> 16;
+    U32 x = state[i & 1];
+    U32 x_max = ((RANS__MinState >> DM__LengthShift) << 8) * freq;
+    while (x >= x_max)
+    {
+      *--outbyte = (U8)(x & 0xFF);
+      x >>= 8;
+    }
+    state[i & 1] = ((x / freq) << DM__LengthShift) + (x % freq) + start;
+  }
+
+  // the decoder reads the first state first (both in little endian)
+  for (U32 s = 2; s > 0; s--)
+  {
+    outbyte -= 4;
+    outbyte[0] = (U8)(state[s-1]);
+    outbyte[1] = (U8)(state[s-1] >> 8);
+    outbyte[2] = (U8)(state[s-1] >> 16);
+    outbyte[3] = (U8)(state[s-1] >> 24);
+  }
+
+  BOOL written = outstream->putBytes(outbyte, (U32)(outbuffer + alloced_outbuffer - outbyte));
+  outstream = 0;
+  return written;
+}
+
+BOOL RANSEncoder::grow()
+{
+  if (failed || (alloced_intervals >= RANS_MAX_INTERVALS))
+  {
+    failed = TRUE;
+    return FALSE;
+  }
+  U32 alloced = (alloced_intervals ? 2*alloced_intervals : RANS_INITIAL_INTERVALS);
+  U32* grown = 0;
+  if ((size_t)alloced <= ((size_t)-1) / sizeof(U32)) grown = (U32*)realloc(intervals, sizeof(U32)*(size_t)alloced);
+  if (grown == 0)
+  {
+    failed = TRUE;
+    return FALSE;
+  }
+  intervals = grown;
+  alloced_intervals = alloced;
+  return TRUE;
+}
+
+inline void RANSEncoder::push(const U32 start, const U32 freq)
+{
+  assert(freq && (start + freq <= DM__MaxCount));
+  // the chunk is lost (and done() fails) once an interval cannot be stored
+  if ((num_intervals == alloced_intervals) && !grow()) return;
+  intervals[num_intervals++] = (freq << 16) | start;
+}
+
+EntropyModel* RANSEncoder::createBitModel()
+{
+  ArithmeticBitModel* m = arena->createBitModel();
+  return (EntropyModel*)m;
+}
+
+void RANSEncoder::initBitModel(EntropyModel* model)
+{
+  ArithmeticBitModel* m = (ArithmeticBitModel*)model;
+  m->init();
+}
+
+void RANSEncoder::destroyBitModel(EntropyModel* model)
+{
+  ArithmeticBitModel* m = (ArithmeticBitModel*)model;
+  arena->destroyBitModel(m);
+}
+
+EntropyModel* RANSEncoder::createSymbolModel(U32 n)
+{
+  ArithmeticModel* m = arena->createSymbolModel(n, true);
+  return (EntropyModel*)m;
+}
+
+void RANSEncoder::initSymbolModel(EntropyModel* model, U32* table)
+{
+  ArithmeticModel* m = (ArithmeticModel*)model;
+  m->init(table);
+}
+
+void RANSEncoder::destroySymbolModel(EntropyModel* model)
+{
+  ArithmeticModel* m = (ArithmeticModel*)model;
+  arena->destroySymbolModel(m);
+}
+
+void RANSEncoder::encodeBit(EntropyModel* model, U32 sym)
+{
+  assert(model && (sym <= 1));
+
+  ArithmeticBitModel* m = (ArithmeticBitModel*)model;
+  U32 x = m->bit_0_prob << (DM__LengthShift - BM__LengthShift);  // scaled p0
+
+  if (sym == 0) {
+    push(0, x);
+    ++m->bit_0_count;
+  }
+  else {
+    push(x, DM__MaxCount - x);
+  }
+
+  if (--m->bits_until_update == 0) m->update();       // periodic model update
+}
+
+void RANSEncoder::encodeSymbol(EntropyModel* model, U32 sym)
+{
+  ArithmeticModel* m = (ArithmeticModel*)model;
+  assert(m && (sym <= m->last_symbol));
+
+  U32 start = m->entries[sym].distribution;
+  U32 end = (sym != m->last_symbol ? m->entries[sym+1].distribution : DM__MaxCount);
+  push(start, end - start);
+
+  ++m->entries[sym].symbol_count;
+  if (--m->symbols_until_update == 0) m->update();    // periodic model update
+}
+
+void RANSEncoder::writeBit(U32 sym)
+{
+  writeBits(1, sym);
+}
+
+void RANSEncoder::writeBits(U32 bits, U32 sym)
+{
+  assert(bits && (bits <= 32));
+
+  if (bits > 16)
+  {
+    writeShort(sym&U16_MAX);
+    sym = sym >> 16;
+    bits = bits - 16;
+    writeBits(bits, sym);
+    return;
+  }
+  else if (bits == 16)
+  {
+    writeShort((U16)sym);
+    return;
+  }
+
+  // equiprobable symbols of 1 << (DM__LengthShift - bits) slots each
+  U32 shift = DM__LengthShift - bits;
+  push(sym << shift, 1 << shift);
+}
+
+void RANSEncoder::writeByte(U8 sym)
+{
+  writeBits(8, sym);
+}
+
+void RANSEncoder::writeShort(U16 sym)
+{
+  writeByte((U8)(sym & 0xFF));
+  writeByte((U8)(sym >> 8));
+}
+
+void RANSEncoder::writeInt(U32 sym)
+{
+  writeShort((U16)(sym & 0xFFFF)); // lower 16 bits
+  writeShort((U16)(sym >> 16));    // UPPER 16 bits
+}
+
+void RANSEncoder::writeFloat(F32 sym) /* danger in float reinterpretation */
+{
+  U32I32F32 u32i32f32;
+  u32i32f32.f32 = sym;
+  writeInt(u32i32f32.u32);
+}
+
+void RANSEncoder::writeInt64(U64 sym)
+{
+  writeInt((U32)(sym & 0xFFFFFFFF)); // lower 32 bits
+  writeInt((U32)(sym >> 32));        // UPPER 32 bits
+}
+
+void RANSEncoder::writeDouble(F64 sym) /* danger in float reinterpretation */
+{
+  U64I64F64 u64i64f64;
+  u64i64f64.f64 = sym;
+  writeInt64(u64i64f64.u64);
+}
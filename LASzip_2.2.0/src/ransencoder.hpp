@@ -0,0 +1,124 @@
+/*
+===============================================================================
+
+  FILE:  ransencoder.hpp
+
+  CONTENTS:
+
+    A range asymmetric numeral system (rANS) encoder with two interleaved
+    states that encodes with the same adaptive models as the arithmetic
+    encoder. rANS decodes in the reverse order of encoding, so the encoder
+    only remembers the interval of every symbol as the models adapt and
+    encodes them all backwards when done() ends the chunk.
+
+  PROGRAMMERS:
+
+    agent@local
+
+  COPYRIGHT:
+
+    (c) 2026, agent@local
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the COPYING file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    17 October 2026 -- created as the second entropy coder of LASzip
+
+===============================================================================
+*/
+#ifndef RANS_ENCODER_H
+#define RANS_ENCODER_H
+
+#include "entropyencoder.hpp"
+
+class ArithmeticModelArena;
+
+class RANSEncoder : public EntropyEncoder
+{
+public:
+
+/* Constructor & Destructor                                  */
+  RANSEncoder();
+  ~RANSEncoder();
+
+/* Manage encoding                                           */
+  BOOL init(ByteStreamOut* outstream);
+  BOOL done();
+
+/* Position in the stream that the encoded bytes reach       */
+  I64 tell() const;
+
+/* Bits the encoding has used since init (with fractions)    */
+  F64 tellBits() const;
+
+/* Manage an entropy model for a single bit                  */
+  EntropyModel* createBitModel();
+  void initBitModel(EntropyModel* model);
+  void destroyBitModel(EntropyModel* model);
+
+/* Manage an entropy model for n symbols (table optional)    */
+  EntropyModel* createSymbolModel(U32 n);
+  void initSymbolModel(EntropyModel* model, U32 *table=0);
+  void destroySymbolModel(EntropyModel* model);
+
+/* Encode a bit with modelling                               */
+  void encodeBit(EntropyModel* model, U32 sym);
+
+/* Encode a symbol with modelling                            */
+  void encodeSymbol(EntropyModel* model, U32 sym);
+
+/* Encode a bit without modelling                            */
+  void writeBit(U32 sym);
+
+/* Encode bits without modelling                             */
+  void writeBits(U32 bits, U32 sym);
+
+/* Encode an unsigned char without modelling                 */
+  void writeByte(U8 sym);
+
+/* Encode an unsigned short without modelling                */
+  void writeShort(U16 sym);
+
+/* Encode an unsigned int without modelling                  */
+  void writeInt(U32 sym);
+
+/* Encode a float without modelling                          */
+  void writeFloat(F32 sym);
+
+/* Encode an unsigned 64 bit int without modelling           */
+  void writeInt64(U64 sym);
+
+/* Encode a double without modelling                         */
+  void writeDouble(F64 sym);
+
+private:
+
+  ByteStreamOut* outstream;
+  ArithmeticModelArena* arena;
+
+  // the start and the frequency of every symbol since init (packed as
+  // freq << 16 | start) that done() encodes in reverse
+  void push(const U32 start, const U32 freq);
+  BOOL grow();
+  U32* intervals;
+  U32 num_intervals;
+  U32 alloced_intervals;
+  // set when an interval could not be stored so that done() fails
+  BOOL failed;
+
+  // the bytes are produced backwards from the end of this buffer
+  U8* outbuffer;
+  U32 alloced_outbuffer;
+
+  // the cost of the intervals tallied so far (for tellBits)
+  mutable F64 tallied_bits;
+  mutable U32 tallied_intervals;
+};
+
+#endif
@@ -0,0 +1,386 @@
+/*
+===============================================================================
+
+  FILE:  lasziptest.cpp
+
+  CONTENTS:
+
+    Regression tests for LASzipper and LASunzipper that run a sequence of
+    calls which once went wrong and check that every point still decodes
+    to what was written. It returns the number of failed tests.
+
+    usage: lasziptest
+
+  PROGRAMMERS:
+
+    agent@local
+
+  COPYRIGHT:
+
+    (c) 2026, agent@local
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the COPYING file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    17 October 2026 -- chunks decoded in lock-step give the same points
+    17 October 2026 -- the chunk index holds the chunk summaries as well
+    17 October 2026 -- batches count every point decoded before a truncated stream ends
+    17 October 2026 -- compressing on threads writes the same bytes as without
+    17 October 2026 -- created for querying chunk summaries while reading ahead
+
+===============================================================================
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include "mydefs.hpp"
+#include "laszip.hpp"
+#include "laszipper.hpp"
+#include "lasunzipper.hpp"
+
+static const char* file_name = "lasziptest.laz";
+
+// points of format 3 with enough variation to need every bit of the coder
+
+static void make_points(std::vector<U8>& points, const U32 n, const U16 point_size)
+{
+  U32 random = 1;
+  points.assign((size_t)n*point_size, 0);
+  for (U32 i = 0; i < n; i++)
+  {
+    U8* point = &points[(size_t)i*point_size];
+    random = random*1103515245u + 12345u;
+    I32 xyz[3] = { (I32)(i*7 + (random >> 8) % 5), (I32)((i/100)*13), (I32)(1000 + (random >> 12) % 50) };
+    memcpy(point, xyz, sizeof(xyz));
+    U16 intensity = (U16)((random >> 16) % 300);
+    memcpy(point + 12, &intensity, 2);
+    point[14] = (U8)(1 | (1 << 3));
+    point[15] = (U8)((random >> 20) % 4 ? 2 : 1);
+    F64 gps_time = 1000.0 + i*0.0001;
+    memcpy(point + 20, &gps_time, 8);
+    U16 rgb[3] = { (U16)random, (U16)random, (U16)(random >> 1) };
+    memcpy(point + 28, rgb, sizeof(rgb));
+  }
+}
+
+static BOOL write_points(const LASzip& zip, const std::vector<U8>& points, const U32 n, const U16 point_size, const U32 chunk_summary)
+{
+  FILE* file = fopen(file_name, "wb");
+  if (file == 0) return FALSE;
+  LASzipper zipper;
+  zipper.set_chunk_summary(chunk_summary);
+  if (!zipper.open(file, &zip))
+  {
+    fclose(file);
+    return FALSE;
+  }
+  std::vector<const U8*> point(zip.num_items);
+  for (U32 i = 0; i < n; i++)
+  {
+    U32 offset = 0;
+    for (U32 j = 0; j < zip.num_items; j++)
+    {
+      point[j] = &points[(size_t)i*point_size + offset];
+      offset += zip.items[j].size;
+    }
+    zipper.write(&point[0]);
+  }
+  BOOL closed = zipper.close();
+  fclose(file);
+  return closed;
+}
+
+// the chunk summaries used to be read on the first query, which seeked the
+// read-ahead stream away from under the decoder in the middle of a chunk
+
+static BOOL test_query_summaries_while_reading_ahead()
+{
+  const U32 n = 20000;
+  const U16 point_size = 34;
+  BOOL passed = TRUE;
+  LASzip zip;
+  zip.setup(3, point_size, LASZIP_COMPRESSOR_CHUNKED);
+  zip.set_chunk_size(500);
+  std::vector<U8> points, decoded;
+  make_points(points, n, point_size);
+  if (!write_points(zip, points, n, point_size, LASZIP_CHUNK_SUMMARY_XYZ_BOUNDS | LASZIP_CHUNK_SUMMARY_CLASSIFICATIONS | LASZIP_CHUNK_SUMMARY_GPS_TIME)) return FALSE;
+
+  for (U32 query = 0; query < 3; query++)
+  {
+    decoded.assign(points.size(), 0);
+    FILE* file = fopen(file_name, "rb");
+    if (file == 0) return FALSE;
+    LASunzipper unzipper;
+    unzipper.set_read_ahead(2, 4096);
+    if (!unzipper.open(file, &zip))
+    {
+      fclose(file);
+      return FALSE;
+    }
+    U32 count = unzipper.read_batch(&decoded[0], 1000, point_size);
+    std::vector<U32> chunks(unzipper.get_number_chunks());
+    I32 min_xyz[3] = { 0, 0, 0 };
+    I32 max_xyz[3] = { 100000, 100000, 100000 };
+    U32 found = 0;
+    if (query == 0) found = unzipper.get_chunks_in_box(min_xyz, max_xyz, false, &chunks[0]);
+    else if (query == 1) found = unzipper.get_chunks_with_classification(2, &chunks[0]);
+    else found = unzipper.get_chunks_in_gps_time(1000.0, 1000.5, &chunks[0]);
+    count += unzipper.read_batch(&decoded[(size_t)count*point_size], n - count, point_size);
+    unzipper.close();
+    fclose(file);
+    if (found == 0 || count != n || memcmp(&decoded[0], &points[0], points.size()))
+    {
+      fprintf(stderr, "  query %u found %u chunks and decoded %u points %s\n", query, found, count, (count == n ? "wrongly" : ""));
+      passed = FALSE;
+    }
+  }
+  return passed;
+}
+
+// compresses into memory with variable chunks that end every 3001 points
+// (where an empty chunk follows right away) on the given number of threads
+
+static BOOL compress_points(const LASzip& zip, const std::vector<U8>& points, const U32 n, const U16 point_size, const U32 threads, std::vector<U8>& bytes)
+{
+  LASzipper zipper;
+  zipper.set_threads(threads);
+  if (!zipper.open(&zip)) return FALSE;
+  std::vector<const U8*> point(zip.num_items);
+  for (U32 i = 0; i < n; i++)
+  {
+    U32 offset = 0;
+    for (U32 j = 0; j < zip.num_items; j++)
+    {
+      point[j] = &points[(size_t)i*point_size + offset];
+      offset += zip.items[j].size;
+    }
+    zipper.write(&point[0]);
+    if ((i % 3001) == 3000)
+    {
+      zipper.chunk();
+      zipper.chunk();
+    }
+  }
+  if (!zipper.close()) return FALSE;
+  U8* data;
+  I64 size;
+  if (!zipper.get_data(&data, &size)) return FALSE;
+  bytes.assign(data, data + size);
+  return TRUE;
+}
+
+// the pool of compressing threads used to skip empty chunks that the serial
+// writer put into the chunk table
+
+static BOOL test_threads_write_same_bytes()
+{
+  const U32 n = 20000;
+  const U16 point_size = 34;
+  const U16 compressors[2] = { LASZIP_COMPRESSOR_CHUNKED, LASZIP_COMPRESSOR_LAYERED_CHUNKED };
+  BOOL passed = TRUE;
+  std::vector<U8> points, serial, threaded;
+  make_points(points, n, point_size);
+
+  for (U32 c = 0; c < 2; c++)
+  {
+    LASzip zip;
+    zip.setup(3, point_size, compressors[c]);
+    zip.set_chunk_size(0);
+    if (!compress_points(zip, points, n, point_size, 1, serial) || !compress_points(zip, points, n, point_size, 4, threaded)) return FALSE;
+    if (serial != threaded)
+    {
+      fprintf(stderr, "  compressor %u wrote %u bytes on one thread and %u on four\n", compressors[c], (U32)serial.size(), (U32)threaded.size());
+      passed = FALSE;
+    }
+  }
+  return passed;
+}
+
+// the fused reader used to lose the points it had decoded in the run of a
+// batch during which the stream ended
+
+static BOOL test_batch_counts_points_before_truncation()
+{
+  const U32 n = 20000;
+  const U16 point_size = 34;
+  LASzip zip;
+  zip.setup(3, point_size, LASZIP_COMPRESSOR_CHUNKED);
+  zip.set_chunk_size(5000);
+  std::vector<U8> points, decoded;
+  make_points(points, n, point_size);
+  if (!write_points(zip, points, n, point_size, 0)) return FALSE;
+
+  FILE* file = fopen(file_name, "rb");
+  if (file == 0) return FALSE;
+  fseek(file, 0, SEEK_END);
+  std::vector<U8> bytes((size_t)ftell(file));
+  fseek(file, 0, SEEK_SET);
+  size_t size = fread(&bytes[0], 1, bytes.size(), file);
+  fclose(file);
+  if (size != bytes.size()) return FALSE;
+
+  // the file ends in the middle of the third chunk
+  file = fopen(file_name, "wb");
+  if (file == 0) return FALSE;
+  size = fwrite(&bytes[0], 1, bytes.size()*5/8, file);
+  fclose(file);
+  if (size != bytes.size()*5/8) return FALSE;
+  file = fopen(file_name, "rb");
+  if (file == 0) return FALSE;
+  LASunzipper unzipper;
+  if (!unzipper.open(file, &zip))
+  {
+    fclose(file);
+    return FALSE;
+  }
+  decoded.assign(points.size(), 0);
+  U32 count = unzipper.read_batch(&decoded[0], n, point_size);
+  unzipper.close();
+  fclose(file);
+  if (count <= 10001 || count >= 15000 || memcmp(&decoded[0], &points[0], (size_t)count*point_size))
+  {
+    fprintf(stderr, "  decoded %u points of the truncated stream\n", count);
+    return FALSE;
+  }
+  return TRUE;
+}
+
+// the chunk summaries used to be read from the end of the LAZ file even when
+// the chunk index was used, which the index now spares by holding them too
+
+static BOOL test_chunk_index_holds_summaries()
+{
+  const U32 n = 20000;
+  const U16 point_size = 34;
+  BOOL passed = TRUE;
+  LASzip zip;
+  zip.setup(3, point_size, LASZIP_COMPRESSOR_CHUNKED);
+  zip.set_chunk_size(500);
+  std::vector<U8> points;
+  make_points(points, n, point_size);
+  if (!write_points(zip, points, n, point_size, LASZIP_CHUNK_SUMMARY_XYZ_BOUNDS | LASZIP_CHUNK_SUMMARY_GPS_TIME)) return FALSE;
+  char index_name[64];
+  sprintf(index_name, "%s.lzi", file_name);
+  remove(index_name);
+
+  // the first open writes the index and the second one reads it
+  std::vector<U32> found[2];
+  for (U32 open = 0; open < 2; open++)
+  {
+    FILE* file = fopen(file_name, "rb");
+    if (file == 0) return FALSE;
+    LASunzipper unzipper;
+    unzipper.set_chunk_index(file_name);
+    if (!unzipper.open(file, &zip))
+    {
+      fclose(file);
+      return FALSE;
+    }
+    found[open].assign(unzipper.get_number_chunks(), 0);
+    I32 min_xyz[3] = { 0, 0, 0 };
+    I32 max_xyz[3] = { 50000, 100000, 100000 };
+    found[open].resize(unzipper.get_chunks_in_box(min_xyz, max_xyz, false, &found[open][0]));
+    double min_gps_time, max_gps_time;
+    if (!unzipper.get_chunk_gps_time(1, &min_gps_time, &max_gps_time) || (min_gps_time != 1000.0 + 500*0.0001))
+    {
+      fprintf(stderr, "  open %u has no gps time summary\n", open);
+      passed = FALSE;
+    }
+    unzipper.close();
+    fclose(file);
+  }
+  remove(index_name);
+  if (found[0].empty() || (found[0].size() >= n/500) || (found[0] != found[1]))
+  {
+    fprintf(stderr, "  found %u chunks in the box with the file and %u with the index\n", (U32)found[0].size(), (U32)found[1].size());
+    passed = FALSE;
+  }
+  return passed;
+}
+
+// chunks decoded side by side must give the same points as one after the
+// other, also for batches that start in the middle of a chunk after a seek
+
+static BOOL test_interleaved_chunks()
+{
+  const U32 n = 20000;
+  const U16 point_size = 34;
+  BOOL passed = TRUE;
+  LASzip zip;
+  zip.setup(3, point_size, LASZIP_COMPRESSOR_CHUNKED);
+  zip.set_chunk_size(500);
+  std::vector<U8> points, decoded;
+  make_points(points, n, point_size);
+  if (!write_points(zip, points, n, point_size, 0)) return FALSE;
+
+  for (U32 interleave = 2; interleave <= LASZIP_INTERLEAVE_CHUNKS_MAX; interleave++)
+  {
+    decoded.assign(points.size(), 0);
+    FILE* file = fopen(file_name, "rb");
+    if (file == 0) return FALSE;
+    LASunzipper unzipper;
+    unzipper.set_interleave(interleave);
+    if (!unzipper.open(file, &zip))
+    {
+      fclose(file);
+      return FALSE;
+    }
+    U32 count = 0;
+    while (count < n)
+    {
+      U32 read = unzipper.read_batch(&decoded[(size_t)count*point_size], (n - count < 3001 ? n - count : 3001), point_size);
+      if (read == 0) break;
+      count += read;
+    }
+    BOOL same = (count == n) && (memcmp(&decoded[0], &points[0], points.size()) == 0);
+    U32 sought = 0;
+    if (unzipper.seek(1234)) sought = unzipper.read_batch(&decoded[0], 5000, point_size);
+    if (sought != 5000 || memcmp(&decoded[0], &points[(size_t)1234*point_size], (size_t)5000*point_size)) same = FALSE;
+    unzipper.close();
+    fclose(file);
+    if (!same)
+    {
+      fprintf(stderr, "  %u chunks side by side decoded %u points %s\n", interleave, count, (count == n ? "wrongly" : ""));
+      passed = FALSE;
+    }
+  }
+  return passed;
+}
+
+struct Test
+{
+  const char* name;
+  BOOL (*run)();
+};
+
+static const Test tests[] =
+{
+  { "query chunk summaries while reading ahead", test_query_summaries_while_reading_ahead },
+  { "compress on threads into the same bytes", test_threads_write_same_bytes },
+  { "count batch points before a truncated stream ends", test_batch_counts_points_before_truncation },
+  { "read chunk summaries from the chunk index", test_chunk_index_holds_summaries },
+  { "decode chunks in lock-step", test_interleaved_chunks },
+};
+
+int main()
+{
+  int failed = 0;
+  for (U32 t = 0; t < sizeof(tests)/sizeof(Test); t++)
+  {
+    BOOL passed = tests[t].run();
+    fprintf(stderr, "%s: %s\n", (passed ? "passed" : "FAILED"), tests[t].name);
+    if (!passed) failed++;
+  }
+  remove(file_name);
+  return failed;
+}
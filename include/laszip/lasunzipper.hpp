@@ -24,6 +24,14 @@
   
   CHANGE HISTORY:
   
+    17 October 2026 -- read_batch() can decode several chunks in lock-step
+    17 October 2026 -- per item counters of cycles, points and bytes (LASZIP_INSTRUMENT)
+    17 October 2026 -- optional read-ahead on an I/O thread for FILE* input
+    17 October 2026 -- finds the chunks with a classification or gps time from their summaries
+    17 October 2026 -- finds the chunks that intersect a box from their bounds
+    17 October 2026 -- optional chunk index file next to the LAZ file
+    17 October 2026 -- seeks within a chunk can resume from checkpoints
+    17 October 2026 -- decompress only some layers of layered compressed data
     23 April 2011 -- changed interface for easier future compressor support
     10 January 2011 -- licensing change for LGPL release and liblas integration
     12 December 2010 -- created from LASwriter/LASreader after Howard got pushy (-;
@@ -53,12 +61,57 @@ class LASZIP_DLL LASunzipper
 public:
   bool open(FILE* file, const LASzip* laszip);
   bool open(istream& stream, const LASzip* laszip);
+  // read in place from memory (e.g. a mapped file) starting at position
+  bool open(const unsigned char* data, const SIGNED_INT64 size, const SIGNED_INT64 position, const LASzip* laszip);
+  // which LASZIP_DECOMPRESS_SELECTIVE_* layers to decompress (call before open)
+  bool set_decompress_selective(const unsigned int decompress_selective);
+  // remember the decoding state every interval points while seeking within
+  // a chunk so that later seeks into that chunk are faster (0 = off)
+  bool set_checkpoint_interval(const unsigned int interval);
+  // the chunk table and the chunk summaries of the LAZ file with this name are
+  // kept in a chunk index file next to it (file_name with ".lzi" appended) that
+  // is written on the first open and used instead of them afterwards (call
+  // before open)
+  bool set_chunk_index(const char* file_name);
+  // read a FILE* ahead on its own thread into num_buffers buffers of
+  // buffer_size bytes so that reading overlaps decoding (0 = off, call before open)
+  bool set_read_ahead(const unsigned int num_buffers, const unsigned int buffer_size=1048576);
+  // let read_batch() decode up to num_chunks (2 to LASZIP_INTERLEAVE_CHUNKS_MAX)
+  // whole chunks of point types 0 to 3 side by side on this thread so that
+  // their decoding overlaps (0 = off, call before open)
+  bool set_interleave(const unsigned int num_chunks);
  
   unsigned int tell() const;
   bool seek(const unsigned int position);
   bool read(unsigned char * const * point);
+  // decodes up to count points stride bytes apart into dest and returns how many
+  unsigned int read_batch(unsigned char* dest, const unsigned int count, const unsigned int stride);
   bool close();
 
+  // chunk table for decoding chunks independently (zero chunks if not available)
+  unsigned int get_number_chunks() const;
+  bool get_chunk(const unsigned int chunk, unsigned int* first_point, unsigned int* num_points) const;
+  // quantized bounds of a chunk (if the file has LASZIP_CHUNK_SUMMARY_XYZ_BOUNDS)
+  bool get_chunk_bounds(const unsigned int chunk, int* min_xyz, int* max_xyz) const;
+  // stores the chunks that may have points inside the quantized box (in x and
+  // y only unless use_z) into chunks (room for get_number_chunks()) and
+  // returns how many there are (all of them without chunk bounds)
+  unsigned int get_chunks_in_box(const int* min_xyz, const int* max_xyz, const bool use_z, unsigned int* chunks) const;
+  // statistics of a chunk (if the file has the LASZIP_CHUNK_SUMMARY_* for them)
+  // with the histograms as LASZIP_CHUNK_SUMMARY_NUM_* counts
+  bool get_chunk_classifications(const unsigned int chunk, unsigned int* counts) const;
+  bool get_chunk_return_numbers(const unsigned int chunk, unsigned int* counts) const;
+  bool get_chunk_gps_time(const unsigned int chunk, double* min_gps_time, double* max_gps_time) const;
+  bool get_chunk_intensity(const unsigned int chunk, unsigned short* min_intensity, unsigned short* max_intensity) const;
+  // like get_chunks_in_box() for chunks that have points of this classification
+  // or whose gps times overlap the window
+  unsigned int get_chunks_with_classification(const unsigned char classification, unsigned int* chunks) const;
+  unsigned int get_chunks_in_gps_time(const double min_gps_time, const double max_gps_time, unsigned int* chunks) const;
+
+  // the processor cycles, points and compressed bytes that decoding the item
+  // has cost since open (fails unless LASzip was built with LASZIP_INSTRUMENT)
+  bool get_item_counters(const unsigned int item, SIGNED_INT64* cycles, SIGNED_INT64* points, SIGNED_INT64* bytes) const;
+
   LASunzipper();
   ~LASunzipper();
 
@@ -67,8 +120,16 @@ public:
 
 private:
   unsigned int count;
+  unsigned int decompress_selective;
+  unsigned int checkpoint_interval;
+  unsigned int read_ahead_buffers;
+  unsigned int read_ahead_buffer_size;
+  unsigned int interleave;
   ByteStreamIn* stream;
   LASreadPoint* reader;
+  char* chunk_index;
+  bool read_chunk_index();
+  void write_chunk_index();
   bool return_error(const char* err);
   char* error_string;
 };
@@ -62,16 +62,56 @@ typedef long long SIGNED_INT64;
 #define LASZIP_COMPRESSOR_POINTWISE_CHUNKED 2
 #define LASZIP_COMPRESSOR_TOTAL_NUMBER_OF   3
 
+// the layered compressor of this library has a private id so that it does
+// not collide with the layered compressor of the official LASzip 1.4
+#define LASZIP_COMPRESSOR_LAYERED_CHUNKED   0x8003
+
 #define LASZIP_COMPRESSOR_CHUNKED LASZIP_COMPRESSOR_POINTWISE_CHUNKED
 #define LASZIP_COMPRESSOR_NOT_CHUNKED LASZIP_COMPRESSOR_POINTWISE
 
 #define LASZIP_COMPRESSOR_DEFAULT LASZIP_COMPRESSOR_CHUNKED
 
 #define LASZIP_CODER_ARITHMETIC             0
-#define LASZIP_CODER_TOTAL_NUMBER_OF        1
+// the rANS coder uses the same models but decodes faster than the arithmetic
+// coder for files that are a few percent larger (and unknown to older readers)
+#define LASZIP_CODER_RANS                   1
+#define LASZIP_CODER_TOTAL_NUMBER_OF        2
 
 #define LASZIP_CHUNK_SIZE_DEFAULT           50000
 
+// POINT14 and RGBNIR14 items are compressed by a codec of this library with
+// a private item version so that official LASzip readers (which have codecs
+// of their own for these items) reject such files instead of misreading them
+#define LASZIP_ITEM14_VERSION               0x8002
+
+// the most chunks that a reader decodes side by side on one thread (see
+// LASunzipper::set_interleave)
+#define LASZIP_INTERLEAVE_CHUNKS_MAX        4
+
+// with the layered compressor each group of fields is stored in its own
+// layer and readers can skip the layers of the fields they do not need
+#define LASZIP_DECOMPRESS_SELECTIVE_ALL          0xFFFFFFFF
+#define LASZIP_DECOMPRESS_SELECTIVE_XYZ          0x00000000 /* always with returns */
+#define LASZIP_DECOMPRESS_SELECTIVE_ATTRIBUTES   0x00000001 /* intensity, classification, ... */
+#define LASZIP_DECOMPRESS_SELECTIVE_GPS_TIME     0x00000002
+#define LASZIP_DECOMPRESS_SELECTIVE_RGB          0x00000004 /* and NIR */
+#define LASZIP_DECOMPRESS_SELECTIVE_WAVEPACKET   0x00000008
+#define LASZIP_DECOMPRESS_SELECTIVE_EXTRA_BYTES  0x00000010
+
+// chunked compressors can store a summary of every chunk with which readers
+// find the chunks they need without decompressing the others (the histograms
+// count the points of each classification and of each return number)
+#define LASZIP_CHUNK_SUMMARY_NONE                0x00000000
+#define LASZIP_CHUNK_SUMMARY_XYZ_BOUNDS          0x00000001 /* quantized */
+#define LASZIP_CHUNK_SUMMARY_CLASSIFICATIONS     0x00000002 /* histogram */
+#define LASZIP_CHUNK_SUMMARY_RETURN_NUMBERS      0x00000004 /* histogram */
+#define LASZIP_CHUNK_SUMMARY_GPS_TIME            0x00000008 /* min and max */
+#define LASZIP_CHUNK_SUMMARY_INTENSITY           0x00000010 /* min and max */
+#define LASZIP_CHUNK_SUMMARY_ALL                 0x0000001F
+
+#define LASZIP_CHUNK_SUMMARY_NUM_CLASSIFICATIONS 256
+#define LASZIP_CHUNK_SUMMARY_NUM_RETURN_NUMBERS  16
+
 #include "laszipexport.hpp"
 
 class LASZIP_DLL LASitem
@@ -91,6 +131,7 @@ public:
   // supported version control
   bool check_compressor(const unsigned short compressor);
   bool check_coder(const unsigned short coder);
+  bool check_coder(const unsigned short coder, const unsigned short compressor);
   bool check_item(const LASitem* item);
   bool check_items(const unsigned short num_items, const LASitem* items);
   bool check();
@@ -106,8 +147,8 @@ public:
   bool pack(unsigned char*& bytes, int& num);
 
   // setup
-  bool setup(const unsigned char point_type, const unsigned short point_size, const unsigned short compressor=LASZIP_COMPRESSOR_DEFAULT);
-  bool setup(const unsigned short num_items, const LASitem* items, const unsigned short compressor);
+  bool setup(const unsigned char point_type, const unsigned short point_size, const unsigned short compressor=LASZIP_COMPRESSOR_DEFAULT, const unsigned short coder=LASZIP_CODER_ARITHMETIC);
+  bool setup(const unsigned short num_items, const LASitem* items, const unsigned short compressor, const unsigned short coder=LASZIP_CODER_ARITHMETIC);
   bool set_chunk_size(const unsigned int chunk_size);             /* for compressor only */
   bool request_version(const unsigned short requested_version);   /* for compressor only */
 
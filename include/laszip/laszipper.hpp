@@ -24,6 +24,9 @@
   
   CHANGE HISTORY:
   
+    17 October 2026 -- compresses into memory and writes each chunk at once
+    17 October 2026 -- optional statistics of what every item and field costs
+    17 October 2026 -- optionally summarizes every chunk for readers
     8 May 2011 -- added an option for variable chunking via chunk()
     23 April 2011 -- changed interface for simplicity and chunking support
     10 January 2011 -- licensing change for LGPL release and liblas integration
@@ -47,6 +50,7 @@ using namespace std;
 #endif
 
 class ByteStreamOut;
+class ByteStreamOutArray;
 class LASwritePoint;
 
 class LASZIP_DLL LASzipper
@@ -54,11 +58,35 @@ class LASZIP_DLL LASzipper
 public:
   bool open(FILE* outfile, const LASzip* laszip);
   bool open(ostream& outstream, const LASzip* laszip);
+  // compresses into memory that grows as needed and leaves the first offset
+  // bytes for the header and the VLRs that the caller copies there later
+  bool open(const LASzip* laszip, const unsigned int offset=0);
+  // the memory that open() without a file compressed into (complete after
+  // close and valid until the next open or the destruction of the zipper)
+  bool get_data(unsigned char** data, SIGNED_INT64* size);
+
+  // compress chunks on this many threads (call before open, chunked only)
+  bool set_threads(const unsigned int num_threads);
+  // store LASZIP_CHUNK_SUMMARY_* of every chunk (call before open, chunked only,
+  // and LASZIP_CHUNK_SUMMARY_GPS_TIME needs POINT14 or a GPSTIME11 item)
+  bool set_chunk_summary(const unsigned int contents);
+  // keep statistics of the bits that every item and every context of the
+  // integer compressors of its fields cost (call before open, not with threads)
+  bool set_statistics(const bool statistics);
 
   bool write(const unsigned char* const * point);
   bool chunk();
   bool close();
 
+  // the statistics of what was written so far (call before close): the points
+  // of an item and its bits, the name and the number of contexts of one of its
+  // compressed fields, and for each context the number of values, their bits,
+  // the entropy of their correctors in bits per value and how often each k
+  // occurred (k_counts has room for the 33 counts of k = 0 ... 32)
+  bool get_item_statistics(const unsigned int item, SIGNED_INT64* points, double* bits);
+  bool get_field_statistics(const unsigned int item, const unsigned int field, const char** name, unsigned int* contexts);
+  bool get_context_statistics(const unsigned int item, const unsigned int field, const unsigned int context, SIGNED_INT64* number, double* bits, double* entropy, SIGNED_INT64* k_counts);
+
   LASzipper();
   ~LASzipper();
 
@@ -67,7 +95,11 @@ public:
 
 private:
   unsigned int count;
+  unsigned int num_threads;
+  unsigned int chunk_summary;
+  bool statistics;
   ByteStreamOut* stream;
+  ByteStreamOutArray* memory;
   LASwritePoint* writer;
   bool return_error(const char* err);
   char* error_string;